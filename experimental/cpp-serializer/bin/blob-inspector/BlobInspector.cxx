@@ -1,73 +1,471 @@
 #include "BlobInspector.h"
 #include "CordaBytes.h"
+#include "Metrics.h"
 
+#include <chrono>
 #include <iostream>
 #include <sstream>
+#include <type_traits>
 
 #include "proton/codec.h"
 #include "proton/proton_wrapper.h"
 
 #include "amqp/schema/descriptors/AMQPDescriptorRegistory.h"
 
+#include "amqp/AMQPHeader.h"
 #include "amqp/CompositeFactory.h"
+#include "amqp/dom/DocumentBuilder.h"
+#include "amqp/filter/FilterVisitor.h"
+#include "amqp/parallel/ParallelReader.h"
+#include "amqp/scan/Tape.h"
+#include "amqp/trace/Trace.h"
 #include "amqp/schema/described-types/Envelope.h"
 
 /******************************************************************************/
 
-BlobInspector::BlobInspector (CordaBytes & cb_)
-    : m_data { pn_data (cb_.size()) }
-{
-    // returns how many bytes we processed which right now we don't care
-    // about but I assume there is a case where it doesn't process the
-    // entire file
-    auto rtn = pn_data_decode (m_data, cb_.bytes(), cb_.size());
-    assert (rtn == cb_.size());
+namespace {
+
+    std::unique_ptr<amqp::internal::schema::Envelope>
+    envelope (pn_data_t * data_) {
+        amqp::internal::trace::Span span ("Envelope::build");
+
+        std::unique_ptr<amqp::internal::schema::Envelope> envelope;
+
+        if (pn_data_is_described (data_)) {
+            proton::auto_enter p (data_);
+
+            auto a = pn_data_get_ulong(data_);
+
+            auto described = amqp::internal::descriptorFor (a)->build (data_);
+
+            envelope.reset (
+                    dynamic_cast<amqp::internal::schema::Envelope *> (described.get()));
+
+            if (envelope) {
+                described.release();
+            }
+        }
+
+        return envelope;
+    }
+
+    /**
+     * Times the reading of one blob into the installed [Metrics], if
+     * there are any, only looking at the clock when someone's going to
+     * see the result
+     */
+    class Timing {
+        private :
+            using clock = std::chrono::steady_clock;
+
+            Metrics::Handle m_metrics;
+
+            clock::time_point m_start;
+            clock::time_point m_object;
+
+        public :
+            Timing()
+                : m_start (m_metrics ? clock::now() : clock::time_point { })
+            { }
+
+            /**
+             * The schema's been dealt with and the object's about to be read
+             */
+            void object() {
+                if (m_metrics) {
+                    m_object = clock::now();
+                }
+            }
+
+            void record (const std::string & type_, size_t bytes_) {
+                if (!m_metrics) {
+                    return;
+                }
+
+                auto end = clock::now();
+
+                auto ns = [](auto from_, auto to_) {
+                    return static_cast<uint64_t> (
+                        std::chrono::duration_cast<std::chrono::nanoseconds> (
+                            to_ - from_).count());
+                };
+
+                m_metrics->record (
+                    type_,
+                    bytes_,
+                    { ns (m_start, m_object), ns (m_object, end), ns (m_start, end) });
+            }
+
+            void error() {
+                if (m_metrics) {
+                    m_metrics->error();
+                }
+            }
+    };
+
+    /**
+     * Pull the envelope out of the blob, build the readers for its
+     * schema and then hand [f_] the reader for the top level object,
+     * the schema, and the descriptor of the object with the proton tree
+     * positioned at the start of that object. The readers are built using
+     * up to [threads_] threads and, given a [local_] schema, read the
+     * object as the versions of its types in that.
+     */
+    template<class F>
+    void
+    withReader (
+        pn_data_t * data_,
+        F f_,
+        size_t threads_ = 1,
+        const LocalSchema * local_ = nullptr
+    ) {
+        auto envelope = ::envelope (data_);
+
+        if (!envelope) {
+            throw std::runtime_error ("Blob does not hold an envelope");
+        }
+
+        amqp::internal::CompositeFactory cf (
+            threads_, local_ ? &local_->schema() : nullptr);
+
+        cf.process (envelope->schema(), envelope->descriptor());
+
+        auto reader = cf.byDescriptor (envelope->descriptor());
+
+        if (!reader) {
+            std::stringstream ss;
+            ss << "No reader for the object's descriptor " << envelope->descriptor();
+            throw std::runtime_error (ss.str());
+        }
+
+        {
+            // move to the actual blob entry in the tree - ideally we'd have
+            // saved this on the Envelope but that's not easily doable as we
+            // can't grab an actual copy of our data pointer
+            proton::auto_enter p (data_);
+            pn_data_next (data_);
+            proton::is_list (data_);
+
+            if (pn_data_get_list (data_) != 3) {
+                throw std::runtime_error ("Envelope is not a list of three");
+            }
+
+            {
+                proton::auto_enter p (data_);
+
+                f_ (*reader, envelope->schema(), envelope->descriptor());
+            }
+        }
+    }
+
+}
+
+/******************************************************************************
+ *
+ * LocalSchema
+ *
+ ******************************************************************************/
+
+LocalSchema::LocalSchema (const CordaBytes & cb_) {
+    pn_data_t * data = pn_data (cb_.size());
+
+    auto rtn = pn_data_decode (data, cb_.bytes(), cb_.size());
+
+    try {
+        if (rtn < 0 || static_cast<size_t> (rtn) != cb_.size()) {
+            throw std::runtime_error ("Failed to decode the local schema blob");
+        }
+
+        m_envelope = ::envelope (data);
+    } catch (...) {
+        pn_data_free (data);
+        throw;
+    }
+
+    pn_data_free (data);
+
+    if (!m_envelope) {
+        throw std::runtime_error ("No envelope in the local schema blob");
+    }
 }
 
 /******************************************************************************/
 
-std::string
-BlobInspector::dump() {
-    std::unique_ptr<amqp::internal::schema::Envelope> envelope;
+LocalSchema::~LocalSchema() = default;
+
+/******************************************************************************/
+
+const amqp::internal::schema::Schema &
+LocalSchema::schema() const {
+    return dynamic_cast<const amqp::internal::schema::Schema &> (
+        m_envelope->schema());
+}
 
-    if (pn_data_is_described (m_data)) {
-        proton::auto_enter p (m_data);
+/******************************************************************************
+ *
+ * BlobInspector
+ *
+ ******************************************************************************/
 
-        auto a = pn_data_get_ulong(m_data);
+BlobInspector::BlobInspector (
+    const CordaBytes & cb_,
+    Decoder decoder_,
+    const LocalSchema * local_
+) : m_bytes (cb_)
+  , m_decoder (decoder_)
+  , m_local (local_)
+  , m_data { nullptr }
+{ }
 
-        envelope.reset (
-                dynamic_cast<amqp::internal::schema::Envelope *> (
-                        amqp::internal::AMQPDescriptorRegistory[a]->build(m_data).release()));
+/******************************************************************************/
+
+BlobInspector::~BlobInspector() {
+    if (m_data) {
+        pn_data_free (m_data);
     }
+}
 
-    amqp::internal::CompositeFactory cf;
+/******************************************************************************/
 
-    cf.process (envelope->schema());
+pn_data_t *
+BlobInspector::data() {
+    if (m_data) {
+        return m_data;
+    }
 
-    auto reader = cf.byDescriptor (envelope->descriptor());
-    assert (reader);
+    const char * bytes = m_bytes.bytes();
+    size_t size = m_bytes.size();
+
+    if (m_decoder == tape_d) {
+        amqp::internal::trace::Span span ("scan::Tape");
+
+        auto [envelope, object] = amqp::internal::parallel::splitEnvelope (
+                bytes, size);
+
+        m_tape = std::make_unique<amqp::internal::scan::Tape> (
+                object.data(), object.size());
+
+        m_skeleton = std::move (envelope);
+        bytes = m_skeleton.data();
+        size = m_skeleton.size();
+    }
+
+    auto data = pn_data (size);
+
+    ssize_t rtn;
 
     {
-        // move to the actual blob entry in the tree - ideally we'd have
-        // saved this on the Envelope but that's not easily doable as we
-        // can't grab an actual copy of our data pointer
-        proton::auto_enter p (m_data);
-        pn_data_next (m_data);
-        proton::is_list (m_data);
-        assert (pn_data_get_list (m_data) == 3);
+        amqp::internal::trace::Span span ("pn_data_decode");
+
+        rtn = pn_data_decode (data, bytes, size);
+    }
+
+    // Anything short of the whole blob is either truncated or not AMQP
+    if (rtn < 0 || static_cast<size_t> (rtn) != size) {
+        pn_data_free (data);
+
+        std::stringstream ss;
+        ss << "Failed to decode the blob, " << rtn << " of " << size << " bytes read";
+        throw std::runtime_error (ss.str());
+    }
+
+    m_data = data;
+
+    return m_data;
+}
+
+/******************************************************************************/
+
+/**
+ * As the blob was on disk, header and all
+ */
+size_t
+BlobInspector::bytes() const {
+    return m_bytes.size() + amqp::AMQP_HEADER.size() + 1;
+}
+
+/******************************************************************************/
+
+/**
+ * Hand [f_] the reader for the object, the schema, the object's descriptor
+ * and where to read the object from, which is either the proton tree or
+ * the root of the tape
+ */
+template<class F>
+void
+BlobInspector::read (F f_) {
+    amqp::internal::trace::Span span ("BlobInspector::read");
+
+    Timing timing;
+
+    try {
+        withReader (data(), [this, &f_, &timing](
+                auto & reader_, auto & schema_, auto & descriptor_)
         {
-            proton::auto_enter p (m_data);
+            // Only our own readers know how to read from a tape
+            const auto & reader = dynamic_cast<
+                const amqp::internal::reader::Reader &> (reader_);
 
-            std::stringstream ss;
+            timing.object();
+
+            if (m_tape) {
+                f_ (reader, schema_, descriptor_, m_tape->root());
+            } else {
+                f_ (reader, schema_, descriptor_, m_data);
+            }
+
+            timing.record (reader.type(), bytes());
+        }, 1, m_local);
+    } catch (...) {
+        timing.error();
+        throw;
+    }
+}
+
+/******************************************************************************/
+
+std::string
+BlobInspector::dump() {
+    std::string rtn;
+
+    read ([&rtn](auto & reader_, auto & schema_, auto &, const auto & source_) {
+        // We wrap our output like this to make sure it's valid JSON to
+        // facilitate easy pretty printing
+        reader_.dump ("{ Parsed", source_, schema_)->dumpTo (rtn);
+        rtn += " }";
+    });
+
+    return rtn;
+}
+
+/******************************************************************************/
+
+/**
+ * Rather than decode the whole blob we build the readers from a copy of
+ * the envelope without the object in it and hand the object's bytes to
+ * a [ParallelReader]
+ */
+std::string
+BlobInspector::dump (size_t threads_, size_t minElements_) {
+    if (threads_ < 2) {
+        return dump();
+    }
+
+    std::string rtn;
+
+    // An object being read as another version of itself has to be read
+    // as a whole
+    bool evolved { false };
+
+    {
+        amqp::internal::trace::Span span ("BlobInspector::read");
+
+        Timing timing;
+        pn_data_t * skeleton { nullptr };
+
+        try {
+            auto [envelope, object] = amqp::internal::parallel::splitEnvelope (
+                    m_bytes.bytes(), m_bytes.size());
 
-            // We wrap our output like this to make sure it's valid JSON to
-            // facilitate easy pretty printing
-            ss << reader->dump ("{ Parsed", m_data, envelope->schema())->dump()
-               << " }";
+            skeleton = pn_data (envelope.size());
 
-            return ss.str();
+            ssize_t decoded;
+
+            {
+                amqp::internal::trace::Span decode ("pn_data_decode");
+
+                decoded = pn_data_decode (skeleton, envelope.data(), envelope.size());
+            }
+
+            if (decoded < 0 || static_cast<size_t> (decoded) != envelope.size()) {
+                throw std::runtime_error ("Failed to decode the blob's envelope");
+            }
+
+            withReader (skeleton, [&](auto & reader_, auto & schema_, auto &) {
+                const auto * composite = dynamic_cast<
+                    const amqp::internal::reader::CompositeReader *> (&reader_);
+
+                if (!composite) {
+                    evolved = true;
+                    return;
+                }
+
+                timing.object();
+
+                amqp::internal::parallel::ParallelReader reader (
+                    threads_, minElements_);
+
+                reader.dump (
+                    "{ Parsed",
+                    object.data(),
+                    object.size(),
+                    *composite,
+                    schema_)->dumpTo (rtn);
+
+                rtn += " }";
+
+                timing.record (composite->type(), bytes());
+            }, threads_, m_local);
+        } catch (...) {
+            if (skeleton) {
+                pn_data_free (skeleton);
+            }
+
+            timing.error();
+            throw;
         }
+
+        pn_data_free (skeleton);
     }
+
+    // reading it again records it again, so the parallel attempt didn't
+    return evolved ? dump() : rtn;
+}
+
+/******************************************************************************/
+
+void
+BlobInspector::visit (amqp::reader::IVisitor & visitor_) {
+    read ([&visitor_](auto & reader_, auto & schema_, auto &, const auto & source_) {
+        if constexpr (std::is_same_v<
+                std::decay_t<decltype (source_)>, amqp::internal::scan::Cursor>)
+        {
+            visitor_.encoded (source_.entry().size);
+        }
+
+        reader_.visit (source_, schema_, visitor_);
+    });
+}
+
+/******************************************************************************/
+
+amqp::internal::dom::Document
+BlobInspector::document() {
+    amqp::internal::dom::DocumentBuilder builder;
+
+    visit (builder);
+
+    return builder.document();
+}
+
+/******************************************************************************/
+
+bool
+BlobInspector::matches (amqp::internal::filter::Filter & filter_) {
+    bool rtn { false };
+
+    read ([&filter_, &rtn](
+            auto & reader_, auto & schema_, auto & descriptor_, const auto & source_)
+    {
+        amqp::internal::filter::FilterVisitor visitor (
+            filter_.compile (schema_, descriptor_));
+
+        reader_.visit (source_, schema_, visitor);
+
+        rtn = visitor.accepted();
+    });
+
+    return rtn;
 }
 
 /******************************************************************************/
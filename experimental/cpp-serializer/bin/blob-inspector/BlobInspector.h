@@ -1,23 +1,132 @@
 #pragma once
 
 #include <iosfwd>
+#include <memory>
+#include <string>
+
 #include "CordaBytes.h"
 
 /******************************************************************************/
 
 struct pn_data_t;
 
+namespace amqp::reader {
+    class IVisitor;
+}
+
+namespace amqp::internal::filter {
+    class Filter;
+}
+
+namespace amqp::internal::scan {
+    class Tape;
+}
+
+namespace amqp::internal::dom {
+    class Document;
+}
+
+namespace amqp::internal::schema {
+    class Envelope;
+    class Schema;
+}
+
+/******************************************************************************/
+
+/**
+ * The schema carried by a blob written with the versions of the classes
+ * we want to read other blobs as. Where a blob was written with another
+ * version of one of them it's presented as this version, properties the
+ * local version doesn't have dropped and those the blob doesn't have
+ * given a default.
+ */
+class LocalSchema {
+    private :
+        std::unique_ptr<amqp::internal::schema::Envelope> m_envelope;
+
+    public :
+        explicit LocalSchema (const CordaBytes &);
+        ~LocalSchema();
+
+        const amqp::internal::schema::Schema & schema() const;
+};
+
 /******************************************************************************/
 
 class BlobInspector {
+    public :
+        /**
+         * How the object within the blob is read. Proton decodes the
+         * whole blob into a tree before anything can look at it, with
+         * a tape only the envelope is handed to proton, to build the
+         * readers from, and the object is read straight from the
+         * encoding through a [scan::Tape].
+         */
+        enum Decoder { proton_d, tape_d };
+
     private :
+        const CordaBytes & m_bytes;
+
+        Decoder m_decoder;
+
+        const LocalSchema * m_local;
+
+        /**
+         * Decoded on first use as reading in parallel doesn't need
+         * the whole blob decoded up front. When using a tape this is
+         * just the envelope.
+         */
         pn_data_t * m_data;
 
+        /**
+         * When using a tape, the envelope with the object removed, and
+         * the structure of the object
+         */
+        std::string m_skeleton;
+        std::unique_ptr<amqp::internal::scan::Tape> m_tape;
+
+        pn_data_t * data();
+
+        size_t bytes() const;
+
+        template<class F>
+        void read (F);
+
     public :
-        BlobInspector (CordaBytes &);
+        explicit BlobInspector (
+            const CordaBytes &,
+            Decoder = proton_d,
+            const LocalSchema * = nullptr);
+        BlobInspector (const BlobInspector &) = delete;
+
+        ~BlobInspector();
 
         std::string dump();
 
+        /**
+         * As [dump] but reading the largest top level collection using
+         * [threads_] threads if it has at least [minElements_] elements.
+         * The readers for the schema are built with the same threads.
+         */
+        std::string dump (size_t threads_, size_t minElements_);
+
+        /**
+         * Rather than rendering the blob as a string, walk it
+         * with the supplied visitor
+         */
+        void visit (amqp::reader::IVisitor &);
+
+        /**
+         * Decode the blob onto a compact [dom::Document] rather than
+         * a tree of values
+         */
+        amqp::internal::dom::Document document();
+
+        /**
+         * Check the blob against a filter, stopping as soon as it's clear
+         * the blob can't match rather than decoding all of it
+         */
+        bool matches (amqp::internal::filter::Filter &);
 };
 
 /******************************************************************************/
@@ -1,14 +1,20 @@
 #include "CordaBytes.h"
 
 #include <array>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
 #include <sys/stat.h>
 #include "amqp/AMQPHeader.h"
+#include "amqp/trace/Trace.h"
 
 /******************************************************************************/
 
 CordaBytes::CordaBytes (const std::string & file_)
     : m_blob { nullptr }
 {
+    amqp::internal::trace::Span span ("CordaBytes::load");
+
     std::ifstream file { file_, std::ios::in | std::ios::binary };
     struct stat results { };
 
@@ -26,7 +32,11 @@ CordaBytes::CordaBytes (const std::string & file_)
         throw std::runtime_error ("Not a Corda stream");
     }
 
-    file.read (reinterpret_cast<char *>(&m_encoding), 1);
+    // the encoding is a single byte in the stream, don't read it straight
+    // into the enum or we're left with whatever was in the rest of it
+    char encoding { 0 };
+    file.read (&encoding, 1);
+    m_encoding = static_cast<amqp::amqp_section_id_t> (encoding);
 
     m_blob = new char[m_size];
 
@@ -36,3 +46,45 @@ CordaBytes::CordaBytes (const std::string & file_)
 
 /******************************************************************************/
 
+
+CordaBytes::CordaBytes (const char * bytes_, size_t size_)
+    : m_blob { nullptr }
+{
+    if (size_ < amqp::AMQP_HEADER.size() + 1
+        || !std::equal (
+            amqp::AMQP_HEADER.begin(), amqp::AMQP_HEADER.end(), bytes_))
+    {
+        throw std::runtime_error ("Not a Corda stream");
+    }
+
+    m_encoding = static_cast<amqp::amqp_section_id_t> (
+        bytes_[amqp::AMQP_HEADER.size()]);
+
+    m_size = size_ - (amqp::AMQP_HEADER.size() + 1);
+    m_blob = new char[m_size];
+
+    memcpy (m_blob, bytes_ + amqp::AMQP_HEADER.size() + 1, m_size);
+}
+
+/******************************************************************************/
+
+CordaBytes::CordaBytes (
+    const std::array<char, 8> & header_,
+    std::unique_ptr<char[]> blob_,
+    size_t size_
+) : m_size (size_)
+  , m_blob { nullptr }
+{
+    if (!std::equal (
+            amqp::AMQP_HEADER.begin(), amqp::AMQP_HEADER.end(), header_.begin()))
+    {
+        throw std::runtime_error ("Not a Corda stream");
+    }
+
+    m_encoding = static_cast<amqp::amqp_section_id_t> (
+        header_[amqp::AMQP_HEADER.size()]);
+
+    m_blob = blob_.release();
+}
+
+/******************************************************************************/
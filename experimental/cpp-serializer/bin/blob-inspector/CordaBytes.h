@@ -1,6 +1,8 @@
 #pragma once
 
 #include "string"
+#include <array>
+#include <memory>
 #include <fstream>
 #include "amqp/AMQPSectionId.h"
 
@@ -15,6 +17,20 @@ class CordaBytes {
     public :
         explicit CordaBytes (const std::string &);
 
+        /**
+         * A blob already in memory, laid out as it would be in a file
+         * with the Corda header first
+         */
+        CordaBytes (const char *, size_t);
+
+        /**
+         * A blob read by someone else, its header having been read
+         * separately from the rest, which we take ownership of
+         */
+        CordaBytes (const std::array<char, 8> &, std::unique_ptr<char[]>, size_t);
+
+        CordaBytes (const CordaBytes &) = delete;
+
         ~CordaBytes() {
             delete [] m_blob;
         }
@@ -0,0 +1,417 @@
+#include "Daemon.h"
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/un.h>
+#include <sys/time.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+
+#include "amqp/AMQPSectionId.h"
+#include "amqp/dom/Document.h"
+
+#include "CordaBytes.h"
+#include "BlobInspector.h"
+
+/******************************************************************************/
+
+namespace {
+
+    [[noreturn]] void
+    fail (const std::string & what_) {
+        std::stringstream ss;
+        ss << what_ << ": " << strerror (errno);
+        throw std::runtime_error (ss.str());
+    }
+
+    /**
+     * Read exactly [size_] bytes, false if the peer went away first
+     */
+    bool
+    readAll (int fd_, char * at_, size_t size_) {
+        while (size_) {
+            auto n = ::recv (fd_, at_, size_, 0);
+
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+
+            if (n <= 0) {
+                return false;
+            }
+
+            at_ += n;
+            size_ -= n;
+        }
+
+        return true;
+    }
+
+    bool
+    writeAll (int fd_, const char * at_, size_t size_) {
+        while (size_) {
+            auto n = ::send (fd_, at_, size_, MSG_NOSIGNAL);
+
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+
+            if (n <= 0) {
+                return false;
+            }
+
+            at_ += n;
+            size_ -= n;
+        }
+
+        return true;
+    }
+
+    uint32_t
+    readLE32 (const unsigned char * at_) {
+        return static_cast<uint32_t> (at_[0])
+            | static_cast<uint32_t> (at_[1]) << 8
+            | static_cast<uint32_t> (at_[2]) << 16
+            | static_cast<uint32_t> (at_[3]) << 24;
+    }
+
+    void
+    writeLE32 (char * at_, uint32_t value_) {
+        for (int i { 0 } ; i < 4 ; ++i) {
+            at_[i] = static_cast<char> (value_ >> (8 * i));
+        }
+    }
+
+}
+
+/******************************************************************************/
+
+Daemon::Daemon (
+    std::string path_,
+    size_t threads_,
+    const LocalSchema * local_
+) : m_path (std::move (path_))
+  , m_threads (threads_ ? threads_ : std::thread::hardware_concurrency())
+  , m_local (local_)
+  , m_fd (-1)
+  , m_epoll (-1)
+  , m_wake { -1, -1 }
+  , m_stopping (false)
+{
+    if (!m_threads) {
+        m_threads = 1;
+    }
+
+    sockaddr_un addr { };
+    addr.sun_family = AF_UNIX;
+
+    if (m_path.size() >= sizeof (addr.sun_path)) {
+        throw std::runtime_error ("Socket path too long: " + m_path);
+    }
+
+    strncpy (addr.sun_path, m_path.c_str(), sizeof (addr.sun_path) - 1);
+
+    // non blocking so [accept] can take every waiting connection and stop
+    m_fd = ::socket (AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+
+    if (m_fd < 0) {
+        fail ("socket");
+    }
+
+    ::unlink (m_path.c_str());
+
+    if (::bind (m_fd, reinterpret_cast<sockaddr *> (&addr), sizeof (addr)) != 0
+        || ::listen (m_fd, SOMAXCONN) != 0
+        || (m_epoll = ::epoll_create1 (EPOLL_CLOEXEC)) < 0
+        || ::pipe2 (m_wake, O_NONBLOCK | O_CLOEXEC) != 0)
+    {
+        auto err = errno;
+        ::close (m_fd);
+        if (m_epoll >= 0) {
+            ::close (m_epoll);
+        }
+        errno = err;
+        fail ("Can't listen on " + m_path);
+    }
+
+    for (auto fd : { m_fd, m_wake[0] }) {
+        epoll_event event { };
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+
+        ::epoll_ctl (m_epoll, EPOLL_CTL_ADD, fd, &event);
+    }
+}
+
+/******************************************************************************/
+
+Daemon::~Daemon() {
+    ::close (m_fd);
+    ::close (m_epoll);
+    ::close (m_wake[0]);
+    ::close (m_wake[1]);
+    ::unlink (m_path.c_str());
+}
+
+/******************************************************************************/
+
+void
+Daemon::serve() {
+    std::vector<std::thread> workers;
+    workers.reserve (m_threads);
+
+    for (size_t i { 0 } ; i < m_threads ; ++i) {
+        workers.emplace_back (&Daemon::worker, this);
+    }
+
+    std::array<epoll_event, 64> events;
+
+    while (!m_stopping) {
+        auto n = ::epoll_wait (m_epoll, events.data(), events.size(), -1);
+
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            // nothing to be done but stop
+            break;
+        }
+
+        for (int i { 0 } ; i < n ; ++i) {
+            auto fd = events[i].data.fd;
+
+            if (fd == m_wake[0]) {
+                m_stopping = true;
+            } else if (fd == m_fd) {
+                accept();
+            } else {
+                // the connection is disarmed until its worker is done
+                std::lock_guard<std::mutex> lock (m_lock);
+                m_queue.push_back (fd);
+                m_ready.notify_one();
+            }
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock (m_lock);
+        m_stopping = true;
+    }
+
+    m_ready.notify_all();
+
+    for (auto & worker : workers) {
+        worker.join();
+    }
+
+    for (auto fd : m_open) {
+        ::close (fd);
+    }
+
+    m_open.clear();
+}
+
+/******************************************************************************/
+
+void
+Daemon::stop() {
+    char c { 0 };
+
+    m_stopping = true;
+
+    // only async signal safe calls as we may be in a signal handler, and
+    // if the pipe's full we've already been asked to stop
+    (void)!::write (m_wake[1], &c, 1);
+}
+
+/******************************************************************************/
+
+/**
+ * Take every connection that's waiting and start watching it for requests
+ */
+void
+Daemon::accept() {
+    for (;;) {
+        int fd = ::accept4 (m_fd, nullptr, nullptr, SOCK_CLOEXEC);
+
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+
+            // EAGAIN, or out of descriptors, either way there's nothing
+            // more to take for now
+            return;
+        }
+
+        timeval timeout { requestTimeout, 0 };
+        ::setsockopt (fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof (timeout));
+        ::setsockopt (fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof (timeout));
+
+        {
+            std::lock_guard<std::mutex> lock (m_lock);
+            m_open.insert (fd);
+        }
+
+        epoll_event event { };
+        event.events = EPOLLIN | EPOLLONESHOT;
+        event.data.fd = fd;
+
+        if (::epoll_ctl (m_epoll, EPOLL_CTL_ADD, fd, &event) != 0) {
+            close (fd);
+        }
+    }
+}
+
+/******************************************************************************/
+
+/**
+ * Serve one request from each connection handed to us, rearming it
+ * afterwards. The buffers live as long as the worker so a steady stream
+ * of blobs of similar size doesn't allocate for them. Once stopped we
+ * answer whatever's already waiting and finish.
+ */
+void
+Daemon::worker() {
+    std::string request;
+    std::string payload;
+
+    for (;;) {
+        int fd;
+
+        {
+            std::unique_lock<std::mutex> lock (m_lock);
+
+            m_ready.wait (lock, [this] { return m_stopping || !m_queue.empty(); });
+
+            if (m_queue.empty()) {
+                return;
+            }
+
+            fd = m_queue.front();
+            m_queue.pop_front();
+        }
+
+        if (!this->request (fd, request, payload)) {
+            close (fd);
+            continue;
+        }
+
+        epoll_event event { };
+        event.events = EPOLLIN | EPOLLONESHOT;
+        event.data.fd = fd;
+
+        if (::epoll_ctl (m_epoll, EPOLL_CTL_MOD, fd, &event) != 0) {
+            close (fd);
+        }
+    }
+}
+
+/******************************************************************************/
+
+/**
+ * Read a request from a connection and answer it, false if the connection
+ * should be closed
+ */
+bool
+Daemon::request (int fd_, std::string & request_, std::string & payload_) {
+    unsigned char header[4];
+
+    if (!readAll (fd_, reinterpret_cast<char *> (header), sizeof (header))) {
+        return false;
+    }
+
+    auto length = readLE32 (header);
+
+    if (length < 1 || length > maxRequest) {
+        return false;
+    }
+
+    request_.resize (length);
+
+    if (!readAll (fd_, request_.data(), length)) {
+        return false;
+    }
+
+    // leave room at the front for the response header
+    payload_.assign (5, '\0');
+
+    auto status = decode (
+        static_cast<uint8_t> (request_[0]),
+        request_.data() + 1,
+        length - 1,
+        m_local,
+        payload_);
+
+    writeLE32 (payload_.data(), payload_.size() - 4);
+    payload_[4] = static_cast<char> (status);
+
+    return writeAll (fd_, payload_.data(), payload_.size());
+}
+
+/******************************************************************************/
+
+void
+Daemon::close (int fd_) {
+    ::epoll_ctl (m_epoll, EPOLL_CTL_DEL, fd_, nullptr);
+
+    {
+        std::lock_guard<std::mutex> lock (m_lock);
+        m_open.erase (fd_);
+    }
+
+    ::close (fd_);
+}
+
+/******************************************************************************/
+
+Daemon::Status
+Daemon::decode (
+    uint8_t flags_,
+    const char * blob_,
+    size_t size_,
+    const LocalSchema * local_,
+    std::string & payload_
+) {
+    try {
+        CordaBytes cb (blob_, size_);
+
+        if (cb.encoding() != amqp::DATA_AND_STOP) {
+            std::stringstream ss;
+            ss << "BAD ENCODING " << cb.encoding() << " != " << amqp::DATA_AND_STOP;
+            throw std::runtime_error (ss.str());
+        }
+
+        BlobInspector blobInspector (
+            cb,
+            (flags_ & tape_f) ? BlobInspector::tape_d : BlobInspector::proton_d,
+            local_);
+
+        if (flags_ & document_f) {
+            std::ostringstream out;
+            blobInspector.document().write (out);
+            payload_ += out.str();
+        } else {
+            payload_ += blobInspector.dump();
+        }
+
+        return ok;
+    } catch (const std::exception & e) {
+        payload_ += e.what();
+    } catch (...) {
+        payload_ += "Unknown error";
+    }
+
+    return error;
+}
+
+/******************************************************************************/
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <set>
+#include <mutex>
+#include <deque>
+#include <atomic>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <condition_variable>
+
+/******************************************************************************/
+
+class LocalSchema;
+
+/******************************************************************************/
+
+/**
+ * Decode blobs sent over a Unix domain socket rather than starting a new
+ * process for each of them. Everything that's built once per process, the
+ * descriptor registry, the property readers and the shared [ReaderCache],
+ * stays warm across requests, so a blob whose types have been seen before
+ * only pays for reading its schema and its object.
+ *
+ * One thread waits, through epoll, on the listening socket and every open
+ * connection and hands a connection with a request waiting on it to a pool
+ * of [threads] workers. A worker serves that one request and gives the
+ * connection back, so any number of connections, idle or not, share the
+ * pool and none of them holds a worker between requests. A connection's
+ * requests are answered in order, clients wanting more than one in flight
+ * open more than one connection. Every integer is little endian.
+ *
+ * A request is
+ *
+ *      length  : u32, the number of bytes that follow
+ *      flags   : u8, a combination of [Flags]
+ *      blob    : length - 1 bytes, laid out as a blob file with the
+ *                Corda header first
+ *
+ * and the response
+ *
+ *      length  : u32, the number of bytes that follow
+ *      status  : u8, [ok] or [error]
+ *      payload : length - 1 bytes, the blob as JSON, as [BlobInspector::dump]
+ *                would have it, or as a [dom::Document] in the layout
+ *                written by [dom::Document::write]. On error, a message.
+ *
+ * A request that can't be framed, too long say, or whose bytes don't all
+ * arrive within [requestTimeout] of each other, closes the connection.
+ */
+class Daemon {
+    public :
+        enum Flags : uint8_t {
+            // answer with a [dom::Document] rather than JSON
+            document_f = 0x01,
+            // read the object through a [scan::Tape]
+            tape_f     = 0x02
+        };
+
+        enum Status : uint8_t { ok = 0, error = 1 };
+
+        /**
+         * The longest request we'll read
+         */
+        static constexpr size_t maxRequest = 256 * 1024 * 1024;
+
+        /**
+         * How long, in seconds, a worker waits on a client part way through
+         * sending a request
+         */
+        static constexpr int requestTimeout = 10;
+
+    private :
+        std::string m_path;
+
+        size_t m_threads;
+
+        const LocalSchema * m_local;
+
+        int m_fd;
+
+        int m_epoll;
+
+        // written to by [stop] to wake [serve]
+        int m_wake[2];
+
+        std::atomic<bool> m_stopping;
+
+        /**
+         * Connections with a request waiting, and every connection that's
+         * open so whatever's left can be closed when we stop
+         */
+        std::mutex m_lock;
+        std::condition_variable m_ready;
+        std::deque<int> m_queue;
+        std::set<int> m_open;
+
+        void accept();
+
+        void worker();
+
+        bool request (int, std::string &, std::string &);
+
+        void close (int);
+
+    public :
+        /**
+         * Listen on [path_], replacing anything already there. With no
+         * count of threads we use one per core.
+         */
+        Daemon (std::string path_, size_t threads_ = 0, const LocalSchema * = nullptr);
+        Daemon (const Daemon &) = delete;
+
+        ~Daemon();
+
+        /**
+         * Serve requests until [stop] is called
+         */
+        void serve();
+
+        /**
+         * Stop accepting connections and requests. Requests already
+         * waiting are answered, then every connection is closed and
+         * [serve] returns. Safe to call from a signal handler.
+         */
+        void stop();
+
+        /**
+         * Decode a single request as a worker would, appending the
+         * response's payload to [payload_]
+         */
+        static Status decode (
+            uint8_t flags_,
+            const char *,
+            size_t,
+            const LocalSchema *,
+            std::string & payload_);
+};
+
+/******************************************************************************/
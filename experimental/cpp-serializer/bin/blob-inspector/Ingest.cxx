@@ -0,0 +1,743 @@
+#include "Ingest.h"
+#include "CordaBytes.h"
+
+#include <array>
+#include <mutex>
+#include <thread>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <algorithm>
+#include <stdexcept>
+#include <condition_variable>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/uio.h>
+#include <sys/stat.h>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#   define HAVE_IO_URING
+#   include <sys/mman.h>
+#   include <sys/syscall.h>
+#   include <linux/io_uring.h>
+#endif
+
+#include "amqp/trace/Trace.h"
+
+/******************************************************************************/
+
+namespace {
+
+    const size_t headerSize = 8;
+
+    /**
+     * One file being read, its header and body going to separate
+     * buffers so the body can be handed to a [CordaBytes] as is
+     */
+    struct Slot {
+        enum State { idle, opening, reading, closing, done };
+
+        State state { idle };
+
+        size_t index { SIZE_MAX };
+
+        int fd { -1 };
+
+        // the size of the file and how much of it has been read
+        size_t size { 0 };
+        size_t read { 0 };
+
+        std::array<char, headerSize> header { };
+        std::unique_ptr<char[]> body;
+
+        iovec iov[2] { };
+        int iovs { 0 };
+
+        // operations submitted and not yet completed
+        int inflight { 0 };
+
+        std::string error;
+
+        void reset (size_t index_) {
+            state = opening;
+            index = index_;
+            fd = -1;
+            size = read = 0;
+            body.reset();
+            inflight = 0;
+            error.clear();
+        }
+
+        void fail (const std::string & why_) {
+            if (error.empty()) {
+                error = why_;
+            }
+        }
+
+        void fail (int errno_) {
+            fail (strerror (errno_));
+        }
+
+        bool failed() const { return !error.empty(); }
+
+        bool complete() const { return read == size; }
+
+        /**
+         * Size the buffers once we know how big the file is
+         */
+        void sized (size_t size_) {
+            if (size_ < headerSize) {
+                fail ("Not a Corda stream");
+                return;
+            }
+
+            size = size_;
+            body.reset (new char[size - headerSize]);
+        }
+
+        /**
+         * Point [iov] at whatever is still to be read
+         */
+        void remaining() {
+            iovs = 0;
+
+            if (read < headerSize) {
+                iov[iovs++] = { header.data() + read, headerSize - read };
+                iov[iovs++] = { body.get(), size - headerSize };
+            } else {
+                iov[iovs++] = { body.get() + (read - headerSize), size - read };
+            }
+        }
+
+        void advance (ssize_t read_) {
+            if (read_ == 0) {
+                fail ("unexpected end of file");
+            } else {
+                read += read_;
+            }
+        }
+
+        std::unique_ptr<CordaBytes> bytes (const std::string & path_) {
+            if (failed()) {
+                std::stringstream ss;
+                ss << "Can't read " << path_ << ": " << error;
+                throw std::runtime_error (ss.str());
+            }
+
+            state = idle;
+
+            return std::make_unique<CordaBytes> (
+                header, std::move (body), size - headerSize);
+        }
+    };
+
+    /**
+     * Read a file with ordinary blocking calls
+     */
+    void
+    readFile (const std::string & path_, Slot & slot_) {
+        amqp::internal::trace::Span span ("Ingest::read");
+
+        slot_.fd = ::open (path_.c_str(), O_RDONLY | O_CLOEXEC);
+
+        if (slot_.fd < 0) {
+            slot_.fail (errno);
+            return;
+        }
+
+        struct stat results { };
+
+        if (::fstat (slot_.fd, &results) != 0) {
+            slot_.fail (errno);
+        } else {
+            slot_.sized (results.st_size);
+        }
+
+        while (!slot_.failed() && !slot_.complete()) {
+            slot_.remaining();
+
+            auto n = ::preadv (slot_.fd, slot_.iov, slot_.iovs, slot_.read);
+
+            if (n < 0) {
+                if (errno != EINTR) {
+                    slot_.fail (errno);
+                }
+            } else {
+                slot_.advance (n);
+            }
+        }
+
+        ::close (slot_.fd);
+    }
+
+}
+
+/******************************************************************************/
+
+#ifdef HAVE_IO_URING
+
+namespace {
+
+    /**
+     * Just enough of an io_uring, driven through the raw system calls,
+     * for a single thread to submit to and reap from
+     */
+    class Ring {
+        private :
+            int m_fd;
+
+            void * m_sq;
+            size_t m_sqLen;
+            void * m_cq;
+            size_t m_cqLen;
+
+            io_uring_sqe * m_sqes;
+            size_t m_sqesLen;
+
+            unsigned * m_sqHead;
+            unsigned * m_sqTail;
+            unsigned * m_sqArray;
+            unsigned   m_sqMask;
+            unsigned   m_sqEntries;
+
+            unsigned * m_cqHead;
+            unsigned * m_cqTail;
+            unsigned   m_cqMask;
+
+            io_uring_cqe * m_cqes;
+
+            // queued but not yet handed to the kernel
+            unsigned m_queued;
+
+            template<typename T>
+            T * at (void * base_, size_t offset_) {
+                return reinterpret_cast<T *> (static_cast<char *> (base_) + offset_);
+            }
+
+        public :
+            explicit Ring (unsigned entries_);
+            Ring (const Ring &) = delete;
+            ~Ring();
+
+            /**
+             * The next free submission, zeroed, to be filled in
+             * and then [push]ed
+             */
+            io_uring_sqe * sqe();
+            void push();
+
+            /**
+             * Hand everything queued to the kernel, waiting for at
+             * least [wait_] completions
+             */
+            void submit (unsigned wait_);
+
+            template<class F>
+            void reap (F f_) {
+                auto head = *m_cqHead;
+                auto tail = __atomic_load_n (m_cqTail, __ATOMIC_ACQUIRE);
+
+                while (head != tail) {
+                    const auto & cqe = m_cqes[head & m_cqMask];
+                    f_ (cqe.user_data, cqe.res);
+                    ++head;
+                }
+
+                __atomic_store_n (m_cqHead, head, __ATOMIC_RELEASE);
+            }
+
+            /**
+             * Whether the kernel will give us a ring that can do
+             * everything we need of it
+             */
+            static bool available();
+    };
+
+    int
+    setup (unsigned entries_, io_uring_params & params_) {
+        return static_cast<int> (::syscall (__NR_io_uring_setup, entries_, &params_));
+    }
+
+}
+
+/******************************************************************************/
+
+Ring::Ring (unsigned entries_)
+    : m_queued (0)
+{
+    io_uring_params params { };
+
+    m_fd = setup (entries_, params);
+
+    if (m_fd < 0) {
+        std::stringstream ss;
+        ss << "io_uring_setup: " << strerror (errno);
+        throw std::runtime_error (ss.str());
+    }
+
+    m_sqLen = params.sq_off.array + params.sq_entries * sizeof (unsigned);
+    m_cqLen = params.cq_off.cqes + params.cq_entries * sizeof (io_uring_cqe);
+
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        m_sqLen = m_cqLen = std::max (m_sqLen, m_cqLen);
+    }
+
+    m_sq = ::mmap (nullptr, m_sqLen, PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQ_RING);
+
+    m_cq = (params.features & IORING_FEAT_SINGLE_MMAP)
+        ? m_sq
+        : ::mmap (nullptr, m_cqLen, PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_CQ_RING);
+
+    m_sqesLen = params.sq_entries * sizeof (io_uring_sqe);
+
+    m_sqes = static_cast<io_uring_sqe *> (::mmap (nullptr, m_sqesLen,
+        PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQES));
+
+    if (m_sq == MAP_FAILED || m_cq == MAP_FAILED || m_sqes == MAP_FAILED) {
+        auto err = errno;
+        if (m_sq != MAP_FAILED) ::munmap (m_sq, m_sqLen);
+        if (m_cq != MAP_FAILED && m_cq != m_sq) ::munmap (m_cq, m_cqLen);
+        if (m_sqes != MAP_FAILED) ::munmap (m_sqes, m_sqesLen);
+        ::close (m_fd);
+
+        std::stringstream ss;
+        ss << "io_uring mmap: " << strerror (err);
+        throw std::runtime_error (ss.str());
+    }
+
+    m_sqHead    = at<unsigned> (m_sq, params.sq_off.head);
+    m_sqTail    = at<unsigned> (m_sq, params.sq_off.tail);
+    m_sqArray   = at<unsigned> (m_sq, params.sq_off.array);
+    m_sqMask    = *at<unsigned> (m_sq, params.sq_off.ring_mask);
+    m_sqEntries = *at<unsigned> (m_sq, params.sq_off.ring_entries);
+
+    m_cqHead    = at<unsigned> (m_cq, params.cq_off.head);
+    m_cqTail    = at<unsigned> (m_cq, params.cq_off.tail);
+    m_cqMask    = *at<unsigned> (m_cq, params.cq_off.ring_mask);
+    m_cqes      = at<io_uring_cqe> (m_cq, params.cq_off.cqes);
+}
+
+/******************************************************************************/
+
+Ring::~Ring() {
+    ::munmap (m_sqes, m_sqesLen);
+    if (m_cq != m_sq) {
+        ::munmap (m_cq, m_cqLen);
+    }
+    ::munmap (m_sq, m_sqLen);
+    ::close (m_fd);
+}
+
+/******************************************************************************/
+
+io_uring_sqe *
+Ring::sqe() {
+    // we're the only producer so only the head can move under us
+    if (*m_sqTail - __atomic_load_n (m_sqHead, __ATOMIC_ACQUIRE) == m_sqEntries) {
+        submit (0);
+    }
+
+    auto * sqe = &m_sqes[*m_sqTail & m_sqMask];
+    memset (sqe, 0, sizeof (*sqe));
+
+    return sqe;
+}
+
+/******************************************************************************/
+
+void
+Ring::push() {
+    auto tail = *m_sqTail;
+
+    m_sqArray[tail & m_sqMask] = tail & m_sqMask;
+    __atomic_store_n (m_sqTail, tail + 1, __ATOMIC_RELEASE);
+
+    ++m_queued;
+}
+
+/******************************************************************************/
+
+void
+Ring::submit (unsigned wait_) {
+    for (;;) {
+        auto n = ::syscall (__NR_io_uring_enter, m_fd, m_queued, wait_,
+            wait_ ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+
+        if (n >= 0) {
+            m_queued -= static_cast<unsigned> (n);
+            return;
+        }
+
+        if (errno != EINTR) {
+            std::stringstream ss;
+            ss << "io_uring_enter: " << strerror (errno);
+            throw std::runtime_error (ss.str());
+        }
+    }
+}
+
+/******************************************************************************/
+
+bool
+Ring::available() {
+    io_uring_params params { };
+
+    int fd = setup (2, params);
+
+    if (fd < 0) {
+        return false;
+    }
+
+    // the probe's ops are a flexible array so give it room for them all
+    alignas (io_uring_probe) char buffer[
+        sizeof (io_uring_probe) + 256 * sizeof (io_uring_probe_op)] { };
+
+    auto * probe = reinterpret_cast<io_uring_probe *> (buffer);
+
+    bool rtn = ::syscall (
+        __NR_io_uring_register, fd, IORING_REGISTER_PROBE, probe, 256) == 0;
+
+    for (auto op : { IORING_OP_OPENAT, IORING_OP_STATX, IORING_OP_READV, IORING_OP_CLOSE }) {
+        rtn = rtn
+            && op <= probe->last_op
+            && (probe->ops[op].flags & IO_URING_OP_SUPPORTED);
+    }
+
+    ::close (fd);
+
+    return rtn;
+}
+
+#endif
+
+/******************************************************************************/
+
+Ingest::Ingest (
+    sVec<std::string> paths_,
+    size_t depth_,
+    Backend backend_
+) : m_paths (std::move (paths_))
+  , m_depth (std::max (depth_, size_t { 1 }))
+  , m_backend (backend_)
+{
+#ifdef HAVE_IO_URING
+    bool uring = Ring::available();
+#else
+    bool uring = false;
+#endif
+
+    if (m_backend == automatic_b) {
+        m_backend = uring ? uring_b : threads_b;
+    } else if (m_backend == uring_b && !uring) {
+        throw std::runtime_error ("io_uring isn't available");
+    }
+}
+
+/******************************************************************************/
+
+void
+Ingest::each (const Consumer & consumer_) {
+    if (m_paths.empty()) {
+        return;
+    }
+
+    if (m_backend == uring_b) {
+        uring (consumer_);
+    } else {
+        threads (consumer_);
+    }
+}
+
+/******************************************************************************/
+
+/**
+ * Each file is opened and stat'd at once, the size telling us how much
+ * to read, then read with as many reads as that takes and closed. The
+ * slot is then ready to be handed over and, once it has been, reused for
+ * the file [depth] further on.
+ */
+void
+Ingest::uring (const Consumer & consumer_) {
+#ifdef HAVE_IO_URING
+    enum Op : uint64_t { open_op, statx_op, read_op, close_op };
+
+    const size_t files = m_paths.size();
+    const size_t depth = std::min (m_depth, files);
+
+    // each slot has at most two submissions in flight
+    Ring ring (static_cast<unsigned> (depth * 2));
+
+    sVec<Slot> slots (depth);
+    sVec<struct statx> stats (depth);
+
+    // slots started and not yet done
+    size_t active { 0 };
+
+    // set once we won't be handing anything more over
+    bool stopping { false };
+
+    auto closeSlot = [&](size_t s_) {
+        auto & slot = slots[s_];
+
+        if (slot.fd < 0) {
+            slot.state = Slot::done;
+            --active;
+            return;
+        }
+
+        auto * sqe = ring.sqe();
+        sqe->opcode = IORING_OP_CLOSE;
+        sqe->fd = slot.fd;
+        sqe->user_data = s_ << 2 | close_op;
+        ring.push();
+
+        slot.state = Slot::closing;
+        slot.inflight = 1;
+    };
+
+    auto readSlot = [&](size_t s_) {
+        auto & slot = slots[s_];
+        slot.remaining();
+
+        auto * sqe = ring.sqe();
+        sqe->opcode = IORING_OP_READV;
+        sqe->fd = slot.fd;
+        sqe->addr = reinterpret_cast<uintptr_t> (slot.iov);
+        sqe->len = slot.iovs;
+        sqe->off = slot.read;
+        sqe->user_data = s_ << 2 | read_op;
+        ring.push();
+
+        slot.state = Slot::reading;
+        slot.inflight = 1;
+    };
+
+    auto startSlot = [&](size_t i_) {
+        auto s = i_ % depth;
+        auto & slot = slots[s];
+        slot.reset (i_);
+
+        auto * sqe = ring.sqe();
+        sqe->opcode = IORING_OP_OPENAT;
+        sqe->fd = AT_FDCWD;
+        sqe->addr = reinterpret_cast<uintptr_t> (m_paths[i_].c_str());
+        sqe->open_flags = O_RDONLY | O_CLOEXEC;
+        sqe->user_data = s << 2 | open_op;
+        ring.push();
+
+        sqe = ring.sqe();
+        sqe->opcode = IORING_OP_STATX;
+        sqe->fd = AT_FDCWD;
+        sqe->addr = reinterpret_cast<uintptr_t> (m_paths[i_].c_str());
+        sqe->len = STATX_SIZE;
+        sqe->off = reinterpret_cast<uintptr_t> (&stats[s]);
+        sqe->user_data = s << 2 | statx_op;
+        ring.push();
+
+        slot.inflight = 2;
+        ++active;
+    };
+
+    // move a slot on once everything it was waiting for has completed
+    auto advance = [&](size_t s_) {
+        auto & slot = slots[s_];
+
+        switch (slot.state) {
+            case Slot::opening :
+                if (!slot.failed()) {
+                    slot.sized (stats[s_].stx_size);
+                }
+                [[fallthrough]];
+            case Slot::reading :
+                if (slot.failed() || slot.complete() || stopping) {
+                    closeSlot (s_);
+                } else {
+                    readSlot (s_);
+                }
+                break;
+            case Slot::closing :
+                slot.state = Slot::done;
+                --active;
+                break;
+            default :
+                break;
+        }
+    };
+
+    auto completed = [&](uint64_t data_, int res_) {
+        auto s = data_ >> 2;
+        auto & slot = slots[s];
+
+        switch (data_ & 3) {
+            case open_op :
+                if (res_ < 0) slot.fail (-res_); else slot.fd = res_;
+                break;
+            case statx_op :
+                if (res_ < 0) slot.fail (-res_);
+                break;
+            case read_op :
+                if (res_ < 0) slot.fail (-res_); else slot.advance (res_);
+                break;
+            default :
+                break;
+        }
+
+        if (--slot.inflight == 0) {
+            advance (s);
+        }
+    };
+
+    auto drain = [&]() {
+        stopping = true;
+
+        while (active) {
+            ring.submit (1);
+            ring.reap (completed);
+        }
+    };
+
+    size_t started { 0 };
+
+    try {
+        for ( ; started < depth ; ++started) {
+            startSlot (started);
+        }
+
+        for (size_t next { 0 } ; next < files ; ) {
+            auto & slot = slots[next % depth];
+
+            if (slot.state != Slot::done) {
+                amqp::internal::trace::Span span ("Ingest::wait");
+
+                ring.submit (1);
+                ring.reap (completed);
+                continue;
+            }
+
+            if (!consumer_ (next, *slot.bytes (m_paths[next]))) {
+                break;
+            }
+
+            if (started < files) {
+                startSlot (started++);
+            }
+
+            ++next;
+        }
+    } catch (...) {
+        // the kernel is still writing into our buffers
+        drain();
+        throw;
+    }
+
+    drain();
+#else
+    threads (consumer_);
+#endif
+}
+
+/******************************************************************************/
+
+/**
+ * Workers claim files in order, never getting more than [depth] ahead of
+ * those handed over, and read them with blocking calls
+ */
+void
+Ingest::threads (const Consumer & consumer_) {
+    const size_t files = m_paths.size();
+    const size_t depth = std::min (m_depth, files);
+
+    std::mutex mutex;
+    std::condition_variable cv;
+
+    sVec<Slot> slots (depth);
+
+    size_t claimed { 0 };
+    size_t consumed { 0 };
+    bool stopping { false };
+
+    auto worker = [&]() {
+        std::unique_lock<std::mutex> lock (mutex);
+
+        for (;;) {
+            cv.wait (lock, [&]() {
+                return stopping || claimed == files || claimed < consumed + depth;
+            });
+
+            if (stopping || claimed == files) {
+                return;
+            }
+
+            auto i = claimed++;
+            auto & slot = slots[i % depth];
+            slot.reset (i);
+
+            lock.unlock();
+            readFile (m_paths[i], slot);
+            lock.lock();
+
+            slot.state = Slot::done;
+            cv.notify_all();
+        }
+    };
+
+    auto count = std::min<size_t> (
+        depth, std::max (1U, 4 * std::thread::hardware_concurrency()));
+
+    sVec<std::thread> workers;
+    workers.reserve (count);
+
+    for (size_t i { 0 } ; i < count ; ++i) {
+        workers.emplace_back (worker);
+    }
+
+    auto stop = [&]() {
+        {
+            std::lock_guard<std::mutex> lock (mutex);
+            stopping = true;
+        }
+
+        cv.notify_all();
+
+        for (auto & worker : workers) {
+            worker.join();
+        }
+    };
+
+    try {
+        for (size_t next { 0 } ; next < files ; ++next) {
+            auto & slot = slots[next % depth];
+            std::unique_ptr<CordaBytes> bytes;
+
+            {
+                amqp::internal::trace::Span span ("Ingest::wait");
+
+                std::unique_lock<std::mutex> lock (mutex);
+
+                cv.wait (lock, [&]() {
+                    return slot.index == next && slot.state == Slot::done;
+                });
+
+                bytes = slot.bytes (m_paths[next]);
+                ++consumed;
+            }
+
+            cv.notify_all();
+
+            if (!consumer_ (next, *bytes)) {
+                break;
+            }
+        }
+    } catch (...) {
+        stop();
+        throw;
+    }
+
+    stop();
+}
+
+/******************************************************************************/
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+#include <functional>
+
+#include "types.h"
+
+/******************************************************************************/
+
+class CordaBytes;
+
+/******************************************************************************/
+
+/**
+ * Read a corpus of blob files ahead of whoever is decoding them.
+ *
+ * Reading many small files one at a time leaves the device idle whilst we
+ * wait on each open, stat and read in turn. Instead up to [depth] files
+ * are in flight at once. Where the kernel supports it that's done through
+ * io_uring, every open, statx, read and close being a submission and each
+ * call into the kernel submitting and reaping a batch of them. Otherwise
+ * a pool of threads does the same with ordinary system calls.
+ *
+ * Blobs are handed over in the order they were named whichever order they
+ * arrive in, so what's built from them is the same as reading them one at
+ * a time, with the header read separately from the body so the body can
+ * be handed over without copying it.
+ */
+class Ingest {
+    public :
+        enum Backend {
+            // io_uring if the kernel lets us have one, else threads
+            automatic_b,
+            uring_b,
+            threads_b
+        };
+
+        /**
+         * Called with the index of each file and its contents, returning
+         * false to stop reading any more
+         */
+        using Consumer = std::function<bool(size_t, const CordaBytes &)>;
+
+        static constexpr size_t defaultDepth = 64;
+
+    private :
+        sVec<std::string> m_paths;
+
+        size_t m_depth;
+
+        Backend m_backend;
+
+        void uring (const Consumer &);
+        void threads (const Consumer &);
+
+    public :
+        explicit Ingest (
+            sVec<std::string> paths_,
+            size_t depth_ = defaultDepth,
+            Backend = automatic_b);
+
+        /**
+         * The backend that will be used, never [automatic_b]
+         */
+        Backend backend() const { return m_backend; }
+
+        /**
+         * Read every file, handing each to [consumer_] in turn on the
+         * calling thread. A file that can't be read throws once those
+         * before it have been consumed.
+         */
+        void each (const Consumer & consumer_);
+};
+
+/******************************************************************************/
@@ -0,0 +1,464 @@
+#include "Metrics.h"
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <ostream>
+#include <iostream>
+
+/******************************************************************************/
+
+namespace {
+
+    using clock = std::chrono::steady_clock;
+
+    const std::array<const char *, Metrics::phases> phaseNames { // NOLINT
+        "schema", "object", "total"
+    };
+
+    const std::array<double, 4> quantiles { 0.5, 0.9, 0.99, 0.999 }; // NOLINT
+
+    /**
+     * Only the recording thread writes to a counter so there's no need
+     * for a locked read-modify-write, just make the result visible
+     */
+    void
+    bump (std::atomic<uint64_t> & counter_, uint64_t by_ = 1) {
+        counter_.store (
+            counter_.load (std::memory_order_relaxed) + by_,
+            std::memory_order_relaxed);
+    }
+
+    /**
+     * Label values are quoted, with backslashes, quotes and new lines
+     * escaped
+     */
+    std::string
+    label (const std::string & value_) {
+        std::string rtn;
+        rtn.reserve (value_.size());
+
+        for (auto c : value_) {
+            switch (c) {
+                case '\\' : rtn += "\\\\"; break;
+                case '"'  : rtn += "\\\""; break;
+                case '\n' : rtn += "\\n"; break;
+                default   : rtn += c;
+            }
+        }
+
+        return rtn;
+    }
+
+    double
+    seconds (uint64_t ns_) {
+        return static_cast<double> (ns_) / 1e9;
+    }
+
+    struct Merged {
+        std::array<Histogram::Snapshot, Metrics::phases> latencies;
+
+        uint64_t decodes { 0 };
+        uint64_t bytes { 0 };
+    };
+
+}
+
+/******************************************************************************
+ *
+ * Histogram
+ *
+ ******************************************************************************/
+
+Histogram::Histogram()
+    : m_count (0)
+    , m_sum (0)
+    , m_max (0)
+{
+    for (auto & count : m_counts) {
+        count.store (0, std::memory_order_relaxed);
+    }
+}
+
+/******************************************************************************/
+
+size_t
+Histogram::bucket (uint64_t value_) {
+    const uint64_t largest = (uint64_t { 1 } << maxBits) - 1;
+
+    if (value_ > largest) {
+        value_ = largest;
+    }
+
+    if (value_ < (uint64_t { 1 } << subBits)) {
+        return value_;
+    }
+
+    // how far to shift the value to leave its top [subBits] - 1 bits
+    unsigned shift = (63 - __builtin_clzll (value_)) - (subBits - 1);
+
+    return (size_t { shift } << (subBits - 1)) + (value_ >> shift);
+}
+
+/******************************************************************************/
+
+uint64_t
+Histogram::highest (size_t bucket_) {
+    if (bucket_ < (size_t { 1 } << subBits)) {
+        return bucket_;
+    }
+
+    size_t half = size_t { 1 } << (subBits - 1);
+
+    unsigned shift = bucket_ / half - 1;
+    uint64_t mantissa = bucket_ % half + half;
+
+    return ((mantissa + 1) << shift) - 1;
+}
+
+/******************************************************************************/
+
+void
+Histogram::record (uint64_t value_) {
+    bump (m_counts[bucket (value_)]);
+    bump (m_count);
+    bump (m_sum, value_);
+
+    if (value_ > m_max.load (std::memory_order_relaxed)) {
+        m_max.store (value_, std::memory_order_relaxed);
+    }
+}
+
+/******************************************************************************/
+
+Histogram::Snapshot::Snapshot()
+    : counts (buckets, 0)
+{ }
+
+/******************************************************************************/
+
+void
+Histogram::Snapshot::add (const Histogram & histogram_) {
+    for (size_t i { 0 } ; i < buckets ; ++i) {
+        counts[i] += histogram_.m_counts[i].load (std::memory_order_relaxed);
+    }
+
+    // Read after the buckets, the count might be behind them if the
+    // owner is still recording but quantiles are taken from the buckets
+    // so that doesn't matter
+    count += histogram_.m_count.load (std::memory_order_relaxed);
+    sum += histogram_.m_sum.load (std::memory_order_relaxed);
+    max = std::max (max, histogram_.m_max.load (std::memory_order_relaxed));
+}
+
+/******************************************************************************/
+
+uint64_t
+Histogram::Snapshot::quantile (double q_) const {
+    uint64_t total { 0 };
+    for (auto c : counts) {
+        total += c;
+    }
+
+    if (total == 0) {
+        return 0;
+    }
+
+    auto rank = static_cast<uint64_t> (std::ceil (q_ * total));
+    if (rank == 0) {
+        rank = 1;
+    }
+
+    uint64_t seen { 0 };
+
+    for (size_t i { 0 } ; i < buckets ; ++i) {
+        seen += counts[i];
+
+        if (seen >= rank) {
+            return std::min (highest (i), max);
+        }
+    }
+
+    return max;
+}
+
+/******************************************************************************
+ *
+ * Metrics
+ *
+ ******************************************************************************/
+
+std::atomic<Metrics *> Metrics::m_installed { nullptr }; // NOLINT
+
+std::atomic<uint64_t> Metrics::m_entering { 0 }; // NOLINT
+
+/******************************************************************************/
+
+Metrics::Metrics (
+    std::string path_,
+    std::chrono::steady_clock::duration period_
+) : m_path (std::move (path_))
+  , m_period (period_)
+  , m_last (clock::now())
+{
+    static std::atomic<uint64_t> ids { 0 }; // NOLINT
+
+    m_id = ++ids;
+
+    m_installed.store (this, std::memory_order_release);
+
+    if (!m_path.empty()) {
+        m_writer = std::thread ([this] {
+            std::unique_lock<std::mutex> lock (m_lock);
+
+            while (!m_wake.wait_for (lock, m_period, [this] { return m_stop; })) {
+                lock.unlock();
+                write();
+                lock.lock();
+            }
+        });
+    }
+}
+
+/******************************************************************************/
+
+Metrics::~Metrics() {
+    Metrics * self { this };
+    m_installed.compare_exchange_strong (self, nullptr);
+
+    // Once nobody is between loading [m_installed] and counting their
+    // handle every thread that saw us has been counted, and anyone
+    // looking now finds we've gone
+    while (m_entering.load()) {
+        std::this_thread::yield();
+    }
+
+    while (m_handles.load()) {
+        std::this_thread::yield();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock (m_lock);
+        m_stop = true;
+    }
+
+    m_wake.notify_all();
+
+    if (m_writer.joinable()) {
+        m_writer.join();
+        write();
+    }
+}
+
+/******************************************************************************
+ *
+ * Metrics::Handle
+ *
+ ******************************************************************************/
+
+Metrics::
+Handle::Handle() {
+    ++m_entering;
+
+    m_metrics = m_installed.load();
+    if (m_metrics) {
+        ++m_metrics->m_handles;
+    }
+
+    --m_entering;
+}
+
+/******************************************************************************/
+
+Metrics::
+Handle::~Handle() {
+    if (m_metrics) {
+        --m_metrics->m_handles;
+    }
+}
+
+/******************************************************************************/
+
+Metrics::Series &
+Metrics::Recorder::find (const std::string & type_) {
+    auto it = series.find (type_);
+
+    if (it != series.end()) {
+        return *it->second;
+    }
+
+    std::lock_guard<std::mutex> guard (lock);
+
+    return *series.emplace (type_, std::make_unique<Series>()).first->second;
+}
+
+/******************************************************************************/
+
+Metrics::Recorder &
+Metrics::recorder() {
+    struct Local {
+        uint64_t id { 0 };
+        sPtr<Recorder> recorder;
+    };
+
+    thread_local Local local; // NOLINT
+
+    if (local.id != m_id) {
+        auto recorder = std::make_shared<Recorder>();
+
+        {
+            std::lock_guard<std::mutex> lock (m_lock);
+            m_recorders.push_back (recorder);
+        }
+
+        local.id = m_id;
+        local.recorder = std::move (recorder);
+    }
+
+    return *local.recorder;
+}
+
+/******************************************************************************/
+
+void
+Metrics::record (
+    const std::string & type_,
+    size_t bytes_,
+    const Latencies & latencies_
+) {
+    auto & series = recorder().find (type_);
+
+    for (size_t i { 0 } ; i < phases ; ++i) {
+        series.latencies[i].record (latencies_[i]);
+    }
+
+    bump (series.decodes);
+    bump (series.bytes, bytes_);
+}
+
+/******************************************************************************/
+
+void
+Metrics::error() {
+    bump (recorder().errors);
+}
+
+/******************************************************************************/
+
+void
+Metrics::write (std::ostream & out_) {
+    std::map<std::string, Merged> merged;
+    uint64_t errors { 0 };
+
+    std::unique_lock<std::mutex> lock (m_lock);
+
+    for (const auto & recorder : m_recorders) {
+        std::lock_guard<std::mutex> guard (recorder->lock);
+
+        for (const auto & [type, series] : recorder->series) {
+            auto & m = merged[type];
+
+            for (size_t i { 0 } ; i < phases ; ++i) {
+                m.latencies[i].add (series->latencies[i]);
+            }
+
+            m.decodes += series->decodes.load (std::memory_order_relaxed);
+            m.bytes += series->bytes.load (std::memory_order_relaxed);
+        }
+
+        errors += recorder->errors.load (std::memory_order_relaxed);
+    }
+
+    uint64_t decodes { 0 };
+    uint64_t bytes { 0 };
+
+    for (const auto & [type, m] : merged) {
+        decodes += m.decodes;
+        bytes += m.bytes;
+    }
+
+    auto now = clock::now();
+    double elapsed = std::chrono::duration<double> (now - m_last).count();
+
+    double decodeRate = elapsed > 0 ? (decodes - m_lastDecodes) / elapsed : 0;
+    double byteRate = elapsed > 0 ? (bytes - m_lastBytes) / elapsed : 0;
+
+    m_last = now;
+    m_lastDecodes = decodes;
+    m_lastBytes = bytes;
+
+    lock.unlock();
+
+    out_ << "# HELP corda_blob_decode_seconds Time taken to decode a blob by root type and phase" << std::endl
+         << "# TYPE corda_blob_decode_seconds summary" << std::endl;
+
+    for (const auto & [type, m] : merged) {
+        auto t = label (type);
+
+        for (size_t i { 0 } ; i < phases ; ++i) {
+            const auto & latencies = m.latencies[i];
+
+            std::string labels = "type=\"" + t + "\",phase=\"" + phaseNames[i] + "\"";
+
+            for (auto q : quantiles) {
+                out_ << "corda_blob_decode_seconds{" << labels
+                     << ",quantile=\"" << q << "\"} "
+                     << seconds (latencies.quantile (q)) << std::endl;
+            }
+
+            out_ << "corda_blob_decode_seconds_sum{" << labels << "} "
+                 << seconds (latencies.sum) << std::endl
+                 << "corda_blob_decode_seconds_count{" << labels << "} "
+                 << latencies.count << std::endl;
+        }
+    }
+
+    out_ << "# HELP corda_blob_decodes_total Blobs decoded by root type" << std::endl
+         << "# TYPE corda_blob_decodes_total counter" << std::endl;
+
+    for (const auto & [type, m] : merged) {
+        out_ << "corda_blob_decodes_total{type=\"" << label (type) << "\"} "
+             << m.decodes << std::endl;
+    }
+
+    out_ << "# HELP corda_blob_decoded_bytes_total Bytes of blobs decoded by root type" << std::endl
+         << "# TYPE corda_blob_decoded_bytes_total counter" << std::endl;
+
+    for (const auto & [type, m] : merged) {
+        out_ << "corda_blob_decoded_bytes_total{type=\"" << label (type) << "\"} "
+             << m.bytes << std::endl;
+    }
+
+    out_ << "# HELP corda_blob_decode_errors_total Blobs that couldn't be decoded" << std::endl
+         << "# TYPE corda_blob_decode_errors_total counter" << std::endl
+         << "corda_blob_decode_errors_total " << errors << std::endl
+         << "# HELP corda_blob_decodes_per_second Blobs decoded per second since the last write" << std::endl
+         << "# TYPE corda_blob_decodes_per_second gauge" << std::endl
+         << "corda_blob_decodes_per_second " << decodeRate << std::endl
+         << "# HELP corda_blob_decoded_bytes_per_second Bytes decoded per second since the last write" << std::endl
+         << "# TYPE corda_blob_decoded_bytes_per_second gauge" << std::endl
+         << "corda_blob_decoded_bytes_per_second " << byteRate << std::endl;
+}
+
+/******************************************************************************/
+
+void
+Metrics::write() {
+    auto tmp = m_path + ".tmp";
+
+    {
+        std::ofstream out { tmp, std::ios::out | std::ios::trunc };
+        write (out);
+
+        if (!out) {
+            std::cerr << "Can't write metrics to " << tmp << std::endl;
+            return;
+        }
+    }
+
+    if (std::rename (tmp.c_str(), m_path.c_str()) != 0) {
+        std::cerr << "Can't write metrics to " << m_path << std::endl;
+    }
+}
+
+/******************************************************************************/
@@ -0,0 +1,230 @@
+#pragma once
+
+#include <map>
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <iosfwd>
+#include <string>
+#include <thread>
+#include <cstdint>
+#include <cstddef>
+#include <unordered_map>
+#include <condition_variable>
+
+#include "types.h"
+
+/******************************************************************************/
+
+/**
+ * A histogram in the style of HdrHistogram. Values are counted in
+ * buckets whose width grows with the value, 64 to every power of two
+ * beyond the first 128, so any value is known to within 1 part in 64
+ * however large it is while the whole range of a 64 bit nanosecond
+ * latency fits in a couple of thousand counters. Values beyond [maxBits]
+ * bits, a little over a minute in nanoseconds, are counted as the
+ * largest we can hold.
+ *
+ * Only one thread may record into a histogram, but any other can read
+ * it, through a [Snapshot], whilst it does.
+ */
+class Histogram {
+    public :
+        static constexpr unsigned subBits = 7;
+        static constexpr unsigned maxBits = 36;
+
+        static constexpr size_t buckets =
+            (maxBits - subBits) * (size_t { 1 } << (subBits - 1))
+                + (size_t { 1 } << subBits);
+
+        static size_t bucket (uint64_t);
+
+        /**
+         * The largest value counted in a bucket
+         */
+        static uint64_t highest (size_t);
+
+        /**
+         * What's been recorded so far, possibly merged from many
+         * histograms
+         */
+        struct Snapshot {
+            sVec<uint64_t> counts;
+            uint64_t       count { 0 };
+            uint64_t       sum { 0 };
+            uint64_t       max { 0 };
+
+            Snapshot();
+
+            void add (const Histogram &);
+
+            /**
+             * The value [q_] of the recorded values are at or below,
+             * to within the precision of the buckets
+             */
+            uint64_t quantile (double q_) const;
+        };
+
+    private :
+        std::array<std::atomic<uint64_t>, buckets> m_counts;
+
+        std::atomic<uint64_t> m_count;
+        std::atomic<uint64_t> m_sum;
+        std::atomic<uint64_t> m_max;
+
+    public :
+        Histogram();
+        Histogram (const Histogram &) = delete;
+
+        void record (uint64_t);
+};
+
+/******************************************************************************/
+
+/**
+ * Per blob decode latencies and throughput, written out periodically
+ * in Prometheus' text exposition format for a node exporter, or anything
+ * else, to pick up.
+ *
+ * Once made a [Metrics] is what [BlobInspector] records every blob it
+ * reads into, until it's destroyed. Latencies are kept by the type of the
+ * object in the blob and by phase, [schema] being decoding the envelope
+ * and building or finding the readers for it, [object] reading the
+ * object itself and [total] both.
+ *
+ * Recording mustn't skew what it's measuring so every thread records
+ * into its own histograms and counters, which only it writes to. The
+ * only lock taken when recording is when a thread first sees a type,
+ * everything else is a relaxed atomic store. Writing the file merges
+ * the threads' histograms without stopping any of them.
+ *
+ * The file is replaced whole each time, through a rename, so a reader
+ * never sees it half written. The counters and histograms cover the life
+ * of the process, the rates just the time since the last write.
+ */
+class Metrics {
+    public :
+        enum Phase { schema_p, object_p, total_p, phases };
+
+        static constexpr std::chrono::seconds defaultPeriod { 10 };
+
+    private :
+        struct Series {
+            std::array<Histogram, phases> latencies;
+
+            std::atomic<uint64_t> decodes { 0 };
+            std::atomic<uint64_t> bytes { 0 };
+        };
+
+        /**
+         * One thread's share of the metrics. The owning thread looks its
+         * series up without the lock as it's the only one that adds to
+         * them, and it only adds with the lock held.
+         */
+        struct Recorder {
+            std::mutex lock;
+
+            std::unordered_map<std::string, uPtr<Series>> series;
+
+            std::atomic<uint64_t> errors { 0 };
+
+            Series & find (const std::string &);
+        };
+
+        static std::atomic<Metrics *> m_installed;
+
+        /**
+         * Threads part way through picking up [m_installed], see [Handle]
+         */
+        static std::atomic<uint64_t> m_entering;
+
+        /**
+         * The [Handle]s onto this instance
+         */
+        std::atomic<uint64_t> m_handles { 0 };
+
+        /**
+         * Tells apart Metrics made one after the other at the same
+         * address so a thread doesn't record into a dead one's recorder
+         */
+        uint64_t m_id;
+
+        std::string m_path;
+
+        std::chrono::steady_clock::duration m_period;
+
+        std::mutex m_lock;
+
+        sVec<sPtr<Recorder>> m_recorders;
+
+        std::chrono::steady_clock::time_point m_last;
+        uint64_t m_lastDecodes { 0 };
+        uint64_t m_lastBytes { 0 };
+
+        bool m_stop { false };
+        std::condition_variable m_wake;
+        std::thread m_writer;
+
+        Recorder & recorder();
+
+    public :
+        using Latencies = std::array<uint64_t, phases>;
+
+        /**
+         * Keeps the installed [Metrics], if any, alive whilst in scope.
+         * Destroying a [Metrics] uninstalls it and then waits for every
+         * handle onto it to go before anything is torn down, so a thread
+         * part way through recording a blob never touches a dead one.
+         */
+        class Handle {
+            private :
+                Metrics * m_metrics;
+
+            public :
+                Handle();
+                Handle (const Handle &) = delete;
+                ~Handle();
+
+                Metrics * get() const { return m_metrics; }
+                Metrics * operator -> () const { return m_metrics; }
+
+                explicit operator bool() const { return m_metrics != nullptr; }
+        };
+
+        /**
+         * Write to [path_] every [period_], when given a path
+         */
+        explicit Metrics (
+            std::string path_ = { },
+            std::chrono::steady_clock::duration period_ = defaultPeriod);
+
+        Metrics (const Metrics &) = delete;
+
+        /**
+         * Waits for any [Handle]s onto us to go and then writes the
+         * file one last time
+         */
+        ~Metrics();
+
+        /**
+         * The [Metrics] blobs are being recorded into, if any
+         */
+        static Handle installed() {
+            return Handle();
+        }
+
+        /**
+         * A blob of [bytes_] holding a [type_], and how long in
+         * nanoseconds each phase of reading it took
+         */
+        void record (const std::string & type_, size_t bytes_, const Latencies &);
+
+        void error();
+
+        void write (std::ostream &);
+
+        void write();
+};
+
+/******************************************************************************/
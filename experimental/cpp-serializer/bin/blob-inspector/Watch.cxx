@@ -0,0 +1,231 @@
+#include "Watch.h"
+#include "CordaBytes.h"
+
+#include <array>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+
+#include "amqp/AMQPSectionId.h"
+#include "amqp/dom/Document.h"
+#include "amqp/json/StringEscape.h"
+
+/******************************************************************************/
+
+namespace {
+
+    [[noreturn]] void
+    fail (const std::string & what_) {
+        std::stringstream ss;
+        ss << what_ << ": " << strerror (errno);
+        throw std::runtime_error (ss.str());
+    }
+
+}
+
+/******************************************************************************/
+
+Watch::Watch (
+    std::string dir_,
+    int out_,
+    BlobInspector::Decoder decoder_,
+    const LocalSchema * local_
+) : m_dir (std::move (dir_))
+  , m_out (out_)
+  , m_decoder (decoder_)
+  , m_local (local_)
+  , m_inotify (-1)
+  , m_wake { -1, -1 }
+{
+    m_inotify = ::inotify_init1 (IN_NONBLOCK | IN_CLOEXEC);
+
+    if (m_inotify < 0) {
+        fail ("inotify_init1");
+    }
+
+    if (::inotify_add_watch (
+            m_inotify, m_dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_ONLYDIR) < 0
+        || ::pipe2 (m_wake, O_NONBLOCK | O_CLOEXEC) != 0)
+    {
+        auto err = errno;
+        ::close (m_inotify);
+        errno = err;
+        fail ("Can't watch " + m_dir);
+    }
+}
+
+/******************************************************************************/
+
+Watch::~Watch() {
+    ::close (m_inotify);
+    ::close (m_wake[0]);
+    ::close (m_wake[1]);
+}
+
+/******************************************************************************/
+
+void
+Watch::stop() {
+    char c { 0 };
+
+    // only async signal safe calls as we may be in a signal handler, and
+    // if the pipe's full we've already been asked to stop
+    (void)!::write (m_wake[1], &c, 1);
+}
+
+/******************************************************************************/
+
+void
+Watch::run() {
+    alignas (inotify_event) std::array<char, 64 * 1024> buffer;
+
+    pollfd fds[2] {
+        { m_inotify, POLLIN, 0 },
+        { m_wake[0], POLLIN, 0 }
+    };
+
+    for (;;) {
+        if (::poll (fds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            fail ("poll");
+        }
+
+        if (fds[1].revents) {
+            return;
+        }
+
+        for (;;) {
+            auto n = ::read (m_inotify, buffer.data(), buffer.size());
+
+            // as close as we get to when the files were closed, the
+            // kernel not timestamping its events
+            auto seen = std::chrono::steady_clock::now();
+
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+
+                if (errno == EAGAIN) {
+                    break;
+                }
+
+                fail ("inotify");
+            }
+
+            for (char * at = buffer.data() ; at < buffer.data() + n ; ) {
+                const auto * event = reinterpret_cast<const inotify_event *> (at);
+                at += sizeof (inotify_event) + event->len;
+
+                if (event->mask & IN_Q_OVERFLOW) {
+                    ++m_stats.errors;
+                    write (R"({"error":"inotify queue overflowed, blobs have been missed"})");
+                    continue;
+                }
+
+                if (event->mask & IN_IGNORED) {
+                    // the directory has gone
+                    return;
+                }
+
+                if (event->len == 0
+                    || (event->mask & IN_ISDIR)
+                    || event->name[0] == '.')
+                {
+                    continue;
+                }
+
+                decode (event->name, seen);
+            }
+        }
+    }
+}
+
+/******************************************************************************/
+
+void
+Watch::decode (
+    const std::string & name_,
+    std::chrono::steady_clock::time_point seen_
+) {
+    std::string body;
+    bool ok { false };
+
+    try {
+        CordaBytes cb (m_dir + "/" + name_);
+
+        if (cb.encoding() != amqp::DATA_AND_STOP) {
+            std::stringstream ss;
+            ss << "BAD ENCODING " << cb.encoding() << " != " << amqp::DATA_AND_STOP;
+            throw std::runtime_error (ss.str());
+        }
+
+        BlobInspector (cb, m_decoder, m_local).document().root().jsonTo (body);
+        ok = true;
+    } catch (const std::exception & e) {
+        body = e.what();
+    }
+
+    auto latency = static_cast<uint64_t> (
+        std::chrono::duration_cast<std::chrono::microseconds> (
+            std::chrono::steady_clock::now() - seen_).count());
+
+    std::string line { R"({"file":)" };
+    amqp::internal::json::appendQuoted (line, name_.data(), name_.size());
+
+    line += R"(,"latency_us":)";
+    line += std::to_string (latency);
+
+    if (ok) {
+        line += R"(,"object":)";
+        line += body;
+    } else {
+        line += R"(,"error":)";
+        amqp::internal::json::appendQuoted (line, body.data(), body.size());
+
+        ++m_stats.errors;
+    }
+
+    line += '}';
+
+    write (line);
+
+    ++m_stats.blobs;
+    m_stats.total += latency;
+    m_stats.max = std::max (m_stats.max, latency);
+}
+
+/******************************************************************************/
+
+void
+Watch::write (const std::string & line_) {
+    std::string out { line_ };
+    out += '\n';
+
+    for (size_t written { 0 } ; written < out.size() ; ) {
+        auto n = ::write (m_out, out.data() + written, out.size() - written);
+
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            fail ("Can't write output");
+        }
+
+        written += n;
+    }
+}
+
+/******************************************************************************/
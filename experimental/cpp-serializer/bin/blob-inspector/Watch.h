@@ -0,0 +1,100 @@
+#pragma once
+
+#include <string>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+#include "BlobInspector.h"
+
+/******************************************************************************/
+
+/**
+ * Decode blobs as they land in a spool directory, appending a line per
+ * blob to an output as soon as each has been written. Living as long as
+ * the directory is watched means every blob after the first of a type is
+ * read with the readers already built for it rather than paying for
+ * starting a new process each time.
+ *
+ * A file is picked up when whoever wrote it closes it, or when it's moved
+ * into the directory, so writers can either write in place or write
+ * elsewhere and rename. Names starting with a dot are ignored as the
+ * temporary files of the latter. Files already in the directory when
+ * the watch starts are left alone.
+ *
+ * Each line is a JSON object, so the output is newline delimited JSON,
+ * holding the name of the file, how long in microseconds it took from
+ * our being told the file was ready to its line being written, and the
+ * blob as [dom::Element::jsonTo] has it,
+ *
+ *      {"file":"a.blob","latency_us":212,"object":{...}}
+ *
+ * or, for a file that couldn't be decoded,
+ *
+ *      {"file":"b.blob","latency_us":87,"error":"..."}
+ *
+ * Lines are written with a single write so an output shared with other
+ * writers, opened to append, never has them interleaved.
+ */
+class Watch {
+    public :
+        struct Stats {
+            uint64_t blobs { 0 };
+            uint64_t errors { 0 };
+
+            // latencies in microseconds
+            uint64_t total { 0 };
+            uint64_t max { 0 };
+        };
+
+    private :
+        std::string m_dir;
+
+        int m_out;
+
+        BlobInspector::Decoder m_decoder;
+
+        const LocalSchema * m_local;
+
+        int m_inotify;
+
+        // written to by [stop] to wake [run]
+        int m_wake[2];
+
+        Stats m_stats;
+
+        void decode (const std::string &, std::chrono::steady_clock::time_point);
+
+        void write (const std::string &);
+
+    public :
+        /**
+         * Watch [dir_], writing lines to the file descriptor [out_],
+         * which stays the caller's to close
+         */
+        Watch (
+            std::string dir_,
+            int out_,
+            BlobInspector::Decoder = BlobInspector::proton_d,
+            const LocalSchema * = nullptr);
+
+        Watch (const Watch &) = delete;
+
+        ~Watch();
+
+        /**
+         * Decode blobs as they arrive until [stop] is called from
+         * another thread or a signal handler
+         */
+        void run();
+
+        void stop();
+
+        /**
+         * Only meaningful once [run] has returned
+         */
+        const Stats & stats() const { return m_stats; }
+};
+
+/******************************************************************************/
@@ -1,12 +1,17 @@
+#include <memory>
 #include <iostream>
 #include <iomanip>
 #include <fstream>
 #include <cstddef>
+#include <cstring>
 
 #include <assert.h>
 #include <string.h>
 #include <proton/types.h>
 #include <proton/codec.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
 #include <sys/stat.h>
 
 #include "debug.h"
@@ -19,13 +24,518 @@
 
 #include "amqp/schema/described-types/Envelope.h"
 #include "amqp/CompositeFactory.h"
+#include "amqp/columnar/ColumnarVisitor.h"
+#include "amqp/filter/Filter.h"
+#include "amqp/index/Index.h"
+#include "amqp/index/IndexVisitor.h"
+#include "amqp/parallel/ParallelReader.h"
+#include "amqp/sizes/SizeVisitor.h"
+#include "amqp/trace/Trace.h"
+#ifdef HAVE_SQLITE3
+#include "amqp/sqlite/SqliteVisitor.h"
+#endif
 #include "CordaBytes.h"
 #include "BlobInspector.h"
+#include "Daemon.h"
+#include "Ingest.h"
+#include "Metrics.h"
+#include "Watch.h"
+
+/******************************************************************************/
+
+namespace {
+
+    void
+    usage (const char * exe_) {
+        std::cerr
+            << "usage: " << exe_ << " [--schema BLOB] [--tape] FILE" << std::endl
+            << "       " << exe_ << " [--schema BLOB] --threads N FILE" << std::endl
+            << "       " << exe_ << " [--schema BLOB] [--tape] --columnar OUT FILE [FILE...]" << std::endl
+            << "       " << exe_ << " [--schema BLOB] [--tape] --csv OUT FILE [FILE...]" << std::endl
+            << "       " << exe_ << " [--schema BLOB] [--tape] --filter EXPR FILE [FILE...]" << std::endl
+            << "       " << exe_ << " [--schema BLOB] [--tape] --index OUT FILE [FILE...]" << std::endl
+            << "       " << exe_ << " [--schema BLOB] [--tape] --watch DIR [OUT]" << std::endl
+            << "       " << exe_ << " [--schema BLOB] --sizes [--folded] FILE [FILE...]" << std::endl
+#ifdef HAVE_SQLITE3
+            << "       " << exe_ << " [--schema BLOB] [--tape] --sqlite OUT FILE [FILE...]" << std::endl
+#endif
+            << "       " << exe_ << " --lookup INDEX TYPE PATH VALUE" << std::endl
+            << "       " << exe_ << " [--schema BLOB] --daemon SOCKET [THREADS]" << std::endl
+            << std::endl
+            << "Any of these can be preceded by --metrics FILE to write decode latencies" << std::endl
+            << "and throughput to FILE every " << Metrics::defaultPeriod.count()
+            << " seconds in Prometheus' text format, and by --trace FILE" << std::endl
+            << "to write a timeline of the run to FILE as a Chrome trace" << std::endl;
+    }
+
+    /**
+     * Read the named files ahead of decoding them, handing each to [f_]
+     * once we know it's a blob we can read
+     */
+    template<class F>
+    bool
+    ingest (int argc, char ** argv, F f_) {
+        bool rtn { true };
+
+        Ingest (sVec<std::string> (argv, argv + argc)).each (
+            [&](size_t i_, const CordaBytes & cb_) {
+                if (cb_.encoding() != amqp::DATA_AND_STOP) {
+                    std::cerr << "BAD ENCODING " << cb_.encoding() << " != "
+                        << amqp::DATA_AND_STOP << " in " << argv[i_] << std::endl;
+
+                    rtn = false;
+                    return false;
+                }
+
+                f_ (i_, cb_);
+
+                return true;
+            });
+
+        return rtn;
+    }
+
+    /**
+     * Decode many blobs of the same type into a set of columns, one row
+     * per blob, and write them out as either our columnar format or CSV
+     */
+    int
+    columnar (
+        BlobInspector::Decoder decoder_,
+        const LocalSchema * local_,
+        bool csv_,
+        const char * out_,
+        int argc,
+        char ** argv
+    ) {
+        amqp::internal::columnar::ColumnarVisitor visitor;
+
+        if (!ingest (argc, argv, [&](size_t, const CordaBytes & cb_) {
+                BlobInspector (cb_, decoder_, local_).visit (visitor);
+            }))
+        {
+            return EXIT_FAILURE;
+        }
+
+        std::ofstream out { out_, std::ios::out | std::ios::binary };
+
+        if (csv_) {
+            visitor.csv (out);
+        } else {
+            visitor.write (out);
+        }
+
+        return out ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+
+    /**
+     * Print every blob that satisfies the filter expression. As with grep
+     * the name of the file is prefixed when there is more than one
+     */
+    int
+    filter (
+        BlobInspector::Decoder decoder_,
+        const LocalSchema * local_,
+        const char * expr_,
+        int argc,
+        char ** argv
+    ) {
+        amqp::internal::filter::Filter filter { expr_ };
+
+        int rtn { EXIT_FAILURE };
+
+        if (!ingest (argc, argv, [&](size_t i_, const CordaBytes & cb_) {
+                BlobInspector blobInspector (cb_, decoder_, local_);
+
+                if (!blobInspector.matches (filter)) {
+                    return;
+                }
+
+                if (argc > 1) {
+                    std::cout << argv[i_] << ": ";
+                }
+
+                std::cout << blobInspector.dump() << std::endl;
+
+                rtn = EXIT_SUCCESS;
+            }))
+        {
+            return EXIT_FAILURE;
+        }
+
+        return rtn;
+    }
+
+
+    /**
+     * Decode a corpus once and write an index of every value in it
+     */
+    int
+    buildIndex (
+        BlobInspector::Decoder decoder_,
+        const LocalSchema * local_,
+        const char * out_,
+        int argc,
+        char ** argv
+    ) {
+        amqp::internal::index::IndexWriter writer;
+
+        if (!ingest (argc, argv, [&](size_t i_, const CordaBytes & cb_) {
+                amqp::internal::index::IndexVisitor visitor (
+                    writer, writer.addBlob (argv[i_]));
+
+                BlobInspector (cb_, decoder_, local_).visit (visitor);
+            }))
+        {
+            return EXIT_FAILURE;
+        }
+
+        std::ofstream out { out_, std::ios::out | std::ios::binary };
+
+        writer.write (out);
+
+        return out ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    /**
+     * Say where the bytes of a corpus go, either as a table or as folded
+     * stacks for a flame graph. The sizes come from the tape so that's
+     * how the blobs are read whatever was asked for.
+     */
+    int
+    sizes (
+        const LocalSchema * local_,
+        bool folded_,
+        int argc,
+        char ** argv
+    ) {
+        amqp::internal::sizes::SizeVisitor visitor;
+
+        if (!ingest (argc, argv, [&](size_t, const CordaBytes & cb_) {
+                visitor.envelope (cb_.bytes(), cb_.size());
+                BlobInspector (cb_, BlobInspector::tape_d, local_).visit (visitor);
+            }))
+        {
+            return EXIT_FAILURE;
+        }
+
+        if (folded_) {
+            visitor.folded (std::cout);
+        } else {
+            visitor.table (std::cout);
+        }
+
+        return EXIT_SUCCESS;
+    }
+
+#ifdef HAVE_SQLITE3
+
+    /**
+     * Load a corpus into a SQLite database, a table per type
+     */
+    int
+    sqlite (
+        BlobInspector::Decoder decoder_,
+        const LocalSchema * local_,
+        const char * out_,
+        int argc,
+        char ** argv
+    ) {
+        amqp::internal::sqlite::SqliteVisitor visitor { out_ };
+
+        if (!ingest (argc, argv, [&](size_t, const CordaBytes & cb_) {
+                BlobInspector (cb_, decoder_, local_).visit (visitor);
+            }))
+        {
+            return EXIT_FAILURE;
+        }
+
+        visitor.commit();
+
+        return EXIT_SUCCESS;
+    }
+
+#endif
+
+    /**
+     * Trace everything from here on, writing out what was recorded once
+     * we're done
+     */
+    class Tracing {
+        private :
+            std::string m_path;
+
+        public :
+            explicit Tracing (std::string path_)
+                : m_path (std::move (path_))
+            {
+                amqp::internal::trace::Tracer::start();
+            }
+
+            Tracing (const Tracing &) = delete;
+
+            ~Tracing() {
+                amqp::internal::trace::Tracer::stop();
+
+                std::ofstream out { m_path, std::ios::out | std::ios::trunc };
+                amqp::internal::trace::Tracer::write (out);
+
+                if (!out) {
+                    std::cerr << "Can't write the trace to " << m_path << std::endl;
+                }
+            }
+    };
+
+    Watch * watching { nullptr }; // NOLINT
+
+    Daemon * serving { nullptr }; // NOLINT
+
+    /**
+     * Decode blobs as they land in a directory until interrupted, then
+     * say how quickly we kept up
+     */
+    int
+    watch (
+        BlobInspector::Decoder decoder_,
+        const LocalSchema * local_,
+        const char * dir_,
+        const char * out_
+    ) {
+        int out = out_
+            ? ::open (out_, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644)
+            : STDOUT_FILENO;
+
+        if (out < 0) {
+            std::cerr << "Can't open " << out_ << ": " << strerror (errno) << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        Watch watch (dir_, out, decoder_, local_);
+
+        watching = &watch;
+
+        struct sigaction action { };
+        action.sa_handler = [](int) { watching->stop(); };
+        sigaction (SIGINT, &action, nullptr);
+        sigaction (SIGTERM, &action, nullptr);
+
+        watch.run();
+
+        watching = nullptr;
+
+        if (out_) {
+            ::close (out);
+        }
+
+        const auto & stats = watch.stats();
+
+        std::cerr << stats.blobs << " blobs, " << stats.errors << " errors";
+        if (stats.blobs) {
+            std::cerr << ", latency mean " << stats.total / stats.blobs
+                << "us max " << stats.max << "us";
+        }
+        std::cerr << std::endl;
+
+        return EXIT_SUCCESS;
+    }
+
+    /**
+     * Print the name of each blob, and which occurrence of the field
+     * it was, where the value was seen
+     */
+    int
+    lookup (char ** argv) {
+        amqp::internal::index::Index index { argv[0] };
+
+        auto postings = index.lookup (argv[1], argv[2], argv[3]);
+
+        for (const auto & posting : postings) {
+            std::cout << index.blob (posting.blob) << " "
+                << posting.ordinal << std::endl;
+        }
+
+        return postings.empty() ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+
+}
 
 /******************************************************************************/
 
 int
 main (int argc, char **argv) {
+    if (argc < 2) {
+        usage (argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // Live until we return so their files are written one last time
+    std::unique_ptr<Metrics> metrics;
+    std::unique_ptr<Tracing> tracing;
+
+    while (strcmp (argv[1], "--metrics") == 0 || strcmp (argv[1], "--trace") == 0) {
+        if (argc < 4) {
+            usage (argv[0]);
+            return EXIT_FAILURE;
+        }
+
+        if (strcmp (argv[1], "--metrics") == 0) {
+            metrics = std::make_unique<Metrics> (argv[2]);
+        } else {
+            tracing = std::make_unique<Tracing> (argv[2]);
+        }
+
+        // drop the option but keep our name at the front
+        argv[2] = argv[0];
+        argc -= 2;
+        argv += 2;
+    }
+
+    auto decoder { BlobInspector::proton_d };
+
+    std::unique_ptr<LocalSchema> local;
+
+    if (strcmp (argv[1], "--schema") == 0) {
+        if (argc < 4) {
+            usage (argv[0]);
+            return EXIT_FAILURE;
+        }
+
+        local = std::make_unique<LocalSchema> (CordaBytes (argv[2]));
+
+        // drop the flag and its file but keep our name at the front
+        argv[2] = argv[0];
+        argc -= 2;
+        argv += 2;
+    }
+
+    if (strcmp (argv[1], "--daemon") == 0) {
+        if (argc != 3 && argc != 4) {
+            usage (argv[0]);
+            return EXIT_FAILURE;
+        }
+
+        Daemon daemon (
+            argv[2], argc == 4 ? std::stoul (argv[3]) : 0, local.get());
+
+        serving = &daemon;
+
+        // stop cleanly so the socket's removed and any metrics or trace
+        // written out
+        struct sigaction action { };
+        action.sa_handler = [](int) { serving->stop(); };
+        sigaction (SIGINT, &action, nullptr);
+        sigaction (SIGTERM, &action, nullptr);
+
+        daemon.serve();
+
+        serving = nullptr;
+
+        return EXIT_SUCCESS;
+    }
+
+    if (strcmp (argv[1], "--tape") == 0) {
+        if (argc < 3) {
+            usage (argv[0]);
+            return EXIT_FAILURE;
+        }
+
+        decoder = BlobInspector::tape_d;
+
+        // drop the flag but keep our name at the front
+        argv[1] = argv[0];
+        --argc;
+        ++argv;
+    }
+
+    if (strcmp (argv[1], "--columnar") == 0 || strcmp (argv[1], "--csv") == 0) {
+        if (argc < 4) {
+            usage (argv[0]);
+            return EXIT_FAILURE;
+        }
+
+        return columnar (
+            decoder,
+            local.get(),
+            strcmp (argv[1], "--csv") == 0, argv[2], argc - 3, argv + 3);
+    }
+
+    if (strcmp (argv[1], "--filter") == 0) {
+        if (argc < 4) {
+            usage (argv[0]);
+            return EXIT_FAILURE;
+        }
+
+        return filter (decoder, local.get(), argv[2], argc - 3, argv + 3);
+    }
+
+    if (strcmp (argv[1], "--index") == 0) {
+        if (argc < 4) {
+            usage (argv[0]);
+            return EXIT_FAILURE;
+        }
+
+        return buildIndex (decoder, local.get(), argv[2], argc - 3, argv + 3);
+    }
+
+    if (strcmp (argv[1], "--sizes") == 0) {
+        bool folded = argc > 2 && strcmp (argv[2], "--folded") == 0;
+
+        if (argc < (folded ? 4 : 3)) {
+            usage (argv[0]);
+            return EXIT_FAILURE;
+        }
+
+        return sizes (
+            local.get(), folded, argc - (folded ? 3 : 2), argv + (folded ? 3 : 2));
+    }
+
+#ifdef HAVE_SQLITE3
+    if (strcmp (argv[1], "--sqlite") == 0) {
+        if (argc < 4) {
+            usage (argv[0]);
+            return EXIT_FAILURE;
+        }
+
+        return sqlite (decoder, local.get(), argv[2], argc - 3, argv + 3);
+    }
+#endif
+
+    if (strcmp (argv[1], "--watch") == 0) {
+        if (argc != 3 && argc != 4) {
+            usage (argv[0]);
+            return EXIT_FAILURE;
+        }
+
+        return watch (
+            decoder, local.get(), argv[2], argc == 4 ? argv[3] : nullptr);
+    }
+
+    if (strcmp (argv[1], "--lookup") == 0) {
+        if (argc != 6) {
+            usage (argv[0]);
+            return EXIT_FAILURE;
+        }
+
+        return lookup (argv + 2);
+    }
+
+    size_t threads { 1 };
+
+    if (strcmp (argv[1], "--threads") == 0) {
+        if (argc != 4) {
+            usage (argv[0]);
+            return EXIT_FAILURE;
+        }
+
+        threads = std::stoul (argv[2]);
+
+        // drop the flag and its count but keep our name at the front
+        argv[2] = argv[0];
+        argc -= 2;
+        argv += 2;
+    }
+
     struct stat results { };
 
     if (stat(argv[1], &results) != 0) {
@@ -35,8 +545,10 @@ main (int argc, char **argv) {
     CordaBytes cb (argv[1]);
     
     if (cb.encoding() == amqp::DATA_AND_STOP) {
-        BlobInspector blobInspector (cb);
-        auto val = blobInspector.dump();
+        BlobInspector blobInspector (cb, decoder, local.get());
+        auto val = blobInspector.dump (
+            threads,
+            amqp::internal::parallel::ParallelReader::defaultMinElements);
         std::cout << val << std::endl;
     } else {
         std::cerr << "BAD ENCODING " << cb.encoding() << " != "
@@ -1,6 +1,25 @@
 #include <gtest/gtest.h>
 #include "CordaBytes.h"
 #include "BlobInspector.h"
+#include "Daemon.h"
+#include "Ingest.h"
+#include "Metrics.h"
+#include "Watch.h"
+
+#include "amqp/filter/Filter.h"
+#include "amqp/dom/Document.h"
+#include "amqp/index/Index.h"
+#include "amqp/index/IndexVisitor.h"
+#include "amqp/sizes/SizeVisitor.h"
+
+#include <cstdio>
+#include <thread>
+#include <fstream>
+#include <sstream>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/un.h>
+#include <sys/socket.h>
 
 const std::string filepath ("../../test-files/"); // NOLINT
 
@@ -77,7 +96,7 @@ TEST (BlobInspector, _L_i__) { // NOLINT
 /******************************************************************************/
 
 TEST (BlobInspector, _Le_) { // NOLINT
-    test ("_Le_", "{ Parsed : { listy : [ A, B, C ] } }");
+    test ("_Le_", R"({ Parsed : { listy : [ "A", "B", "C" ] } })");
 }
 
 /******************************************************************************/
@@ -130,7 +149,7 @@ TEST (BlobInspector,_Pls_) { // NOLINT
 /******************************************************************************/
 
 TEST (BlobInspector, _e_) { // NOLINT
-    test ("_e_", "{ Parsed : { e : A } }");
+    test ("_e_", R"({ Parsed : { e : "A" } })");
 }
 
 /******************************************************************************/
@@ -165,7 +184,769 @@ TEST (BlobInspector, __i_LMis_l__) { // NOLINT
 
 TEST (BlobInspector, _ALd_) { // NOLINT
     test ("_ALd_",
-            R"({ Parsed : { a : [ [ 10.100000, 11.200000, 12.300000 ], [  ], [ 13.400000 ] ] } })");
+            R"({ Parsed : { a : [ [ 10.1, 11.2, 12.3 ], [  ], [ 13.4 ] ] } })");
+}
+
+/******************************************************************************/
+
+/******************************************************************************
+ *
+ * Filter Tests
+ *
+ ******************************************************************************/
+
+bool
+matches (
+    const std::string & file_,
+    const std::string & expr_,
+    BlobInspector::Decoder decoder_ = BlobInspector::proton_d
+) {
+    auto path { filepath + file_ } ;
+    CordaBytes cb (path);
+    amqp::internal::filter::Filter filter { expr_ };
+    return BlobInspector (cb, decoder_).matches (filter);
+}
+
+/******************************************************************************/
+
+TEST (BlobInspector, filterSingle) { // NOLINT
+    EXPECT_TRUE (matches ("_i_", "a = 69"));
+    EXPECT_TRUE (matches ("_i_", "a >= 69 and a < 70"));
+    EXPECT_FALSE (matches ("_i_", "a > 69"));
+    EXPECT_TRUE (matches ("_l_", "x == 100000000000"));
+    EXPECT_TRUE (matches ("_e_", "e = A"));
+    EXPECT_FALSE (matches ("_e_", "e != A"));
+}
+
+/******************************************************************************/
+
+TEST (BlobInspector, filterRepeated) { // NOLINT
+    EXPECT_TRUE (matches ("_Li_", "a[] = 6"));
+    EXPECT_FALSE (matches ("_Li_", "a[] > 6"));
+    EXPECT_TRUE (matches ("_ALd_", "a[][] > 13"));
+    EXPECT_TRUE (matches (
+        "__i_LMis_l__",
+        R"(x[]{}.value = "ten" and z.a = 666 and y.x > 10)"));
+    EXPECT_FALSE (matches ("__i_LMis_l__", "x[]{}.key = 2"));
+}
+
+/******************************************************************************/
+
+TEST (BlobInspector, filterBadPath) { // NOLINT
+    EXPECT_THROW (matches ("_i_", "b = 1"), std::runtime_error);
+    EXPECT_THROW (matches ("_Li_", "a = 1"), std::runtime_error);
+    EXPECT_THROW (matches ("_i_", "a.b = 1"), std::runtime_error);
+}
+
+/******************************************************************************/
+
+/******************************************************************************
+ *
+ * Index Tests
+ *
+ ******************************************************************************/
+
+TEST (BlobInspector, index) { // NOLINT
+    using namespace amqp::internal::index;
+
+    IndexWriter writer;
+
+    for (const auto & file : { "_i_", "_Oi_", "_Li_", "__i_LMis_l__" }) {
+        CordaBytes cb (filepath + file);
+        IndexVisitor visitor (writer, writer.addBlob (file));
+        BlobInspector (cb).visit (visitor);
+    }
+
+    auto path = testing::TempDir() + "blob-inspector-test.idx";
+    {
+        std::ofstream out { path, std::ios::out | std::ios::binary };
+        writer.write (out);
+    }
+
+    {
+        Index index { path };
+
+        EXPECT_EQ (4, index.blobs());
+        EXPECT_EQ ("_Li_", index.blob (2));
+
+        auto postings = index.lookup (
+            "net.corda.blobwriter._Li_", "a[]", "4");
+        ASSERT_EQ (1, postings.size());
+        EXPECT_EQ (2, postings[0].blob);
+        EXPECT_EQ (3, postings[0].ordinal);
+
+        postings = index.lookup (
+            "net.corda.blobwriter.__i_LMis_l__", "x[]{}.value", "ten");
+        ASSERT_EQ (1, postings.size());
+        EXPECT_EQ (3, postings[0].blob);
+        EXPECT_EQ (4, postings[0].ordinal);
+
+        EXPECT_TRUE (index.lookup (
+            "net.corda.blobwriter._Li_", "a[]", "7").empty());
+        EXPECT_TRUE (index.lookup ("nope", "a", "69").empty());
+    }
+
+    std::remove (path.c_str());
+}
+
+/******************************************************************************/
+
+/**
+ * Counts and offsets in the file are checked against its size before
+ * anything is read through them
+ */
+TEST (BlobInspector, indexCorrupt) { // NOLINT
+    using namespace amqp::internal::index;
+
+    IndexWriter writer;
+
+    CordaBytes cb (filepath + "_Li_");
+    IndexVisitor visitor (writer, writer.addBlob ("_Li_"));
+    BlobInspector (cb).visit (visitor);
+
+    std::stringstream ss;
+    writer.write (ss);
+    const auto good = ss.str();
+
+    auto path = testing::TempDir() + "blob-inspector-test-corrupt.idx";
+
+    auto open = [&path](const std::string & bytes_) {
+        {
+            std::ofstream out { path, std::ios::out | std::ios::binary };
+            out << bytes_;
+        }
+        Index index { path };
+    };
+
+    EXPECT_NO_THROW (open (good));
+
+    // truncated within the key table, and within the strings, which
+    // are padded by at most 7 bytes
+    EXPECT_THROW (open (good.substr (0, 40)), std::runtime_error);
+    EXPECT_THROW (open (good.substr (0, good.size() - 8)), std::runtime_error);
+
+    // far more keys than the file could hold, and enough to overflow
+    // if multiplied by the size of an entry
+    auto keys = good;
+    keys.replace (16, 8, "\xff\xff\xff\xff\xff\xff\xff\x0f", 8);
+    EXPECT_THROW (open (keys), std::runtime_error);
+
+    // the first key's string offset
+    auto offset = good;
+    offset.replace (32, 8, "\x00\x00\x00\x00\x00\x00\x01\x00", 8);
+    EXPECT_THROW (open (offset), std::runtime_error);
+
+    // the first key's first posting
+    auto first = good;
+    first.replace (48, 8, "\xff\xff\xff\xff\xff\xff\xff\xff", 8);
+    EXPECT_THROW (open (first), std::runtime_error);
+
+    std::remove (path.c_str());
+}
+
+/******************************************************************************/
+
+/******************************************************************************
+ *
+ * Parallel Tests
+ *
+ ******************************************************************************/
+
+/**
+ * Force even the smallest collections to be split up and make sure the
+ * result is the same as reading the blob in one go
+ */
+void
+parallel (const std::string & file_) {
+    auto path { filepath + file_ } ;
+    CordaBytes cb (path);
+
+    auto expected = BlobInspector (cb).dump();
+
+    for (size_t threads : { 2, 3, 8 }) {
+        EXPECT_EQ (expected, BlobInspector (cb).dump (threads, 1))
+            << file_ << " with " << threads << " threads";
+    }
+}
+
+/******************************************************************************/
+
+TEST (BlobInspector, parallel) { // NOLINT
+    for (const auto & file : {
+            "_i_", "_Li_", "_Ai_", "_Ci_", "_Le_", "_Mis_", "_MiLs_",
+            "_Mi_is__", "_Pls_", "__i_LMis_l__", "_ALd_" })
+    {
+        parallel (file);
+    }
+}
+
+/******************************************************************************/
+
+/******************************************************************************
+ *
+ * Tape Tests
+ *
+ ******************************************************************************/
+
+TEST (BlobInspector, tape) { // NOLINT
+    for (const auto & file : {
+            "_i_", "_l_", "_Oi_", "_Ai_", "_Li_", "_L_i__", "_Le_", "_Mis_", "_MiLs_", "_Mi_is__", "_Pls_", "_e_", "_i_is__",
+            "_Ci_", "__i_LMis_l__", "_ALd_" })
+    {
+        CordaBytes cb (filepath + file);
+
+        EXPECT_EQ (
+            BlobInspector (cb).dump(),
+            BlobInspector (cb, BlobInspector::tape_d).dump()) << file;
+    }
+
+    CordaBytes cb (filepath + "_Le_2");
+
+    EXPECT_THROW (
+        BlobInspector (cb, BlobInspector::tape_d).dump(),
+        std::runtime_error);
+}
+
+/******************************************************************************/
+
+TEST (BlobInspector, tapeFilter) { // NOLINT
+    const auto tape = BlobInspector::tape_d;
+
+    EXPECT_TRUE (matches ("_i_", "a = 69", tape));
+    EXPECT_FALSE (matches ("_i_", "a > 69", tape));
+    EXPECT_TRUE (matches ("_e_", "e = A", tape));
+    EXPECT_TRUE (matches ("_ALd_", "a[][] > 13", tape));
+    EXPECT_TRUE (matches (
+        "__i_LMis_l__",
+        R"(x[]{}.value = "ten" and z.a = 666 and y.x > 10)",
+        tape));
+    EXPECT_FALSE (matches ("__i_LMis_l__", "x[]{}.key = 2", tape));
+}
+
+/******************************************************************************/
+
+/******************************************************************************
+ *
+ * Document Tests
+ *
+ ******************************************************************************/
+
+TEST (BlobInspector, document) { // NOLINT
+    for (const auto & file : {
+            "_i_", "_l_", "_Oi_", "_Ai_", "_Li_", "_L_i__", "_Mis_",
+            "_MiLs_", "_Mi_is__", "_Pls_", "_i_is__", "_Ci_",
+            "__i_LMis_l__", "_ALd_", "_e_", "_Le_" })
+    {
+        CordaBytes cb (filepath + file);
+
+        auto document = BlobInspector (cb).document();
+
+        EXPECT_EQ (
+            BlobInspector (cb).dump(),
+            "{ Parsed : " + document.root().dump() + " }") << file;
+    }
+}
+
+/******************************************************************************/
+
+/******************************************************************************
+ *
+ * Daemon Tests
+ *
+ ******************************************************************************/
+
+namespace {
+
+    std::string
+    slurp (const std::string & file_) {
+        std::ifstream in { filepath + file_, std::ios::in | std::ios::binary };
+        std::stringstream ss;
+        ss << in.rdbuf();
+        return ss.str();
+    }
+
+    int
+    connectTo (const std::string & path_) {
+        sockaddr_un addr { };
+        addr.sun_family = AF_UNIX;
+        strncpy (addr.sun_path, path_.c_str(), sizeof (addr.sun_path) - 1);
+
+        int fd = ::socket (AF_UNIX, SOCK_STREAM, 0);
+
+        if (::connect (fd, reinterpret_cast<sockaddr *> (&addr), sizeof (addr)) != 0) {
+            ::close (fd);
+            return -1;
+        }
+
+        return fd;
+    }
+
+    /**
+     * Send one request and return the status and payload of the response
+     */
+    std::pair<int, std::string>
+    request (int fd_, uint8_t flags_, const std::string & blob_) {
+        std::string out (4, '\0');
+        uint32_t length = blob_.size() + 1;
+        memcpy (out.data(), &length, 4);
+        out += static_cast<char> (flags_);
+        out += blob_;
+
+        EXPECT_EQ (out.size(), ::send (fd_, out.data(), out.size(), 0));
+
+        std::string in (5, '\0');
+        EXPECT_EQ (5, ::recv (fd_, in.data(), 5, MSG_WAITALL));
+        memcpy (&length, in.data(), 4);
+
+        std::string payload (length - 1, '\0');
+        EXPECT_EQ (payload.size(), ::recv (fd_, payload.data(), payload.size(), MSG_WAITALL));
+
+        return { in[4], payload };
+    }
+
+}
+
+/******************************************************************************/
+
+TEST (BlobInspector, daemon) { // NOLINT
+    auto path = "blob-inspector-test-" + std::to_string (::getpid()) + ".sock";
+
+    Daemon daemon (path, 2);
+    std::thread server ([&daemon]() { daemon.serve(); });
+
+    int fd = connectTo (path);
+    ASSERT_LE (0, fd);
+
+    // the same connection serves any number of requests
+    for (int i { 0 } ; i < 3 ; ++i) {
+        auto [status, payload] = request (fd, 0, slurp ("_i_"));
+        EXPECT_EQ (Daemon::ok, status);
+        EXPECT_EQ ("{ Parsed : { a : 69 } }", payload);
+    }
+
+    auto [status, payload] = request (
+        fd, Daemon::tape_f, slurp ("__i_LMis_l__"));
+    EXPECT_EQ (Daemon::ok, status);
+    EXPECT_EQ (BlobInspector (CordaBytes (filepath + "__i_LMis_l__")).dump(), payload);
+
+    {
+        CordaBytes cb (filepath + "_Li_");
+        std::ostringstream expected;
+        BlobInspector (cb).document().write (expected);
+
+        auto [status, payload] = request (fd, Daemon::document_f, slurp ("_Li_"));
+        EXPECT_EQ (Daemon::ok, status);
+        EXPECT_EQ (expected.str(), payload);
+    }
+
+    {
+        auto [status, payload] = request (fd, 0, "not a blob");
+        EXPECT_EQ (Daemon::error, status);
+        EXPECT_EQ ("Not a Corda stream", payload);
+    }
+
+    {
+        // past the header but cut short, which mustn't take the daemon down
+        auto blob = slurp ("_Li_");
+        blob.resize (blob.size() / 2);
+
+        auto [status, payload] = request (fd, 0, blob);
+        EXPECT_EQ (Daemon::error, status);
+        EXPECT_NE ("", payload);
+    }
+
+    // idle connections don't hold a worker, so with both of ours sat on
+    // one each a third is still served
+    int idle[2] { connectTo (path), connectTo (path) };
+    int third = connectTo (path);
+    ASSERT_LE (0, third);
+
+    {
+        auto [status, payload] = request (idle[0], 0, slurp ("_i_"));
+        EXPECT_EQ (Daemon::ok, status);
+    }
+
+    {
+        auto [status, payload] = request (third, 0, slurp ("_i_"));
+        EXPECT_EQ (Daemon::ok, status);
+        EXPECT_EQ ("{ Parsed : { a : 69 } }", payload);
+    }
+
+    ::close (third);
+
+    daemon.stop();
+    server.join();
+
+    // and stopping closed the connections still open
+    char c;
+    EXPECT_EQ (0, ::recv (fd, &c, 1, 0));
+
+    ::close (fd);
+    ::close (idle[0]);
+    ::close (idle[1]);
+}
+
+/******************************************************************************/
+
+/******************************************************************************
+ *
+ * Ingest Tests
+ *
+ ******************************************************************************/
+
+TEST (BlobInspector, ingest) { // NOLINT
+    sVec<std::string> files;
+
+    // more files than the depth so every slot gets reused
+    for (int i { 0 } ; i < 4 ; ++i) {
+        for (const auto & file : { "_i_", "_Li_", "_Mis_", "__i_LMis_l__", "_e_" }) {
+            files.emplace_back (filepath + file);
+        }
+    }
+
+    for (auto backend : { Ingest::automatic_b, Ingest::threads_b }) {
+        Ingest ingest (files, 3, backend);
+        EXPECT_NE (Ingest::automatic_b, ingest.backend());
+
+        size_t seen { 0 };
+
+        ingest.each ([&](size_t i_, const CordaBytes & cb_) {
+            EXPECT_EQ (seen++, i_);
+
+            CordaBytes expected (files[i_]);
+
+            EXPECT_EQ (expected.encoding(), cb_.encoding());
+            EXPECT_EQ (
+                std::string (expected.bytes(), expected.size()),
+                std::string (cb_.bytes(), cb_.size())) << files[i_];
+
+            EXPECT_EQ (BlobInspector (expected).dump(), BlobInspector (cb_).dump());
+
+            return true;
+        });
+
+        EXPECT_EQ (files.size(), seen);
+
+        // stopping early
+        seen = 0;
+        ingest.each ([&](size_t, const CordaBytes &) { return ++seen < 7; });
+        EXPECT_EQ (7, seen);
+    }
+}
+
+/******************************************************************************/
+
+/**
+ * Everything before a file that can't be read is handed over first
+ */
+TEST (BlobInspector, ingestMissing) { // NOLINT
+    sVec<std::string> files {
+        filepath + "_i_", filepath + "_Li_", filepath + "missing", filepath + "_i_" };
+
+    for (auto backend : { Ingest::automatic_b, Ingest::threads_b }) {
+        size_t seen { 0 };
+
+        EXPECT_THROW ( // NOLINT
+            Ingest (files, 2, backend).each ([&](size_t, const CordaBytes &) {
+                ++seen;
+                return true;
+            }),
+            std::runtime_error);
+
+        EXPECT_EQ (2, seen);
+    }
+}
+
+/******************************************************************************/
+
+/******************************************************************************
+ *
+ * Watch Tests
+ *
+ ******************************************************************************/
+
+namespace {
+
+    /**
+     * The next line written to [fd_], empty if none turns up in time
+     */
+    std::string
+    line (int fd_) {
+        std::string rtn;
+        char c;
+
+        for (;;) {
+            pollfd pfd { fd_, POLLIN, 0 };
+
+            if (::poll (&pfd, 1, 5000) != 1 || ::read (fd_, &c, 1) != 1) {
+                return { };
+            }
+
+            if (c == '\n') {
+                return rtn;
+            }
+
+            rtn += c;
+        }
+    }
+
+}
+
+/******************************************************************************/
+
+TEST (BlobInspector, watch) { // NOLINT
+    char dir[] = "/tmp/blob-inspector-watch-XXXXXX";
+    ASSERT_NE (nullptr, ::mkdtemp (dir));
+
+    int out[2];
+    ASSERT_EQ (0, ::pipe (out));
+
+    Watch watch (dir, out[1]);
+    std::thread watcher ([&watch]() { watch.run(); });
+
+    auto copy = [&dir](const std::string & from_, const std::string & to_) {
+        std::ifstream in { filepath + from_, std::ios::binary };
+        std::ofstream (std::string (dir) + "/" + to_, std::ios::binary) << in.rdbuf();
+    };
+
+    copy ("_i_", "one");
+
+    auto first = line (out[0]);
+    EXPECT_EQ (0, first.find (R"({"file":"one","latency_us":)")) << first;
+    EXPECT_NE (std::string::npos, first.find (R"(,"object":{"a":69}})")) << first;
+
+    // written elsewhere and moved in, the temporary name being ignored
+    copy ("_Li_", ".two");
+    ASSERT_EQ (0, ::rename (
+        (std::string (dir) + "/.two").c_str(),
+        (std::string (dir) + "/two").c_str()));
+
+    auto second = line (out[0]);
+    EXPECT_NE (std::string::npos, second.find (
+        R"("file":"two")")) << second;
+    EXPECT_NE (std::string::npos, second.find (
+        R"("object":{"a":[1,2,3,4,5,6]}})")) << second;
+
+    std::ofstream (std::string (dir) + "/three") << "not a blob";
+
+    auto third = line (out[0]);
+    EXPECT_NE (std::string::npos, third.find (R"("error":"Not a Corda stream"})")) << third;
+
+    watch.stop();
+    watcher.join();
+
+    EXPECT_EQ (3, watch.stats().blobs);
+    EXPECT_EQ (1, watch.stats().errors);
+
+    for (auto file : { "one", "two", "three" }) {
+        ::unlink ((std::string (dir) + "/" + file).c_str());
+    }
+    ::rmdir (dir);
+
+    ::close (out[0]);
+    ::close (out[1]);
+}
+
+/******************************************************************************/
+
+/******************************************************************************
+ *
+ * Size Tests
+ *
+ ******************************************************************************/
+
+/**
+ * Every byte of every blob should be accounted for exactly once, with
+ * the collections charged for their elements and the map splitting its
+ * bytes between keys and values
+ */
+TEST (BlobInspector, sizes) { // NOLINT
+    amqp::internal::sizes::SizeVisitor visitor;
+
+    uint64_t bytes { 0 };
+
+    for (const auto & file : { "_i_", "_Mis_", "__i_LMis_l__", "_ALd_" }) {
+        CordaBytes cb (filepath + file);
+
+        visitor.envelope (cb.bytes(), cb.size());
+        BlobInspector (cb, BlobInspector::tape_d).visit (visitor);
+
+        bytes += cb.size() + 8;
+    }
+
+    EXPECT_EQ (4, visitor.blobs());
+    EXPECT_EQ (bytes, visitor.bytes());
+
+    uint64_t self { 0 };
+    for (const auto & stack : visitor.stacks()) {
+        self += stack.second.self;
+    }
+    EXPECT_EQ (bytes, self);
+
+    const auto & stacks = visitor.stacks();
+
+    EXPECT_EQ (32, stacks.at ("header").total);
+    EXPECT_EQ (4, stacks.at ("header").count);
+    // _i_ is described by its own schema and that of __i_LMis_l__
+    EXPECT_EQ (2, stacks.at ("schema;net.corda.blobwriter._i_").count);
+
+    auto & i = stacks.at ("data;net.corda.blobwriter._i_;a");
+    EXPECT_EQ (1, i.count);
+    EXPECT_EQ (i.total, i.self);
+
+    auto & map = stacks.at ("data;net.corda.blobwriter._Mis_;a");
+    auto & keys = stacks.at ("data;net.corda.blobwriter._Mis_;a{};key");
+    auto & values = stacks.at ("data;net.corda.blobwriter._Mis_;a{};value");
+    EXPECT_EQ (map.total, map.self + keys.total + values.total);
+    EXPECT_EQ (keys.count, values.count);
+
+    // the composites nested in a list in a list are all of one type
+    auto & nested = visitor.types().at ("net.corda.blobwriter._i_");
+    EXPECT_LT (1, nested.count);
+
+    std::stringstream folded;
+    visitor.folded (folded);
+
+    uint64_t total { 0 };
+    std::string line;
+    while (std::getline (folded, line)) {
+        auto space = line.rfind (' ');
+        ASSERT_NE (std::string::npos, space) << line;
+        total += std::stoull (line.substr (space + 1));
+    }
+    EXPECT_EQ (bytes, total);
+}
+
+/******************************************************************************/
+
+/******************************************************************************
+ *
+ * Metrics Tests
+ *
+ ******************************************************************************/
+
+TEST (BlobInspector, histogram) { // NOLINT
+    for (uint64_t value : {
+            uint64_t { 0 }, uint64_t { 1 }, uint64_t { 127 }, uint64_t { 128 },
+            uint64_t { 129 }, uint64_t { 1000 }, uint64_t { 123456789 },
+            (uint64_t { 1 } << Histogram::maxBits) - 1 })
+    {
+        auto bucket = Histogram::bucket (value);
+
+        ASSERT_LT (bucket, Histogram::buckets) << value;
+        EXPECT_LE (value, Histogram::highest (bucket)) << value;
+        EXPECT_LE (Histogram::highest (bucket) - value, value / 64) << value;
+
+        if (bucket) {
+            EXPECT_LT (Histogram::highest (bucket - 1), value) << value;
+        }
+    }
+
+    // anything too large is counted in the last bucket
+    EXPECT_EQ (Histogram::buckets - 1, Histogram::bucket (~uint64_t { 0 }));
+
+    Histogram histogram;
+    for (uint64_t us { 1 } ; us <= 1000 ; ++us) {
+        histogram.record (us * 1000);
+    }
+
+    Histogram::Snapshot snapshot;
+    snapshot.add (histogram);
+
+    EXPECT_EQ (1000, snapshot.count);
+    EXPECT_EQ (1000000, snapshot.max);
+    EXPECT_EQ (500500000, snapshot.sum);
+
+    for (double q : { 0.5, 0.9, 0.99, 0.999 }) {
+        double expected = q * 1000000;
+        EXPECT_NEAR (expected, snapshot.quantile (q), expected / 64) << q;
+    }
+
+    EXPECT_EQ (1000000, snapshot.quantile (1.0));
+}
+
+/******************************************************************************/
+
+/**
+ * Blobs decoded on different threads should end up in the same series
+ */
+TEST (BlobInspector, metrics) { // NOLINT
+    Metrics metrics;
+
+    ASSERT_EQ (&metrics, Metrics::installed().get());
+
+    auto decode = [](const char * file_) {
+        CordaBytes cb (filepath + file_);
+        BlobInspector (cb, BlobInspector::tape_d).dump();
+    };
+
+    decode ("_i_");
+
+    std::thread other ([&] {
+        decode ("_i_");
+        decode ("_Li_");
+    });
+    other.join();
+
+    // as is reading one in parallel
+    CordaBytes li (filepath + "_Li_");
+    BlobInspector (li).dump (2, 1);
+
+    CordaBytes bad (filepath + "_Le_2");
+    EXPECT_THROW (BlobInspector (bad, BlobInspector::tape_d).dump(), std::runtime_error);
+
+    std::stringstream out;
+    metrics.write (out);
+
+    auto text = out.str();
+
+    CordaBytes i (filepath + "_i_");
+
+    for (const auto & line : {
+            std::string ("# TYPE corda_blob_decode_seconds summary\n"),
+            std::string ("corda_blob_decodes_total{type=\"net.corda.blobwriter._i_\"} 2\n"),
+            std::string ("corda_blob_decodes_total{type=\"net.corda.blobwriter._Li_\"} 2\n"),
+            "corda_blob_decoded_bytes_total{type=\"net.corda.blobwriter._i_\"} "
+                + std::to_string (2 * (i.size() + 8)) + "\n",
+            std::string ("corda_blob_decode_seconds_count{type=\"net.corda.blobwriter._i_\",phase=\"object\"} 2\n"),
+            std::string ("corda_blob_decode_errors_total 1\n") })
+    {
+        EXPECT_NE (std::string::npos, text.find (line)) << line << text;
+    }
+}
+
+/******************************************************************************/
+
+/**
+ * A thread still recording when the metrics go holds them up rather than
+ * recording into freed memory
+ */
+TEST (BlobInspector, metricsLifetime) { // NOLINT
+    auto metrics = std::make_unique<Metrics>();
+
+    std::atomic<bool> held { false };
+    std::atomic<bool> destroyed { false };
+
+    std::thread recording ([&] {
+        auto handle = Metrics::installed();
+        held = true;
+
+        std::this_thread::sleep_for (std::chrono::milliseconds (50));
+
+        EXPECT_FALSE (destroyed);
+        handle->record ("type", 1, { 1, 2, 3 });
+    });
+
+    while (!held) {
+        std::this_thread::yield();
+    }
+
+    metrics.reset();
+    destroyed = true;
+
+    recording.join();
+
+    EXPECT_FALSE (Metrics::installed());
 }
 
 /******************************************************************************/
@@ -28,7 +28,7 @@ printNode (pn_data_t * d_) {
     std::stringstream ss;
 
     if (pn_data_is_described (d_)) {
-        amqp::internal::AMQPDescriptorRegistory[22UL]->read (d_, ss);
+        amqp::internal::descriptorFor (22UL)->read (d_, ss);
     }
 
     std::cout << ss.str() << std::endl;
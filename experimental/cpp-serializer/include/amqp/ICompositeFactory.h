@@ -23,6 +23,12 @@ namespace amqp {
 
             virtual void process (const SchemaType &) = 0;
 
+            /**
+             * Build readers only for the type with the given descriptor
+             * and those it depends upon
+             */
+            virtual void process (const SchemaType &, const std::string &) = 0;
+
             virtual const std::shared_ptr<ReaderType> byType (const std::string &) = 0;
             virtual const std::shared_ptr<ReaderType> byDescriptor (const std::string &) = 0;
     };
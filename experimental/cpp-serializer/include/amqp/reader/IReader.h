@@ -5,6 +5,8 @@
 #include <any>
 
 #include "amqp/AMQPDescribed.h"
+#include "amqp/reader/Name.h"
+#include "amqp/reader/IVisitor.h"
 
 #include "amqp/schema/described-types/Schema.h"
 
@@ -33,6 +35,12 @@ namespace amqp::reader {
         public :
             virtual std::string dump() const = 0;
 
+            /**
+             * Append the JSON for this value to [out_], letting a whole
+             * tree be rendered into a single buffer
+             */
+            virtual void dumpTo (std::string & out_) const = 0;
+
             virtual ~IValue() = default;
     };
 
@@ -60,7 +68,7 @@ namespace amqp::reader {
             virtual std::string readString (pn_data_t *) const = 0;
 
             virtual std::unique_ptr<IValue> dump(
-                    const std::string &,
+                    Name,
                     pn_data_t *,
                     const SchemaType &) const = 0;
 
@@ -68,6 +76,11 @@ namespace amqp::reader {
                     pn_data_t *,
                     const SchemaType &) const = 0;
 
+            virtual void visit (
+                    pn_data_t *,
+                    const SchemaType &,
+                    IVisitor &) const = 0;
+
     };
 
 }
@@ -0,0 +1,71 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+/******************************************************************************
+ *
+ * class amqp::reader::IVisitor
+ *
+ ******************************************************************************/
+
+/**
+ * Where [IValue] gives us a fully materialised tree of the values within
+ * a blob, an [IVisitor] is driven directly by the readers as they walk the
+ * proton tree. Nothing is allocated on behalf of the consumer, it sees
+ * a stream of typed events in the order they appear in the blob.
+ *
+ * Properties of a composite are announced with [property] immediately
+ * before their value. Elements of lists have no name, and the entries of
+ * a map alternate key, value, key, value...
+ *
+ * A visitor that has seen enough of a blob can say so through [halted],
+ * the readers check it between values and step over whatever remains
+ * without reading it.
+ *
+ * A value that isn't there, a property a newer version of a class added
+ * being read from a blob written with an older one say, comes as [null].
+ * A visitor with nowhere to record that can leave it at the default of
+ * ignoring it.
+ *
+ * When reading from a tape the readers also say, through [encoded], how
+ * many bytes the value they're about to announce occupies on the wire,
+ * constructor included. The elements of an array share one constructor
+ * so aren't sized individually. Most visitors have no use for this.
+ */
+namespace amqp::reader {
+
+    class IVisitor {
+        public :
+            virtual ~IVisitor() = default;
+
+            virtual void property (const std::string &) = 0;
+
+            virtual void beginComposite (const std::string &) = 0;
+            virtual void endComposite() = 0;
+
+            virtual void beginList (size_t) = 0;
+            virtual void endList() = 0;
+
+            virtual void beginMap (size_t) = 0;
+            virtual void endMap() = 0;
+
+            virtual void value (bool) = 0;
+            virtual void value (int32_t) = 0;
+            virtual void value (int64_t) = 0;
+            virtual void value (double) = 0;
+            virtual void value (const std::string &) = 0;
+
+            virtual void null() { }
+
+            virtual bool halted() const { return false; }
+
+            virtual void encoded (size_t) { }
+    };
+
+}
+
+/******************************************************************************/
@@ -0,0 +1,42 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <string>
+
+/******************************************************************************
+ *
+ * class amqp::reader::Name
+ *
+ ******************************************************************************/
+
+/**
+ * The name of a property as held by a decoded value. Names are interned,
+ * each distinct name being stored once for the life of the process, so
+ * a value only holds a pointer to its name however many instances of
+ * the type it belongs to are decoded.
+ *
+ * Building a [Name] from a string looks it up in the pool so the readers
+ * do that once, when they're made, and hand the [Name] itself to every
+ * value they read.
+ */
+namespace amqp::reader {
+
+    class Name {
+        private :
+            const std::string * m_name;
+
+        public :
+            Name (const std::string &); // NOLINT
+            Name (const char *); // NOLINT
+
+            const std::string & str() const { return *m_name; }
+
+            bool operator == (const Name & rhs_) const {
+                return m_name == rhs_.m_name;
+            }
+    };
+
+}
+
+/******************************************************************************/
@@ -0,0 +1,163 @@
+#pragma once
+
+/******************************************************************************
+ *
+ * libcordaamqp
+ *
+ * A C interface onto the decoder so it can be embedded in any process that
+ * can call C, Python through ctypes or cffi, Go through cgo, and so on.
+ *
+ * The interface is kept stable. Nothing crosses it but C types, nothing
+ * allocated on one side is freed on the other, and no exception escapes
+ * it. Structures passed in carry their own size so members can be added
+ * to the end of them without breaking callers built against an older
+ * version of this header.
+ *
+ * A decoder is not thread safe, use one per thread. The caches behind
+ * them are shared by every decoder in the process.
+ *
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__GNUC__)
+#   define CORDAAMQP_API __attribute__((visibility("default")))
+#else
+#   define CORDAAMQP_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************/
+
+/**
+ * Bumped whenever a change to this interface would break an existing caller
+ */
+#define CORDAAMQP_ABI_VERSION 1
+
+typedef struct cordaamqp_decoder cordaamqp_decoder;
+
+typedef enum {
+    CORDAAMQP_OK    = 0,
+    CORDAAMQP_ERROR = 1
+} cordaamqp_status;
+
+/**
+ * Flags for [cordaamqp_decoder_create]
+ */
+enum {
+    /* read the object through a structural index of its encoding
+     * rather than having proton decode all of it */
+    CORDAAMQP_TAPE = 0x01
+};
+
+/**
+ * The events a blob is walked as, in the order they appear in it. See
+ * amqp/reader/IVisitor.h. Strings are not null terminated and are only
+ * valid for the duration of the call. Any callback may be left null.
+ *
+ * [size] must be set to sizeof (cordaamqp_visitor).
+ */
+typedef struct {
+    size_t size;
+
+    void * context;
+
+    void (*property)(void * context, const char * name, size_t len);
+
+    void (*begin_composite)(void * context, const char * type, size_t len);
+    void (*end_composite)(void * context);
+
+    void (*begin_list)(void * context, size_t count);
+    void (*end_list)(void * context);
+
+    void (*begin_map)(void * context, size_t count);
+    void (*end_map)(void * context);
+
+    void (*value_bool)(void * context, int value);
+    void (*value_int)(void * context, int32_t value);
+    void (*value_long)(void * context, int64_t value);
+    void (*value_double)(void * context, double value);
+    void (*value_string)(void * context, const char * value, size_t len);
+
+    /* return non zero once the rest of the blob isn't wanted */
+    int (*halted)(void * context);
+
+    /* a value that isn't there, e.g. a property the blob's version of
+     * its class doesn't have */
+    void (*value_null)(void * context);
+} cordaamqp_visitor;
+
+/******************************************************************************/
+
+/**
+ * The [CORDAAMQP_ABI_VERSION] the library was built with
+ */
+CORDAAMQP_API unsigned cordaamqp_abi_version (void);
+
+/**
+ * Null only if memory is exhausted
+ */
+CORDAAMQP_API cordaamqp_decoder * cordaamqp_decoder_create (unsigned flags);
+
+CORDAAMQP_API void cordaamqp_decoder_destroy (cordaamqp_decoder *);
+
+/**
+ * Read blobs written with other versions of a class as the versions in
+ * the schema of [blob], see --schema in the README. A null blob goes back
+ * to reading blobs as they were written.
+ */
+CORDAAMQP_API cordaamqp_status cordaamqp_decoder_set_schema (
+    cordaamqp_decoder *,
+    const char * blob,
+    size_t size);
+
+/**
+ * Why the last call on the decoder failed, null terminated, owned by the
+ * decoder and valid until the next call on it
+ */
+CORDAAMQP_API const char * cordaamqp_decoder_error (const cordaamqp_decoder *);
+
+/**
+ * Decode a blob, laid out as a blob file with the Corda header first, to
+ * JSON. [json] is null terminated, owned by the decoder and valid until
+ * the next call on it.
+ */
+CORDAAMQP_API cordaamqp_status cordaamqp_decode_json (
+    cordaamqp_decoder *,
+    const char * blob,
+    size_t size,
+    const char ** json,
+    size_t * len);
+
+/**
+ * Walk a blob calling back through [visitor]
+ */
+CORDAAMQP_API cordaamqp_status cordaamqp_decode_visit (
+    cordaamqp_decoder *,
+    const char * blob,
+    size_t size,
+    const cordaamqp_visitor * visitor);
+
+/**
+ * The number of type definitions whose readers are cached, shared by
+ * every decoder in the process
+ */
+CORDAAMQP_API size_t cordaamqp_cache_size (void);
+
+/**
+ * Drop every cached reader. Decoders can carry on being used, the
+ * readers they need being built again.
+ */
+CORDAAMQP_API void cordaamqp_cache_clear (void);
+
+/******************************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+/******************************************************************************/
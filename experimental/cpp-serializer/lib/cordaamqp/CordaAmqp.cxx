@@ -0,0 +1,273 @@
+#include "cordaamqp.h"
+
+#include <new>
+#include <memory>
+#include <string>
+#include <cstring>
+#include <sstream>
+#include <algorithm>
+#include <stdexcept>
+
+#include "amqp/AMQPSectionId.h"
+#include "amqp/ReaderCache.h"
+#include "amqp/reader/IVisitor.h"
+
+#include "CordaBytes.h"
+#include "BlobInspector.h"
+
+/******************************************************************************/
+
+struct cordaamqp_decoder {
+    BlobInspector::Decoder decoder;
+
+    std::unique_ptr<LocalSchema> local;
+
+    /**
+     * Handed back to the caller so must live until the next call
+     */
+    std::string output;
+    std::string error;
+};
+
+/******************************************************************************/
+
+namespace {
+
+    /**
+     * Drive the caller's callbacks from our readers. Only the part of the
+     * table the caller knew about when they were built is copied, anything
+     * added since being left null.
+     */
+    class CallbackVisitor : public amqp::reader::IVisitor {
+        private :
+            cordaamqp_visitor m_table;
+
+        public :
+            explicit CallbackVisitor (const cordaamqp_visitor & table_) {
+                memset (&m_table, 0, sizeof (m_table));
+                memcpy (&m_table, &table_, std::min (table_.size, sizeof (m_table)));
+            }
+
+            void property (const std::string & name_) override {
+                if (m_table.property) {
+                    m_table.property (m_table.context, name_.data(), name_.size());
+                }
+            }
+
+            void beginComposite (const std::string & type_) override {
+                if (m_table.begin_composite) {
+                    m_table.begin_composite (m_table.context, type_.data(), type_.size());
+                }
+            }
+
+            void endComposite() override {
+                if (m_table.end_composite) m_table.end_composite (m_table.context);
+            }
+
+            void beginList (size_t count_) override {
+                if (m_table.begin_list) m_table.begin_list (m_table.context, count_);
+            }
+
+            void endList() override {
+                if (m_table.end_list) m_table.end_list (m_table.context);
+            }
+
+            void beginMap (size_t count_) override {
+                if (m_table.begin_map) m_table.begin_map (m_table.context, count_);
+            }
+
+            void endMap() override {
+                if (m_table.end_map) m_table.end_map (m_table.context);
+            }
+
+            void value (bool value_) override {
+                if (m_table.value_bool) m_table.value_bool (m_table.context, value_);
+            }
+
+            void value (int32_t value_) override {
+                if (m_table.value_int) m_table.value_int (m_table.context, value_);
+            }
+
+            void value (int64_t value_) override {
+                if (m_table.value_long) m_table.value_long (m_table.context, value_);
+            }
+
+            void value (double value_) override {
+                if (m_table.value_double) m_table.value_double (m_table.context, value_);
+            }
+
+            void value (const std::string & value_) override {
+                if (m_table.value_string) {
+                    m_table.value_string (m_table.context, value_.data(), value_.size());
+                }
+            }
+
+            void null() override {
+                if (m_table.value_null) m_table.value_null (m_table.context);
+            }
+
+            bool halted() const override {
+                return m_table.halted && m_table.halted (m_table.context);
+            }
+    };
+
+    /**
+     * Run [f_] with everything it throws turned into an error on the
+     * decoder, nothing being allowed to unwind into C
+     */
+    template<class F>
+    cordaamqp_status
+    guarded (cordaamqp_decoder * decoder_, F f_) {
+        if (!decoder_) {
+            return CORDAAMQP_ERROR;
+        }
+
+        decoder_->error.clear();
+
+        try {
+            f_();
+            return CORDAAMQP_OK;
+        } catch (const std::exception & e) {
+            decoder_->error = e.what();
+        } catch (...) {
+            decoder_->error = "Unknown error";
+        }
+
+        return CORDAAMQP_ERROR;
+    }
+
+    /**
+     * Copy a blob the caller owns, checking it's one we can read
+     */
+    std::unique_ptr<CordaBytes>
+    bytes (const char * blob_, size_t size_) {
+        if (!blob_) {
+            throw std::runtime_error ("No blob");
+        }
+
+        auto cb = std::make_unique<CordaBytes> (blob_, size_);
+
+        if (cb->encoding() != amqp::DATA_AND_STOP) {
+            std::stringstream ss;
+            ss << "BAD ENCODING " << cb->encoding() << " != " << amqp::DATA_AND_STOP;
+            throw std::runtime_error (ss.str());
+        }
+
+        return cb;
+    }
+
+}
+
+/******************************************************************************/
+
+unsigned
+cordaamqp_abi_version() {
+    return CORDAAMQP_ABI_VERSION;
+}
+
+/******************************************************************************/
+
+cordaamqp_decoder *
+cordaamqp_decoder_create (unsigned flags_) {
+    auto decoder = new (std::nothrow) cordaamqp_decoder;
+
+    if (decoder) {
+        decoder->decoder = (flags_ & CORDAAMQP_TAPE)
+            ? BlobInspector::tape_d
+            : BlobInspector::proton_d;
+    }
+
+    return decoder;
+}
+
+/******************************************************************************/
+
+void
+cordaamqp_decoder_destroy (cordaamqp_decoder * decoder_) {
+    delete decoder_;
+}
+
+/******************************************************************************/
+
+cordaamqp_status
+cordaamqp_decoder_set_schema (
+    cordaamqp_decoder * decoder_,
+    const char * blob_,
+    size_t size_
+) {
+    return guarded (decoder_, [&]() {
+        if (!blob_) {
+            decoder_->local.reset();
+            return;
+        }
+
+        decoder_->local = std::make_unique<LocalSchema> (*bytes (blob_, size_));
+    });
+}
+
+/******************************************************************************/
+
+const char *
+cordaamqp_decoder_error (const cordaamqp_decoder * decoder_) {
+    return decoder_ ? decoder_->error.c_str() : "No decoder";
+}
+
+/******************************************************************************/
+
+cordaamqp_status
+cordaamqp_decode_json (
+    cordaamqp_decoder * decoder_,
+    const char * blob_,
+    size_t size_,
+    const char ** json_,
+    size_t * len_
+) {
+    return guarded (decoder_, [&]() {
+        auto cb = bytes (blob_, size_);
+
+        decoder_->output = BlobInspector (
+            *cb, decoder_->decoder, decoder_->local.get()).dump();
+
+        *json_ = decoder_->output.c_str();
+        *len_ = decoder_->output.size();
+    });
+}
+
+/******************************************************************************/
+
+cordaamqp_status
+cordaamqp_decode_visit (
+    cordaamqp_decoder * decoder_,
+    const char * blob_,
+    size_t size_,
+    const cordaamqp_visitor * visitor_
+) {
+    return guarded (decoder_, [&]() {
+        if (!visitor_) {
+            throw std::runtime_error ("No visitor");
+        }
+
+        auto cb = bytes (blob_, size_);
+
+        CallbackVisitor visitor (*visitor_);
+
+        BlobInspector (
+            *cb, decoder_->decoder, decoder_->local.get()).visit (visitor);
+    });
+}
+
+/******************************************************************************/
+
+size_t
+cordaamqp_cache_size() {
+    return amqp::internal::ReaderCache::instance().size();
+}
+
+/******************************************************************************/
+
+void
+cordaamqp_cache_clear() {
+    amqp::internal::ReaderCache::instance().clear();
+}
+
+/******************************************************************************/
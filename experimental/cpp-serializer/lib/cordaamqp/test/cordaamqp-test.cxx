@@ -0,0 +1,223 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include <fstream>
+
+#include "cordaamqp.h"
+
+const std::string filepath ("../../../bin/test-files/"); // NOLINT
+
+/******************************************************************************/
+
+namespace {
+
+    std::string
+    slurp (const std::string & file_) {
+        std::ifstream in { filepath + file_, std::ios::in | std::ios::binary };
+        std::stringstream ss;
+        ss << in.rdbuf();
+        return ss.str();
+    }
+
+    /**
+     * Record the events as a string, stopping after [limit] values
+     */
+    struct Events {
+        std::string events;
+        int values { 0 };
+        int limit { 1000 };
+    };
+
+    Events &
+    events (void * context_) {
+        return *static_cast<Events *> (context_);
+    }
+
+    cordaamqp_visitor
+    recorder (Events & events_) {
+        cordaamqp_visitor visitor { };
+        visitor.size = sizeof (visitor);
+        visitor.context = &events_;
+
+        visitor.property = [](void * c_, const char * n_, size_t l_) {
+            events (c_).events += std::string (n_, l_) + ":";
+        };
+        visitor.begin_composite = [](void * c_, const char *, size_t) {
+            events (c_).events += "{";
+        };
+        visitor.end_composite = [](void * c_) { events (c_).events += "}"; };
+        visitor.begin_list = [](void * c_, size_t n_) {
+            events (c_).events += "[" + std::to_string (n_) + "|";
+        };
+        visitor.end_list = [](void * c_) { events (c_).events += "]"; };
+        visitor.value_int = [](void * c_, int32_t v_) {
+            events (c_).events += std::to_string (v_) + ",";
+            ++events (c_).values;
+        };
+        visitor.halted = [](void * c_) {
+            return events (c_).values >= events (c_).limit ? 1 : 0;
+        };
+
+        return visitor;
+    }
+
+}
+
+/******************************************************************************/
+
+TEST (CordaAmqp, json) { // NOLINT
+    EXPECT_EQ (CORDAAMQP_ABI_VERSION, cordaamqp_abi_version());
+
+    for (unsigned flags : { 0u, unsigned (CORDAAMQP_TAPE) }) {
+        auto decoder = cordaamqp_decoder_create (flags);
+        ASSERT_NE (nullptr, decoder);
+
+        auto blob = slurp ("_Li_");
+
+        const char * json { nullptr };
+        size_t len { 0 };
+
+        ASSERT_EQ (CORDAAMQP_OK, cordaamqp_decode_json (
+            decoder, blob.data(), blob.size(), &json, &len));
+
+        EXPECT_EQ ("{ Parsed : { a : [ 1, 2, 3, 4, 5, 6 ] } }", std::string (json, len));
+        EXPECT_EQ (len, strlen (json));
+
+        cordaamqp_decoder_destroy (decoder);
+    }
+}
+
+/******************************************************************************/
+
+TEST (CordaAmqp, visit) { // NOLINT
+    auto decoder = cordaamqp_decoder_create (0);
+    auto blob = slurp ("_Li_");
+
+    Events all;
+    auto visitor = recorder (all);
+
+    ASSERT_EQ (CORDAAMQP_OK, cordaamqp_decode_visit (
+        decoder, blob.data(), blob.size(), &visitor));
+
+    EXPECT_EQ ("{a:[6|1,2,3,4,5,6,]}", all.events);
+
+    // a caller built against an older header that didn't know about
+    // [halted] never has it called
+    Events some;
+    some.limit = 2;
+    visitor = recorder (some);
+    visitor.size = offsetof (cordaamqp_visitor, halted);
+
+    ASSERT_EQ (CORDAAMQP_OK, cordaamqp_decode_visit (
+        decoder, blob.data(), blob.size(), &visitor));
+    EXPECT_EQ (6, some.values);
+
+    some = Events { };
+    some.limit = 2;
+    visitor = recorder (some);
+
+    ASSERT_EQ (CORDAAMQP_OK, cordaamqp_decode_visit (
+        decoder, blob.data(), blob.size(), &visitor));
+    EXPECT_EQ (2, some.values);
+
+    cordaamqp_decoder_destroy (decoder);
+}
+
+/******************************************************************************/
+
+TEST (CordaAmqp, errors) { // NOLINT
+    auto decoder = cordaamqp_decoder_create (0);
+
+    const char * json { nullptr };
+    size_t len { 0 };
+
+    std::string garbage ("not a blob");
+
+    EXPECT_EQ (CORDAAMQP_ERROR, cordaamqp_decode_json (
+        decoder, garbage.data(), garbage.size(), &json, &len));
+    EXPECT_STREQ ("Not a Corda stream", cordaamqp_decoder_error (decoder));
+
+    EXPECT_EQ (CORDAAMQP_ERROR, cordaamqp_decode_visit (
+        decoder, garbage.data(), garbage.size(), nullptr));
+    EXPECT_STREQ ("No visitor", cordaamqp_decoder_error (decoder));
+
+    // the decoder carries on working after a failure
+    auto blob = slurp ("_i_");
+    EXPECT_EQ (CORDAAMQP_OK, cordaamqp_decode_json (
+        decoder, blob.data(), blob.size(), &json, &len));
+    EXPECT_STREQ ("", cordaamqp_decoder_error (decoder));
+
+    EXPECT_EQ (CORDAAMQP_ERROR, cordaamqp_decode_json (
+        nullptr, blob.data(), blob.size(), &json, &len));
+
+    cordaamqp_decoder_destroy (decoder);
+}
+
+/******************************************************************************/
+
+TEST (CordaAmqp, cache) { // NOLINT
+    auto decoder = cordaamqp_decoder_create (0);
+    auto blob = slurp ("_i_");
+
+    const char * json { nullptr };
+    size_t len { 0 };
+
+    cordaamqp_decode_json (decoder, blob.data(), blob.size(), &json, &len);
+    EXPECT_LT (0, cordaamqp_cache_size());
+
+    cordaamqp_cache_clear();
+    EXPECT_EQ (0, cordaamqp_cache_size());
+
+    // readers are simply built again
+    ASSERT_EQ (CORDAAMQP_OK, cordaamqp_decode_json (
+        decoder, blob.data(), blob.size(), &json, &len));
+    EXPECT_EQ ("{ Parsed : { a : 69 } }", std::string (json, len));
+
+    cordaamqp_decoder_destroy (decoder);
+}
+
+/******************************************************************************/
+
+/**
+ * Blobs that get past the header but aren't what they claim to be, or are
+ * cut short, are errors whichever way we're reading them
+ */
+TEST (CordaAmqp, malformed) { // NOLINT
+    auto whole = slurp ("_Li_");
+
+    std::vector<std::string> blobs {
+        // a described type with a null descriptor and nothing after it
+        std::string ("corda\x01\x00\x00\x00\x40", 10),
+        // a described type whose descriptor isn't one we know
+        std::string ("corda\x01\x00\x00\x00\x53\x7f\x40", 12),
+        whole.substr (0, whole.size() / 2),
+        whole.substr (0, whole.size() - 1)
+    };
+
+    for (auto flags : { 0u, unsigned (CORDAAMQP_TAPE) }) {
+        auto decoder = cordaamqp_decoder_create (flags);
+
+        for (const auto & blob : blobs) {
+            const char * json { nullptr };
+            size_t len { 0 };
+
+            EXPECT_EQ (CORDAAMQP_ERROR, cordaamqp_decode_json (
+                decoder, blob.data(), blob.size(), &json, &len));
+            EXPECT_STRNE ("", cordaamqp_decoder_error (decoder));
+        }
+
+        // and none of that has broken the decoder
+        const char * json { nullptr };
+        size_t len { 0 };
+
+        ASSERT_EQ (CORDAAMQP_OK, cordaamqp_decode_json (
+            decoder, whole.data(), whole.size(), &json, &len));
+        EXPECT_EQ ("{ Parsed : { a : [ 1, 2, 3, 4, 5, 6 ] } }", std::string (json, len));
+
+        cordaamqp_decoder_destroy (decoder);
+    }
+}
+
+/******************************************************************************/
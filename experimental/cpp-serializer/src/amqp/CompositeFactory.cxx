@@ -1,8 +1,7 @@
 #include "CompositeFactory.h"
 
-#include <set>
 #include <vector>
-#include <iostream>
+#include <sstream>
 #include <algorithm>
 #include <functional>
 
@@ -13,8 +12,14 @@
 #include "amqp/reader/IReader.h"
 #include "amqp/reader/PropertyReader.h"
 
+#include "ReaderCache.h"
+#include "parallel/Run.h"
+#include "evolution/Plan.h"
+#include "trace/Trace.h"
+
 #include "reader/Reader.h"
 #include "reader/CompositeReader.h"
+#include "reader/EvolvedReader.h"
 #include "reader/RestrictedReader.h"
 #include "reader/restricted-readers/MapReader.h"
 #include "reader/restricted-readers/ListReader.h"
@@ -63,6 +68,91 @@ namespace {
         }
     }
 
+/**
+ * The names of the types [type_] refers to, those of a composite's fields
+ * or what a restricted type is a collection of. Primitives included.
+ */
+    sVec<std::string>
+    dependencies (const amqp::internal::schema::AMQPTypeNotation & type_) {
+        using namespace amqp::internal::schema;
+
+        sVec<std::string> rtn;
+
+        if (type_.type() == AMQPTypeNotation::composite_t) {
+            for (const auto & field : dynamic_cast<const Composite &> (type_)) {
+                rtn.push_back (field->resolvedType());
+            }
+
+            return rtn;
+        }
+
+        const auto & restricted = dynamic_cast<const Restricted &> (type_);
+
+        switch (restricted.restrictedType()) {
+            case Restricted::RestrictedTypes::list_t : {
+                rtn.push_back (dynamic_cast<const List &> (restricted).listOf());
+                break;
+            }
+            case Restricted::RestrictedTypes::array_t : {
+                rtn.push_back (dynamic_cast<const Array &> (restricted).arrayOf());
+                break;
+            }
+            case Restricted::RestrictedTypes::map_t : {
+                auto types = dynamic_cast<const Map &> (restricted).mapOf();
+                rtn.push_back (types.first);
+                rtn.push_back (types.second);
+                break;
+            }
+            case Restricted::RestrictedTypes::enum_t : {
+                break;
+            }
+        }
+
+        return rtn;
+    }
+
+/**
+ * Builds the canonical form of a definition, each string followed by a
+ * separator so ("ab", "c") and ("a", "bc") differ
+ */
+    class Definition {
+        private :
+            std::string m_bytes;
+
+        public :
+            void add (const std::string & str_) {
+                m_bytes += str_;
+                m_bytes += static_cast<char> (0xFF);
+            }
+
+            void add (uint64_t value_) {
+                for (int i { 0 } ; i < 8 ; ++i) {
+                    m_bytes += static_cast<char> (value_ >> (i * 8));
+                }
+            }
+
+            std::string value() { return std::move (m_bytes); }
+    };
+
+/**
+ * The reader shared by the whole process for [key_], building it with
+ * [f_] if there isn't one yet. The caller keeps hold of what it's given
+ * so this copies the cached reader just the once, on the way out.
+ */
+    std::shared_ptr<amqp::internal::reader::Reader>
+    shared (
+            const amqp::internal::ReaderCache::Key & key_,
+            const std::function<std::shared_ptr<amqp::internal::reader::Reader>(void)> & f_
+    ) {
+        auto & cache = amqp::internal::ReaderCache::instance();
+
+        if (const auto & reader = cache.find (key_)) {
+            return reader;
+        }
+
+        return cache.insert (key_, f_());
+    }
+
 }
 
 /******************************************************************************
@@ -71,14 +161,32 @@ namespace {
  *
  ******************************************************************************/
 
+amqp::internal::
+CompositeFactory::CompositeFactory (
+    size_t threads_,
+    const schema::Schema * local_
+) : m_threads (std::max<size_t> (threads_, 1))
+{
+    if (!local_) return;
+
+    for (const auto & level : *local_) {
+        for (const auto & type : level) {
+            if (type->type() == schema::AMQPTypeNotation::composite_t) {
+                m_local[type->name()] = &dynamic_cast<const schema::Composite &> (*type);
+            }
+        }
+    }
+}
+
+/******************************************************************************/
+
 /**
  *
  * Walk through the types in a Schema and produce readers for them.
  *
- * We are making the assumption that the contents of [schema_]
- * are strictly ordered by dependency so we can construct types
- * as we go without needing to provide look ahead for types
- * we haven't built yet.
+ * Types are built in order of their dependencies, see [processLevels],
+ * so we can construct types as we go without needing to provide look
+ * ahead for types we haven't built yet.
  *
  */
 void
@@ -86,12 +194,172 @@ amqp::internal::
 CompositeFactory::process (const SchemaType & schema_) {
     DBG ("process schema" << std::endl);
 
-    for (const auto & i : dynamic_cast<const schema::Schema &>(schema_)) {
+    processLevels (dynamic_cast<const schema::Schema &>(schema_), nullptr);
+}
+
+/******************************************************************************/
+
+/**
+ * As above but skipping any type the one with [descriptor_] can't reach.
+ * Envelopes routinely carry types the object itself never refers to,
+ * those named as an interface it provides for example, and there's no
+ * point building readers that will never be asked to read anything.
+ */
+void
+amqp::internal::
+CompositeFactory::process (
+    const SchemaType & schema_,
+    const std::string & descriptor_
+) {
+    DBG ("process schema from " << descriptor_ << std::endl);
+
+    const auto & schema = dynamic_cast<const schema::Schema &>(schema_);
+    auto types = reachable (schema, descriptor_);
+
+    processLevels (schema, &types);
+}
+
+/******************************************************************************/
+
+/**
+ * Build the readers a level at a time, where a type's level is one more
+ * than the deepest of the types it depends upon. Nothing in a level
+ * depends on anything else in it so its types can be built in any order,
+ * or all at once, as long as we wait for one level to finish before
+ * starting on the next. How long a wide schema takes to build is then
+ * down to how deep it is rather than how many types it has.
+ *
+ * The schema's own grouping of its types is close to this but isn't
+ * guaranteed to keep a type out of the same level as, or a level below,
+ * something it depends upon, so we work the levels out for ourselves.
+ *
+ * When [types_] is set only the types it names are built.
+ */
+void
+amqp::internal::
+CompositeFactory::processLevels (
+    const schema::Schema & schema_,
+    const std::set<std::string> * types_
+) {
+    trace::Span span ("CompositeFactory::process");
+
+    sVec<const schema::AMQPTypeNotation *> todo;
+    std::map<std::string, const schema::AMQPTypeNotation *> byName;
+
+    for (const auto & level : schema_) {
+        for (const auto & type : level) {
+            if (!types_ || types_->find (type->name()) != types_->end()) {
+                todo.push_back (type.get());
+                byName[type->name()] = type.get();
+            }
+        }
+    }
+
+    std::map<std::string, size_t> depths;
+
+    std::function<size_t(const schema::AMQPTypeNotation &)> depth =
+        [&](const schema::AMQPTypeNotation & type_) -> size_t
+    {
+        auto it = depths.find (type_.name());
+        if (it != depths.end()) {
+            return it->second;
+        }
+
+        // seed it so a badly formed schema can't send us round in circles
+        depths[type_.name()] = 0;
+
+        size_t rtn { 0 };
+        for (const auto & dependency : dependencies (type_)) {
+            auto d = byName.find (dependency);
+            if (d != byName.end()) {
+                rtn = std::max (rtn, depth (*d->second) + 1);
+            }
+        }
+
+        return depths[type_.name()] = rtn;
+    };
+
+    sVec<sVec<const schema::AMQPTypeNotation *>> levels;
+
+    for (const auto * type : todo) {
+        auto level = depth (*type);
+
+        if (levels.size() <= level) {
+            levels.resize (level + 1);
+        }
+
+        levels[level].push_back (type);
+    }
+
+    for (const auto & level : levels) {
+        if (m_threads == 1 || level.size() < 2) {
+            for (const auto * type : level) {
+                process (*type);
+            }
+            continue;
+        }
+
+        sVec<std::function<void()>> tasks;
+        tasks.reserve (level.size());
+
+        for (const auto * type : level) {
+            tasks.emplace_back ([this, type]() { process (*type); });
+        }
+
+        parallel::run (tasks, m_threads);
+    }
+}
+
+/******************************************************************************/
+
+/**
+ * The names of the types in [schema_] that the one with [descriptor_]
+ * refers to through its fields or, for restricted types, what they're
+ * a collection of, followed transitively and including itself.
+ * Primitives aren't in the schema so never appear.
+ */
+std::set<std::string>
+amqp::internal::
+CompositeFactory::reachable (
+    const schema::Schema & schema_,
+    const std::string & descriptor_
+) {
+    std::map<std::string, const schema::AMQPTypeNotation *> byName;
+    const schema::AMQPTypeNotation * root { nullptr };
+
+    for (const auto & i : schema_) {
         for (const auto & j : i) {
-            process (*j);
-            m_readersByDescriptor[j->descriptor()] = m_readersByType[j->name()];
+            byName[j->name()] = j.get();
+
+            if (j->descriptor() == descriptor_) {
+                root = j.get();
+            }
+        }
+    }
+
+    if (!root) {
+        std::stringstream ss;
+        ss << "No type in the schema has the descriptor " << descriptor_;
+        throw std::runtime_error (ss.str());
+    }
+
+    std::set<std::string> rtn { root->name() };
+    sVec<const schema::AMQPTypeNotation *> pending { root };
+
+    while (!pending.empty()) {
+        const auto * type = pending.back();
+        pending.pop_back();
+
+        for (const auto & dependency : dependencies (*type)) {
+            auto it = byName.find (dependency);
+
+            if (it != byName.end() && rtn.insert (dependency).second) {
+                pending.push_back (it->second);
+            }
         }
     }
+
+    return rtn;
 }
 
 /******************************************************************************/
@@ -103,19 +371,127 @@ CompositeFactory::process (
 {
     DBG ("process::" << schema_.name() << std::endl);
 
-    return computeIfAbsent<reader::Reader> (
-        m_readersByType,
-        schema_.name(),
-        [& schema_, this] () -> std::shared_ptr<reader::Reader> {
-            switch (schema_.type()) {
-                case schema::AMQPTypeNotation::composite_t : {
-                    return processComposite (schema_);
-                }
-                case schema::AMQPTypeNotation::restricted_t : {
-                    return processRestricted (schema_);
+    if (auto reader = lookup (schema_.name())) {
+        return reader;
+    }
+
+    auto key = ReaderCache::Key { schema_.name(), definition (schema_) };
+
+    // Build without holding the lock, the readers for the types we
+    // depend upon are looked up as we go
+    auto reader = shared (key, [&schema_, this]() {
+        trace::Span span ("CompositeFactory::build", &schema_.name());
+
+        switch (schema_.type()) {
+            case schema::AMQPTypeNotation::composite_t : {
+                auto reader = processComposite (schema_);
+
+                if (auto local = evolvesTo (schema_)) {
+                    return decltype (reader) {
+                        std::make_shared<reader::EvolvedReader> (
+                            std::dynamic_pointer_cast<reader::CompositeReader> (reader),
+                            evolution::Plan::get (
+                                dynamic_cast<const schema::Composite &> (schema_),
+                                *local)) };
                 }
+
+                return reader;
+            }
+            case schema::AMQPTypeNotation::restricted_t : {
+                return processRestricted (schema_);
             }
-        });
+        }
+
+        return decltype (m_readersByType)::mapped_type { };
+    });
+
+    std::lock_guard<std::mutex> lock (m_mutex);
+
+    auto & rtn = m_readersByType[schema_.name()];
+    if (!rtn) {
+        rtn = std::move (reader);
+    }
+
+    m_readersByDescriptor[schema_.descriptor()] = rtn;
+    m_fingerprints[schema_.name()] = key.fingerprint;
+
+    return rtn;
+}
+
+/******************************************************************************/
+
+/**
+ * Everything about [type_] that goes into building its reader, its name
+ * and descriptor, the names and types of its fields in order, what it's
+ * a collection of, and the fingerprints of the definitions of every type
+ * in the schema it depends upon. As those take in their own dependencies
+ * in turn two definitions only match if everything beneath them does
+ * too, so a reader can safely be shared between them. Dependencies must
+ * already have been built.
+ */
+std::string
+amqp::internal::
+CompositeFactory::definition (const schema::AMQPTypeNotation & type_) const {
+    Definition rtn;
+
+    rtn.add (type_.descriptor());
+    rtn.add (static_cast<uint64_t> (type_.type()));
+
+    // An evolved reader is only the same as another evolving to the
+    // same local version
+    if (auto local = evolvesTo (type_)) {
+        rtn.add (local->descriptor());
+    }
+
+    if (type_.type() == schema::AMQPTypeNotation::composite_t) {
+        for (const auto & field : dynamic_cast<const schema::Composite &> (type_)) {
+            rtn.add (field->name());
+            rtn.add (field->type());
+            rtn.add (field->fieldType());
+        }
+    } else {
+        const auto & restricted = dynamic_cast<const schema::Restricted &> (type_);
+
+        rtn.add (static_cast<uint64_t> (restricted.restrictedType()));
+
+        if (restricted.restrictedType() == schema::Restricted::RestrictedTypes::enum_t) {
+            for (const auto & choice : dynamic_cast<const schema::Enum &> (restricted).makeChoices()) {
+                rtn.add (choice);
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> lock (m_mutex);
+
+    for (const auto & dependency : dependencies (type_)) {
+        rtn.add (dependency);
+
+        auto it = m_fingerprints.find (dependency);
+        rtn.add (it == m_fingerprints.end() ? uint64_t { 0 } : it->second);
+    }
+
+    return rtn.value();
+}
+
+/******************************************************************************/
+
+/**
+ * The local version of [type_] if we have one that differs from it
+ */
+const amqp::internal::schema::Composite *
+amqp::internal::
+CompositeFactory::evolvesTo (const schema::AMQPTypeNotation & type_) const {
+    if (type_.type() != schema::AMQPTypeNotation::composite_t) {
+        return nullptr;
+    }
+
+    auto it = m_local.find (type_.name());
+
+    if (it == m_local.end() || it->second->descriptor() == type_.descriptor()) {
+        return nullptr;
+    }
+
+    return it->second;
 }
 
 /******************************************************************************/
@@ -133,6 +509,9 @@ CompositeFactory::processComposite (
 
     readers.reserve (fields.size());
 
+    sVec<amqp::reader::Name> names;
+    names.reserve (fields.size());
+
     for (const auto & field : fields) {
         DBG ("  Field: " << field->name() << ": \"" << field->type()
             << "\" {" << field->resolvedType() << "} "
@@ -141,26 +520,39 @@ CompositeFactory::processComposite (
        decltype (m_readersByType)::mapped_type reader;
 
         if (field->primitive()) {
+            std::lock_guard<std::mutex> lock (m_mutex);
+
             reader = computeIfAbsent<reader::Reader> (
                     m_readersByType,
                     field->resolvedType(),
-                    [&field]() -> std::shared_ptr<reader::PropertyReader> {
-                        return reader::PropertyReader::make (field);
+                    [&field]() -> std::shared_ptr<reader::Reader> {
+                        return shared (
+                            ReaderCache::Key { field->resolvedType() },
+                            [&field]() -> std::shared_ptr<reader::Reader> {
+                                return reader::PropertyReader::make (field);
+                            });
                     });
         }
         else {
-            // Insertion sorting ensures any type we depend on will have
-            // already been created and thus exist in the map
-            reader = m_readersByType[field->resolvedType()];
+            // Building a level at a time ensures any type we depend on
+            // will have already been created and thus exist in the map
+            reader = lookup (field->resolvedType());
         }
 
+        if (!reader) {
+            std::stringstream ss;
+            ss << "Missing type in map: " << field->resolvedType();
+            throw std::runtime_error (ss.str());
+        }
 
-        assert (reader);
         readers.emplace_back (reader);
         assert (readers.back().lock());
+
+        names.emplace_back (field->name());
     }
 
-    return std::make_shared<reader::CompositeReader> (type_.name(), readers);
+    return std::make_shared<reader::CompositeReader> (
+            type_.name(), readers, std::move (names));
 }
 
 /******************************************************************************/
@@ -188,14 +580,20 @@ CompositeFactory::fetchReaderForRestricted (const std::string & type_) {
 
     if (schema::Field::typeIsPrimitive(type_)) {
         DBG ("It's primitive" << std::endl);
+        std::lock_guard<std::mutex> lock (m_mutex);
+
         rtn = computeIfAbsent<reader::Reader>(
                 m_readersByType,
                 type_,
-                [& type_]() -> std::shared_ptr<reader::PropertyReader> {
-                    return reader::PropertyReader::make (type_);
+                [& type_]() -> std::shared_ptr<reader::Reader> {
+                    return shared (
+                        ReaderCache::Key { type_ },
+                        [& type_]() -> std::shared_ptr<reader::Reader> {
+                            return reader::PropertyReader::make (type_);
+                        });
                 });
     } else {
-        rtn = m_readersByType[type_];
+        rtn = lookup (type_);
     }
 
     if (!rtn) {
@@ -289,9 +687,11 @@ CompositeFactory::processRestricted (
 
 /******************************************************************************/
 
-const std::shared_ptr<amqp::internal::reader::IReader>
+std::shared_ptr<amqp::internal::reader::Reader>
 amqp::internal::
-CompositeFactory::byType (const std::string & type_) {
+CompositeFactory::lookup (const std::string & type_) const {
+    std::lock_guard<std::mutex> lock (m_mutex);
+
     auto it = m_readersByType.find (type_);
 
     return (it == m_readersByType.end()) ? nullptr : it->second;
@@ -299,9 +699,19 @@ CompositeFactory::byType (const std::string & type_) {
 
 /******************************************************************************/
 
+const std::shared_ptr<amqp::internal::reader::IReader>
+amqp::internal::
+CompositeFactory::byType (const std::string & type_) {
+    return lookup (type_);
+}
+
+/******************************************************************************/
+
 const std::shared_ptr<amqp::internal::reader::IReader>
 amqp::internal::
 CompositeFactory::byDescriptor (const std::string & descriptor_) {
+    std::lock_guard<std::mutex> lock (m_mutex);
+
     auto it = m_readersByDescriptor.find (descriptor_);
 
     return (it == m_readersByDescriptor.end()) ? nullptr : it->second;
@@ -4,6 +4,7 @@
 
 #include <map>
 #include <set>
+#include <mutex>
 #include <memory>
 
 #include "types.h"
@@ -32,11 +33,46 @@ namespace amqp::internal {
             spStrMap_t<reader::Reader> m_readersByType;
             spStrMap_t<reader::Reader> m_readersByDescriptor;
 
+            /**
+             * The fingerprint of the definition of each type we've built
+             * a reader for, those readers coming from, or going into, the
+             * [ReaderCache]. Primitives have none.
+             */
+            std::map<std::string, uint64_t> m_fingerprints;
+
+            /**
+             * Guards both maps whilst a level of the schema is being
+             * built by several threads
+             */
+            mutable std::mutex m_mutex;
+
+            size_t m_threads;
+
+            /**
+             * The composites of the schema we want blobs to be read as,
+             * by name, see [CompositeFactory]
+             */
+            std::map<std::string, const schema::Composite *> m_local;
+
         public :
-            CompositeFactory() = default;
+            /**
+             * With more than one thread the types within each level of
+             * the schema, which don't depend on one another, are built
+             * concurrently.
+             *
+             * Given a [local_] schema any composite that it has a different
+             * version of, i.e. one with the same name but a different
+             * descriptor, is read as that version instead, see
+             * [evolution::Plan]. The local schema must outlive the factory.
+             */
+            explicit CompositeFactory (
+                size_t threads_ = 1,
+                const schema::Schema * local_ = nullptr);
 
             void process (const SchemaType &) override;
 
+            void process (const SchemaType &, const std::string &) override;
+
             const std::shared_ptr<ReaderType> byType (
                     const std::string &) override;
 
@@ -44,6 +80,10 @@ namespace amqp::internal {
                     const std::string &) override;
 
         private :
+            void processLevels (
+                    const schema::Schema &,
+                    const std::set<std::string> *);
+
             std::shared_ptr<reader::Reader> process (
                     const schema::AMQPTypeNotation &);
 
@@ -67,6 +107,18 @@ namespace amqp::internal {
 
             decltype(m_readersByType)::mapped_type
             fetchReaderForRestricted (const std::string &);
+
+            decltype(m_readersByType)::mapped_type
+            lookup (const std::string &) const;
+
+            std::string definition (const schema::AMQPTypeNotation &) const;
+
+            const schema::Composite * evolvesTo (
+                const schema::AMQPTypeNotation &) const;
+
+            static std::set<std::string> reachable (
+                    const schema::Schema &,
+                    const std::string &);
     };
 
 }
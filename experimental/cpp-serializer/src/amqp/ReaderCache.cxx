@@ -0,0 +1,75 @@
+#include "ReaderCache.h"
+
+/******************************************************************************
+ *
+ * amqp::internal::ReaderCache::Key
+ *
+ ******************************************************************************/
+
+/**
+ * 64 bit FNV-1a over the name and the definition, with a separator
+ * between them so ("ab", "c") and ("a", "bc") differ
+ */
+amqp::internal::ReaderCache::
+Key::Key (std::string name_, std::string definition_)
+    : name (std::move (name_))
+    , definition (std::move (definition_))
+    , fingerprint (14695981039346656037ULL)
+{
+    auto add = [this](uint8_t byte_) {
+        fingerprint ^= byte_;
+        fingerprint *= 1099511628211ULL;
+    };
+
+    for (auto c : name) add (static_cast<uint8_t> (c));
+    add (0xFF);
+    for (auto c : definition) add (static_cast<uint8_t> (c));
+}
+
+/******************************************************************************
+ *
+ * amqp::internal::ReaderCache
+ *
+ ******************************************************************************/
+
+amqp::internal::ReaderCache &
+amqp::internal::
+ReaderCache::instance() {
+    static ReaderCache cache; // NOLINT
+
+    return cache;
+}
+
+/******************************************************************************/
+
+const sPtr<amqp::internal::reader::Reader> &
+amqp::internal::
+ReaderCache::find (const Key & key_) const {
+    return m_readers.find (key_);
+}
+
+/******************************************************************************/
+
+sPtr<amqp::internal::reader::Reader>
+amqp::internal::
+ReaderCache::insert (const Key & key_, sPtr<reader::Reader> reader_) {
+    return m_readers.insert (key_, std::move (reader_));
+}
+
+/******************************************************************************/
+
+size_t
+amqp::internal::
+ReaderCache::size() const {
+    return m_readers.size();
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::
+ReaderCache::clear() {
+    m_readers.clear();
+}
+
+/******************************************************************************/
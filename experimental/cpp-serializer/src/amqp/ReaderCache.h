@@ -0,0 +1,97 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <string>
+#include <cstdint>
+#include <utility>
+#include <functional>
+
+#include "types.h"
+#include "SnapshotMap.h"
+
+#include "reader/Reader.h"
+
+/******************************************************************************/
+
+namespace amqp::internal {
+
+    /**
+     * Readers shared by every [CompositeFactory] in the process.
+     *
+     * Envelopes with otherwise different schemas routinely carry identical
+     * definitions of the types they have in common, parties and amounts
+     * say. Keyed on the name of a type and a canonical description of its
+     * definition, which takes in the fingerprints of the definitions of
+     * everything it depends upon, a reader built for one schema is handed back to any other with the
+     * same definition rather than being built again.
+     *
+     * Keying on the definition as well as the name means any number of
+     * versions of an evolving class can be held at once, blobs written
+     * with each of them being read with their own reader.
+     *
+     * Entries are never evicted, the cache being bounded by the number of
+     * distinct type definitions seen rather than the number of schemas.
+     *
+     * Every blob looks up each of its types here whilst only a type never
+     * seen before adds to it, so the readers are held in a [SnapshotMap]
+     * and, once the types in use have been seen, threads decoding blobs
+     * read it without contending with one another.
+     */
+    class ReaderCache {
+        public :
+            /**
+             * A type's name, its definition, and a hash of the two that
+             * the cache is bucketed on. Keys are only equal if the whole
+             * of both are, so definitions whose hashes collide are still
+             * given readers of their own.
+             */
+            struct Key {
+                std::string name;
+                std::string definition;
+                uint64_t    fingerprint;
+
+                explicit Key (std::string name_, std::string definition_ = { });
+
+                bool operator == (const Key & rhs_) const {
+                    return fingerprint == rhs_.fingerprint
+                        && name == rhs_.name
+                        && definition == rhs_.definition;
+                }
+            };
+
+        private :
+            struct KeyHash {
+                size_t operator () (const Key & key_) const {
+                    // the fingerprint is already well mixed
+                    return static_cast<size_t> (key_.fingerprint);
+                }
+            };
+
+            SnapshotMap<Key, sPtr<reader::Reader>, KeyHash> m_readers;
+
+        public :
+            static ReaderCache & instance();
+
+            /**
+             * The cached reader, if any, by reference into this thread's
+             * snapshot of the cache so a warm lookup leaves the reader's
+             * reference count alone. Only valid until this thread next
+             * looks in the cache, copy it to keep hold of the reader.
+             */
+            const sPtr<reader::Reader> & find (const Key &) const;
+
+            /**
+             * Cache [reader_] unless a reader for the same definition
+             * already has been, returning whichever one is now cached
+             */
+            sPtr<reader::Reader> insert (const Key &, sPtr<reader::Reader>);
+
+            size_t size() const;
+
+            void clear();
+    };
+
+}
+
+/******************************************************************************/
@@ -0,0 +1,153 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <utility>
+#include <functional>
+#include <unordered_map>
+
+#include "types.h"
+
+/******************************************************************************/
+
+namespace amqp::internal {
+
+    /**
+     * A map read far more often than it's written, shared by every thread
+     * in the process. Readers never take a lock, writers serialise on one.
+     *
+     * The map itself is never modified. A writer copies the current one,
+     * changes the copy and publishes it in place of the original, each
+     * publication getting a new generation. Every thread keeps hold of the
+     * last snapshot it read along with its generation, and whilst that's
+     * still current looks values up in it without touching anything shared
+     * beyond the generation counter, which is only ever read. So, once the
+     * map stops changing, lookups from any number of threads don't contend
+     * on a lock or on a reference count, unless they copy what they find.
+     *
+     * The cost is that an insert copies the map, fine where entries are
+     * added once per new type and then read for every blob, and that a
+     * thread holds on to a stale snapshot until it next reads.
+     */
+    template<typename K, typename V, typename Hash = std::hash<K>>
+    class SnapshotMap {
+        public :
+            using Map = std::unordered_map<K, V, Hash>;
+
+        private :
+            /**
+             * Only ever accessed through std::atomic_load / atomic_store
+             */
+            sPtr<const Map> m_map;
+
+            std::atomic<uint64_t> m_generation;
+
+            std::mutex m_writer;
+
+            /**
+             * Generations are unique across every map of the type so
+             * a thread's snapshot of one can't be mistaken for that of
+             * another later built at the same address
+             */
+            static uint64_t nextGeneration() {
+                static std::atomic<uint64_t> generation { 0 }; // NOLINT
+
+                return ++generation;
+            }
+
+            void publish (sPtr<const Map> map_) {
+                std::atomic_store (&m_map, std::move (map_));
+                m_generation.store (nextGeneration(), std::memory_order_release);
+            }
+
+            /**
+             * The current contents. Cheap when nothing has been
+             * published since this thread last asked. Only valid until
+             * this thread next reads a map of the same type.
+             */
+            const Map & snapshot() const {
+                struct Local {
+                    const SnapshotMap * owner { nullptr };
+                    uint64_t generation { 0 };
+                    sPtr<const Map> map;
+                };
+
+                thread_local Local local; // NOLINT
+
+                auto generation = m_generation.load (std::memory_order_acquire);
+
+                if (local.owner != this || local.generation != generation) {
+                    // loaded after the generation so at least as new as it
+                    local.map = std::atomic_load (&m_map);
+                    local.owner = this;
+                    local.generation = generation;
+                }
+
+                return *local.map;
+            }
+
+        public :
+            SnapshotMap()
+                : m_map (std::make_shared<const Map>())
+                , m_generation (nextGeneration())
+            { }
+
+            SnapshotMap (const SnapshotMap &) = delete;
+
+            /**
+             * The value for [key_] or, if there isn't one, a default
+             * constructed value. Handed back by reference into this
+             * thread's snapshot, so nothing shared is touched, and only
+             * valid until this thread next reads a map of the same type.
+             * Copy it to hold on to it for any longer.
+             */
+            const V & find (const K & key_) const {
+                static const V none { }; // NOLINT
+
+                const auto & map = snapshot();
+
+                auto it = map.find (key_);
+
+                return (it == map.end()) ? none : it->second;
+            }
+
+            /**
+             * Add [value_] unless [key_] already has a value, returning
+             * whichever is now in the map
+             */
+            V insert (const K & key_, V value_) {
+                std::lock_guard<std::mutex> lock (m_writer);
+
+                auto current = std::atomic_load (&m_map);
+
+                auto it = current->find (key_);
+                if (it != current->end()) {
+                    return it->second;
+                }
+
+                auto next = std::make_shared<Map> (*current);
+                auto rtn = next->emplace (key_, std::move (value_)).first->second;
+
+                publish (std::move (next));
+
+                return rtn;
+            }
+
+            size_t size() const {
+                return std::atomic_load (&m_map)->size();
+            }
+
+            void clear() {
+                std::lock_guard<std::mutex> lock (m_writer);
+
+                publish (std::make_shared<const Map>());
+            }
+    };
+
+}
+
+/******************************************************************************/
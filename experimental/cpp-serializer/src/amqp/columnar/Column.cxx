@@ -0,0 +1,308 @@
+#include "Column.h"
+
+#include <cstring>
+#include <sstream>
+#include <ostream>
+#include <iomanip>
+#include <stdexcept>
+
+/******************************************************************************/
+
+/**
+ * Everything in the columnar file is written little endian regardless
+ * of the host we're running on
+ */
+void
+amqp::internal::columnar::
+writeLE (std::ostream & out_, uint64_t value_, size_t bytes_) {
+    char buf[8];
+    for (size_t i { 0 } ; i < bytes_ ; ++i) {
+        buf[i] = static_cast<char> ((value_ >> (8 * i)) & 0xFF);
+    }
+    out_.write (buf, bytes_);
+}
+
+/******************************************************************************/
+
+namespace {
+
+    using amqp::internal::columnar::writeLE;
+
+    void
+    writeOffsets (std::ostream & out_, const sVec<uint64_t> & offsets_) {
+        for (const auto offset : offsets_) {
+            writeLE (out_, offset, 8);
+        }
+    }
+
+    /**
+     * Quote a CSV cell if it contains anything that would otherwise
+     * break the row up
+     */
+    void
+    csvString (std::ostream & out_, const char * str_, size_t len_) {
+        bool quote { false };
+        for (size_t i { 0 } ; i < len_ && !quote ; ++i) {
+            quote = str_[i] == ',' || str_[i] == '"'
+                    || str_[i] == '\n' || str_[i] == '\r';
+        }
+
+        if (!quote) {
+            out_.write (str_, len_);
+            return;
+        }
+
+        out_ << '"';
+        for (size_t i { 0 } ; i < len_ ; ++i) {
+            if (str_[i] == '"') out_ << '"';
+            out_ << str_[i];
+        }
+        out_ << '"';
+    }
+
+}
+
+/******************************************************************************
+ *
+ * amqp::internal::columnar::Column
+ *
+ ******************************************************************************/
+
+namespace amqp::internal::columnar {
+
+    std::ostream &
+    operator << (std::ostream & stream_, const Column::Type & type_) {
+        switch (type_) {
+            case Column::integer_t : stream_ << "integer"; break;
+            case Column::real_t    : stream_ << "real"; break;
+            case Column::boolean_t : stream_ << "boolean"; break;
+            case Column::string_t  : stream_ << "string"; break;
+            case Column::offsets_t : stream_ << "offsets"; break;
+        }
+
+        return stream_;
+    }
+
+}
+
+/******************************************************************************/
+
+amqp::internal::columnar::
+Column::Column (std::string path_, Type type_)
+    : m_path (std::move (path_))
+    , m_type (type_)
+    , m_covered (0)
+    , m_nulls (0)
+{ }
+
+/******************************************************************************/
+
+bool
+amqp::internal::columnar::
+Column::valid (size_t i_) const {
+    return i_ >= m_covered || (m_validity[i_ / 8] >> (i_ % 8)) & 1;
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::columnar::
+Column::appendNull() {
+    auto i = size();
+
+    // Everything since the last null was present, the new bit is left clear
+    m_validity.resize (i / 8 + 1, 0);
+    for ( ; m_covered < i ; ++m_covered) {
+        m_validity[m_covered / 8] |= 1 << (m_covered % 8);
+    }
+
+    ++m_covered;
+    ++m_nulls;
+
+    pad();
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::columnar::
+Column::writeValidity (std::ostream & out_) const {
+    writeLE (out_, m_nulls, 8);
+
+    if (!m_nulls) {
+        return;
+    }
+
+    auto validity = m_validity;
+    validity.resize ((size() + 7) / 8, 0);
+    for (auto i = m_covered ; i < size() ; ++i) {
+        validity[i / 8] |= 1 << (i % 8);
+    }
+
+    out_.write (reinterpret_cast<const char *> (validity.data()), validity.size());
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::columnar::
+Column::mismatch (Type type_) const {
+    std::stringstream ss;
+    ss << "Column \"" << m_path << "\" is of type " << m_type
+       << " but was given a value of type " << type_;
+
+    throw std::runtime_error (ss.str());
+}
+
+/******************************************************************************
+ *
+ * amqp::internal::columnar::TypedColumn
+ *
+ ******************************************************************************/
+
+namespace amqp::internal::columnar {
+
+    template<>
+    void
+    IntegerColumn::write (std::ostream & out_) const {
+        for (const auto value : m_values) {
+            writeLE (out_, static_cast<uint64_t> (value), 8);
+        }
+    }
+
+    template<>
+    void
+    RealColumn::write (std::ostream & out_) const {
+        static_assert (sizeof (double) == sizeof (uint64_t));
+
+        for (const auto value : m_values) {
+            uint64_t bits;
+            memcpy (&bits, &value, sizeof (bits));
+            writeLE (out_, bits, 8);
+        }
+    }
+
+    template<>
+    void
+    BooleanColumn::write (std::ostream & out_) const {
+        out_.write (
+            reinterpret_cast<const char *> (m_values.data()),
+            m_values.size());
+    }
+
+    template<>
+    void
+    IntegerColumn::csv (std::ostream & out_, size_t i_) const {
+        out_ << m_values[i_];
+    }
+
+    template<>
+    void
+    RealColumn::csv (std::ostream & out_, size_t i_) const {
+        auto flags = out_.flags();
+        auto precision = out_.precision();
+
+        out_ << std::defaultfloat << std::setprecision (17) << m_values[i_];
+
+        out_.flags (flags);
+        out_.precision (precision);
+    }
+
+    template<>
+    void
+    BooleanColumn::csv (std::ostream & out_, size_t i_) const {
+        out_ << (m_values[i_] ? "true" : "false");
+    }
+
+}
+
+/******************************************************************************
+ *
+ * amqp::internal::columnar::StringColumn
+ *
+ ******************************************************************************/
+
+amqp::internal::columnar::
+StringColumn::StringColumn (std::string path_)
+    : Column (std::move (path_), string_t)
+    , m_offsets { 0 }
+{ }
+
+/******************************************************************************/
+
+void
+amqp::internal::columnar::
+StringColumn::append (const std::string & value_) {
+    m_bytes.append (value_);
+    m_offsets.push_back (m_bytes.size());
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::columnar::
+StringColumn::pad() {
+    m_offsets.push_back (m_offsets.back());
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::columnar::
+StringColumn::write (std::ostream & out_) const {
+    writeOffsets (out_, m_offsets);
+    out_.write (m_bytes.data(), m_bytes.size());
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::columnar::
+StringColumn::csv (std::ostream & out_, size_t i_) const {
+    csvString (
+        out_,
+        m_bytes.data() + m_offsets[i_],
+        m_offsets[i_ + 1] - m_offsets[i_]);
+}
+
+/******************************************************************************
+ *
+ * amqp::internal::columnar::OffsetColumn
+ *
+ ******************************************************************************/
+
+amqp::internal::columnar::
+OffsetColumn::OffsetColumn (std::string path_)
+    : Column (std::move (path_), offsets_t)
+    , m_offsets { 0 }
+{ }
+
+/******************************************************************************/
+
+void
+amqp::internal::columnar::
+OffsetColumn::appendCount (size_t count_) {
+    m_offsets.push_back (m_offsets.back() + count_);
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::columnar::
+OffsetColumn::write (std::ostream & out_) const {
+    writeOffsets (out_, m_offsets);
+}
+
+/******************************************************************************/
+
+/**
+ * In a CSV file all we can sensibly show for a collection is how many
+ * elements it had
+ */
+void
+amqp::internal::columnar::
+OffsetColumn::csv (std::ostream & out_, size_t i_) const {
+    out_ << m_offsets[i_ + 1] - m_offsets[i_];
+}
+
+/******************************************************************************/
@@ -0,0 +1,214 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <iosfwd>
+
+#include "types.h"
+
+/******************************************************************************/
+
+namespace amqp::internal::columnar {
+
+    void writeLE (std::ostream &, uint64_t, size_t);
+
+}
+
+/******************************************************************************/
+
+namespace amqp::internal::columnar {
+
+    /**
+     * A single column of values, all of which share the same field path
+     * through the decoded type. Every primitive is stored contiguously
+     * so downstream consumers can scan it without any parsing.
+     *
+     * Columns nested inside a list or map aren't aligned with the rows,
+     * rather the list or map itself is represented by an [OffsetColumn]
+     * whose n'th and n+1'th entries delimit the range of the child
+     * columns that belong to the n'th occurrence of that list.
+     *
+     * A null still takes up a slot, holding zero, the empty string or
+     * an empty collection, but is marked as absent in the column's
+     * validity bitmap.
+     */
+    class Column {
+        public :
+            enum Type { integer_t, real_t, boolean_t, string_t, offsets_t };
+
+        private :
+            std::string m_path;
+            Type        m_type;
+
+            /**
+             * One bit per value, least significant first, set when the
+             * value is present. Only filled in as far as the last null,
+             * everything from [m_covered] onward being present, so a
+             * column without nulls never allocates it.
+             */
+            sVec<uint8_t> m_validity;
+            size_t        m_covered;
+            size_t        m_nulls;
+
+        protected :
+            [[noreturn]] void mismatch (Type) const;
+
+            /**
+             * Append the placeholder a null occupies in the payload
+             */
+            virtual void pad() = 0;
+
+        public :
+            Column (std::string, Type);
+
+            virtual ~Column() = default;
+
+            const std::string & path() const { return m_path; }
+            Type type() const { return m_type; }
+
+            virtual size_t size() const = 0;
+
+            size_t nulls() const { return m_nulls; }
+
+            bool valid (size_t) const;
+
+            void appendNull();
+
+            virtual void append (int64_t) { mismatch (integer_t); }
+            virtual void append (double) { mismatch (real_t); }
+            virtual void append (bool) { mismatch (boolean_t); }
+            virtual void append (const std::string &) { mismatch (string_t); }
+            virtual void appendCount (size_t) { mismatch (offsets_t); }
+
+            /**
+             * Write the number of nulls and, if there are any, the
+             * validity bitmap as described by [ColumnarVisitor]
+             */
+            void writeValidity (std::ostream &) const;
+
+            /**
+             * Write the payload of the column as described by [ColumnarVisitor]
+             */
+            virtual void write (std::ostream &) const = 0;
+
+            /**
+             * Write the i'th value of the column as a CSV cell
+             */
+            virtual void csv (std::ostream &, size_t) const = 0;
+    };
+
+    std::ostream & operator << (std::ostream &, const Column::Type &);
+
+}
+
+/******************************************************************************/
+
+namespace amqp::internal::columnar {
+
+    /**
+     * int and long are both widened to 64 bits, booleans are stored as
+     * one byte per value. [V] is the type handed to us by the visitor,
+     * [T] the type we store it as.
+     */
+    template<typename T, typename V, Column::Type C>
+    class TypedColumn : public Column {
+        private :
+            sVec<T> m_values;
+
+        protected :
+            void pad() override { m_values.push_back (T { }); }
+
+        public :
+            explicit TypedColumn (std::string path_)
+                : Column (std::move (path_), C)
+            { }
+
+            size_t size() const override { return m_values.size(); }
+
+            const sVec<T> & values() const { return m_values; }
+
+            void append (V value_) override {
+                m_values.push_back (static_cast<T> (value_));
+            }
+
+            void write (std::ostream &) const override;
+            void csv (std::ostream &, size_t) const override;
+    };
+
+    using IntegerColumn = TypedColumn<int64_t, int64_t, Column::integer_t>;
+    using RealColumn    = TypedColumn<double, double, Column::real_t>;
+    using BooleanColumn = TypedColumn<uint8_t, bool, Column::boolean_t>;
+
+    template<> void IntegerColumn::write (std::ostream &) const;
+    template<> void RealColumn::write (std::ostream &) const;
+    template<> void BooleanColumn::write (std::ostream &) const;
+
+    template<> void IntegerColumn::csv (std::ostream &, size_t) const;
+    template<> void RealColumn::csv (std::ostream &, size_t) const;
+    template<> void BooleanColumn::csv (std::ostream &, size_t) const;
+
+}
+
+/******************************************************************************/
+
+namespace amqp::internal::columnar {
+
+    /**
+     * Strings are stored as a single buffer of bytes along with n + 1
+     * offsets into it, the i'th string being [offset[i], offset[i+1])
+     */
+    class StringColumn : public Column {
+        private :
+            sVec<uint64_t> m_offsets;
+            std::string    m_bytes;
+
+        protected :
+            void pad() override;
+
+        public :
+            explicit StringColumn (std::string);
+
+            size_t size() const override { return m_offsets.size() - 1; }
+
+            void append (const std::string &) override;
+
+            void write (std::ostream &) const override;
+            void csv (std::ostream &, size_t) const override;
+    };
+
+}
+
+/******************************************************************************/
+
+namespace amqp::internal::columnar {
+
+    /**
+     * Represents a list or map, storing n + 1 offsets into the columns
+     * nested beneath it.
+     */
+    class OffsetColumn : public Column {
+        private :
+            sVec<uint64_t> m_offsets;
+
+        protected :
+            void pad() override { appendCount (0); }
+
+        public :
+            explicit OffsetColumn (std::string);
+
+            size_t size() const override { return m_offsets.size() - 1; }
+
+            const sVec<uint64_t> & offsets() const { return m_offsets; }
+
+            void appendCount (size_t) override;
+
+            void write (std::ostream &) const override;
+            void csv (std::ostream &, size_t) const override;
+    };
+
+}
+
+/******************************************************************************/
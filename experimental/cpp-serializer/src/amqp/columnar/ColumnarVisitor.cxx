@@ -0,0 +1,269 @@
+#include "ColumnarVisitor.h"
+
+#include <ostream>
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+/******************************************************************************/
+
+namespace {
+
+    const std::string magic { "CCOL" }; // NOLINT
+
+    const uint32_t version { 2 };
+
+    /**
+     * Does a null at [null_] account for a value in the column at
+     * [path_]? It does for the column itself and any beneath it that
+     * aren't in a list or map of their own, e.g. a null "b" covers
+     * "b.c" and "b.l" but not "b.l[].x", "b.l" being the one to record
+     * that there were no elements.
+     */
+    bool
+    covers (const std::string & null_, const std::string & path_) {
+        if (path_.compare (0, null_.size(), null_) != 0) {
+            return false;
+        }
+
+        if (path_.size() == null_.size()) {
+            return true;
+        }
+
+        return path_[null_.size()] == '.'
+            && path_.find ("[]", null_.size()) == std::string::npos
+            && path_.find ("{}", null_.size()) == std::string::npos;
+    }
+
+    /**
+     * The path of the list or map a column is nested within, npos if
+     * it's aligned with the rows
+     */
+    size_t
+    parent (const std::string & path_) {
+        auto list = path_.rfind ("[]");
+        auto map = path_.rfind ("{}");
+
+        if (list == std::string::npos) return map;
+        if (map == std::string::npos) return list;
+
+        return std::max (list, map);
+    }
+
+}
+
+/******************************************************************************
+ *
+ * amqp::internal::columnar::ColumnarVisitor
+ *
+ ******************************************************************************/
+
+amqp::internal::columnar::
+ColumnarVisitor::ColumnarVisitor()
+    : m_rows (0)
+{ }
+
+/******************************************************************************/
+
+template<class C>
+amqp::internal::columnar::Column &
+amqp::internal::columnar::
+ColumnarVisitor::column (const std::string & path_) {
+    auto it = m_byPath.find (path_);
+
+    if (it != m_byPath.end()) {
+        return *(it->second);
+    }
+
+    m_columns.emplace_back (std::make_unique<C> (path_));
+    m_byPath.emplace (path_, m_columns.back().get());
+
+    auto & column = *(m_columns.back());
+
+    for (const auto & [path, nulls] : m_nulls) {
+        if (covers (path, path_)) {
+            for (size_t i { 0 } ; i < nulls ; ++i) {
+                column.appendNull();
+            }
+        }
+    }
+
+    return column;
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::columnar::
+ColumnarVisitor::check() const {
+    for (const auto & column : m_columns) {
+        const auto & path = column->path();
+        auto nested = parent (path);
+
+        size_t expected { m_rows };
+
+        if (nested != std::string::npos) {
+            auto it = m_byPath.find (path.substr (0, nested));
+            expected = it == m_byPath.end()
+                ? 0
+                : dynamic_cast<const OffsetColumn &> (*it->second).offsets().back();
+        }
+
+        // We can't tell which rows a short column is missing so rather
+        // than shift its values into the wrong rows refuse to write it
+        if (column->size() != expected) {
+            std::stringstream ss;
+            ss << "Column " << path << " has " << column->size()
+               << " values for " << expected;
+
+            if (nested == std::string::npos) {
+                ss << " rows";
+            } else {
+                ss << " elements of " << path.substr (0, nested);
+            }
+
+            throw std::runtime_error (ss.str());
+        }
+    }
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::columnar::
+ColumnarVisitor::enterComposite (const std::string &) {
+    if (root()) {
+        ++m_rows;
+    }
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::columnar::
+ColumnarVisitor::enterList (const std::string & path_, size_t elements_) {
+    column<OffsetColumn> (path_).appendCount (elements_);
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::columnar::
+ColumnarVisitor::enterMap (const std::string & path_, size_t elements_) {
+    column<OffsetColumn> (path_).appendCount (elements_);
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::columnar::
+ColumnarVisitor::value (bool value_) {
+    column<BooleanColumn> (leafPath()).append (value_);
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::columnar::
+ColumnarVisitor::value (int32_t value_) {
+    column<IntegerColumn> (leafPath()).append (static_cast<int64_t> (value_));
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::columnar::
+ColumnarVisitor::value (int64_t value_) {
+    column<IntegerColumn> (leafPath()).append (value_);
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::columnar::
+ColumnarVisitor::value (double value_) {
+    column<RealColumn> (leafPath()).append (value_);
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::columnar::
+ColumnarVisitor::value (const std::string & value_) {
+    column<StringColumn> (leafPath()).append (value_);
+}
+
+/******************************************************************************/
+
+/**
+ * Without a type we can't create a column here, if there isn't one yet
+ * it'll be padded out when the first value arrives
+ */
+void
+amqp::internal::columnar::
+ColumnarVisitor::null() {
+    const auto & path = leafPath();
+
+    for (const auto & column : m_columns) {
+        if (covers (path, column->path())) {
+            column->appendNull();
+        }
+    }
+
+    ++m_nulls[path];
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::columnar::
+ColumnarVisitor::write (std::ostream & out_) const {
+    check();
+
+    out_.write (magic.data(), magic.size());
+    writeLE (out_, version, 4);
+    writeLE (out_, m_rows, 8);
+    writeLE (out_, m_columns.size(), 4);
+
+    for (const auto & column : m_columns) {
+        writeLE (out_, column->path().size(), 4);
+        out_.write (column->path().data(), column->path().size());
+        writeLE (out_, column->type(), 1);
+        writeLE (out_, column->size(), 8);
+        column->writeValidity (out_);
+        column->write (out_);
+    }
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::columnar::
+ColumnarVisitor::csv (std::ostream & out_) const {
+    check();
+
+    sVec<const Column *> aligned;
+
+    for (const auto & column : m_columns) {
+        if (parent (column->path()) == std::string::npos) {
+            aligned.push_back (column.get());
+        }
+    }
+
+    for (size_t i { 0 } ; i < aligned.size() ; ++i) {
+        out_ << (i ? "," : "") << aligned[i]->path();
+    }
+    out_ << std::endl;
+
+    for (size_t row { 0 } ; row < m_rows ; ++row) {
+        for (size_t i { 0 } ; i < aligned.size() ; ++i) {
+            if (i) out_ << ",";
+            if (aligned[i]->valid (row)) {
+                aligned[i]->csv (out_, row);
+            }
+        }
+        out_ << std::endl;
+    }
+}
+
+/******************************************************************************/
@@ -0,0 +1,124 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <string>
+#include <vector>
+#include <iosfwd>
+#include <unordered_map>
+
+#include "types.h"
+#include "Column.h"
+
+#include "reader/PathVisitor.h"
+
+/******************************************************************************/
+
+namespace amqp::internal::columnar {
+
+    /**
+     * Driven by a reader graph, splits every primitive in a blob out into
+     * its own [Column]. Visiting many blobs of the same type with the same
+     * instance appends a row per blob.
+     *
+     * Columns are named by the path to the field as tracked by
+     * [PathVisitor], lists and maps also having a column of their own
+     *
+     *      a
+     *      b.c
+     *      listy            <- offsets into listy[].a
+     *      listy[].a
+     *      m                <- offsets into m{}.key and m{}.value
+     *      m{}.key
+     *      m{}.value
+     *
+     * The columnar file layout written by [write] is, with every integer
+     * little endian,
+     *
+     *      magic       : 4 bytes "CCOL"
+     *      version     : u32 (2)
+     *      rows        : u64
+     *      columns     : u32
+     *
+     *  and then for each column, in the order they were first seen
+     *
+     *      path length : u32
+     *      path        : path length bytes of UTF-8
+     *      type        : u8 (the value of [Column::Type])
+     *      count       : u64, the number of values in the column
+     *      nulls       : u64, how many of those values are null
+     *      validity    : only when nulls is non zero, (count + 7) / 8
+     *                    bytes with bit i (least significant first)
+     *                    clear when the i'th value is null
+     *      payload     :
+     *          integer  - count * i64
+     *          real     - count * IEEE-754 f64
+     *          boolean  - count * u8
+     *          string   - (count + 1) * u64 offsets, followed by
+     *                     offset[count] bytes of UTF-8
+     *          offsets  - (count + 1) * u64 offsets into the child columns
+     *
+     * A null property, as comes from reading a blob evolved to a local
+     * schema, is recorded against every column beneath it that shares
+     * its rows, nulls seen before a column first gets a value being
+     * filled in when it does.
+     */
+    class ColumnarVisitor : public reader::PathVisitor {
+        private :
+            sVec<uPtr<Column>>                        m_columns;
+            std::unordered_map<std::string, Column *> m_byPath;
+
+            /**
+             * How many nulls we've seen at each path, so a column that
+             * first appears after them can be padded out to line up
+             */
+            std::unordered_map<std::string, size_t> m_nulls;
+
+            size_t m_rows;
+
+            template<class C>
+            Column & column (const std::string &);
+
+            /**
+             * Throws unless every column has exactly one value for each
+             * row, or element of the list or map it's nested within
+             */
+            void check() const;
+
+        protected :
+            void enterComposite (const std::string &) override;
+            void enterList (const std::string &, size_t) override;
+            void enterMap (const std::string &, size_t) override;
+
+        public :
+            ColumnarVisitor();
+
+            size_t rows() const { return m_rows; }
+
+            const decltype (m_columns) & columns() const { return m_columns; }
+
+            void value (bool) override;
+            void value (int32_t) override;
+            void value (int64_t) override;
+            void value (double) override;
+            void value (const std::string &) override;
+
+            void null() override;
+
+            /**
+             * Write every column out in the layout described above
+             */
+            void write (std::ostream &) const;
+
+            /**
+             * Write one line per row. Only those columns that are aligned
+             * with the rows can be represented, anything nested within
+             * a list or map is only available through [write]. Nulls are
+             * written as empty cells.
+             */
+            void csv (std::ostream &) const;
+    };
+
+}
+
+/******************************************************************************/
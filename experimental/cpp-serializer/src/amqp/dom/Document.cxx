@@ -0,0 +1,463 @@
+#include "Document.h"
+
+#include <cmath>
+#include <cstring>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+
+#include "columnar/Column.h"
+#include "json/StringEscape.h"
+#include "reader/Reader.h"
+
+/******************************************************************************
+ *
+ * amqp::internal::dom::Document
+ *
+ ******************************************************************************/
+
+std::string_view
+amqp::internal::dom::
+Document::string (size_t offset_) const {
+    uint32_t len;
+    memcpy (&len, m_strings.data() + offset_, sizeof (len));
+
+    return std::string_view (m_strings.data() + offset_ + sizeof (len), len);
+}
+
+/******************************************************************************/
+
+size_t
+amqp::internal::dom::
+Document::bytes() const {
+    return m_tape.size() * sizeof (uint64_t) + m_strings.size();
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::dom::
+Document::write (std::ostream & out_) const {
+    using amqp::internal::columnar::writeLE;
+
+    writeLE (out_, m_tape.size(), 8);
+    writeLE (out_, m_strings.size(), 8);
+
+    for (const auto & word : m_tape) {
+        writeLE (out_, word, 8);
+    }
+
+    out_.write (m_strings.data(), m_strings.size());
+}
+
+/******************************************************************************/
+
+amqp::internal::dom::Element
+amqp::internal::dom::
+Document::root() const {
+    return Element (*this, 0);
+}
+
+/******************************************************************************
+ *
+ * amqp::internal::dom::Element
+ *
+ ******************************************************************************/
+
+amqp::internal::dom::
+Element::Element (const Document & document_, size_t index_)
+    : m_document (&document_)
+    , m_index (index_)
+{ }
+
+/******************************************************************************/
+
+void
+amqp::internal::dom::
+Element::error (const std::string & expected_) const {
+    std::stringstream ss;
+    ss << "Expected " << expected_ << " but found '"
+       << static_cast<char> (tag()) << "' at " << m_index;
+
+    throw std::runtime_error (ss.str());
+}
+
+/******************************************************************************/
+
+size_t
+amqp::internal::dom::
+Element::after() const {
+    switch (tag()) {
+        case Document::composite_t :
+        case Document::list_t :
+        case Document::map_t :
+            return Document::payload (word()) & 0xFFFFFFFF;
+        case Document::long_t :
+        case Document::double_t :
+            return m_index + 2;
+        default :
+            return m_index + 1;
+    }
+}
+
+/******************************************************************************/
+
+size_t
+amqp::internal::dom::
+Element::size() const {
+    if (!isComposite() && !isList() && !isMap()) {
+        error ("a composite, list or map");
+    }
+
+    return Document::payload (word()) >> 32;
+}
+
+/******************************************************************************/
+
+std::string_view
+amqp::internal::dom::
+Element::type() const {
+    if (!isComposite()) error ("a composite");
+
+    return m_document->string (m_document->m_tape[m_index + 1]);
+}
+
+/******************************************************************************/
+
+amqp::internal::dom::Element
+amqp::internal::dom::
+Element::operator [] (std::string_view name_) const {
+    for (auto it = begin() ; it != end() ; ++it) {
+        if (it.name() == name_) {
+            return *it;
+        }
+    }
+
+    std::stringstream ss;
+    ss << type() << " has no property \"" << name_ << "\"";
+    throw std::runtime_error (ss.str());
+}
+
+/******************************************************************************/
+
+amqp::internal::dom::Element
+amqp::internal::dom::
+Element::operator [] (size_t i_) const {
+    if (!isList() && !isMap()) error ("a list or map");
+
+    auto n = isMap() ? 2 * size() : size();
+    if (i_ >= n) {
+        std::stringstream ss;
+        ss << "Index " << i_ << " out of range for " << n << " elements";
+        throw std::out_of_range (ss.str());
+    }
+
+    auto it = begin();
+    for (size_t i { 0 } ; i < i_ ; ++i) {
+        ++it;
+    }
+
+    return *it;
+}
+
+/******************************************************************************/
+
+amqp::internal::dom::Element::Iterator
+amqp::internal::dom::
+Element::begin() const {
+    if (isComposite()) {
+        return Iterator (*m_document, m_index + 2, true);
+    }
+
+    if (!isList() && !isMap()) error ("a composite, list or map");
+
+    return Iterator (*m_document, m_index + 1, false);
+}
+
+/******************************************************************************/
+
+amqp::internal::dom::Element::Iterator
+amqp::internal::dom::
+Element::end() const {
+    return Iterator (*m_document, after() - 1, isComposite());
+}
+
+/******************************************************************************/
+
+namespace amqp::internal::dom {
+
+    template<>
+    bool
+    Element::get<bool>() const {
+        switch (tag()) {
+            case Document::true_t  : return true;
+            case Document::false_t : return false;
+            default                : error ("a boolean");
+        }
+    }
+
+    template<>
+    int64_t
+    Element::get<int64_t>() const {
+        switch (tag()) {
+            case Document::int_t :
+                return static_cast<int32_t> (Document::payload (word()));
+            case Document::long_t :
+                return static_cast<int64_t> (m_document->m_tape[m_index + 1]);
+            default :
+                error ("an integer");
+        }
+    }
+
+    template<>
+    double
+    Element::get<double>() const {
+        if (tag() != Document::double_t) error ("a double");
+
+        double rtn;
+        memcpy (&rtn, &m_document->m_tape[m_index + 1], sizeof (rtn));
+
+        return rtn;
+    }
+
+    template<>
+    std::string_view
+    Element::get<std::string_view>() const {
+        if (tag() != Document::string_t) error ("a string");
+
+        return m_document->string (Document::payload (word()));
+    }
+
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::dom::
+Element::dumpTo (std::string & out_) const {
+    switch (tag()) {
+        case Document::composite_t : {
+            out_ += "{ ";
+            bool first { true };
+            for (auto it = begin() ; it != end() ; ++it) {
+                if (!first) out_ += ", ";
+                first = false;
+
+                out_ += it.name();
+                out_ += " : ";
+                (*it).dumpTo (out_);
+            }
+            out_ += " }";
+            break;
+        }
+        case Document::list_t : {
+            out_ += "[ ";
+            bool first { true };
+            for (auto it = begin() ; it != end() ; ++it) {
+                if (!first) out_ += ", ";
+                first = false;
+
+                (*it).dumpTo (out_);
+            }
+            out_ += " ]";
+            break;
+        }
+        case Document::map_t : {
+            out_ += "{ ";
+            bool key { true };
+            for (auto it = begin() ; it != end() ; ++it, key = !key) {
+                if (key && it != begin()) out_ += ", ";
+                (*it).dumpTo (out_);
+                if (key) out_ += " : ";
+            }
+            out_ += " }";
+            break;
+        }
+        case Document::int_t :
+        case Document::long_t :
+            reader::appendNumber (out_, get<int64_t>());
+            break;
+        case Document::double_t :
+            reader::appendNumber (out_, get<double>());
+            break;
+        case Document::true_t :
+        case Document::false_t :
+            reader::appendNumber (out_, get<bool>());
+            break;
+        case Document::string_t : {
+            auto str = get<std::string_view>();
+            json::appendQuoted (out_, str.data(), str.size());
+            break;
+        }
+        case Document::null_t :
+            out_ += "null";
+            break;
+        default :
+            error ("a value");
+    }
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::dom::
+Element::jsonTo (std::string & out_) const {
+    switch (tag()) {
+        case Document::composite_t : {
+            out_ += '{';
+            for (auto it = begin() ; it != end() ; ++it) {
+                if (it != begin()) out_ += ',';
+
+                auto name = it.name();
+                json::appendQuoted (out_, name.data(), name.size());
+                out_ += ':';
+                (*it).jsonTo (out_);
+            }
+            out_ += '}';
+            break;
+        }
+        case Document::list_t : {
+            out_ += '[';
+            for (auto it = begin() ; it != end() ; ++it) {
+                if (it != begin()) out_ += ',';
+
+                (*it).jsonTo (out_);
+            }
+            out_ += ']';
+            break;
+        }
+        case Document::map_t : {
+            out_ += '[';
+            bool key { true };
+            for (auto it = begin() ; it != end() ; ++it, key = !key) {
+                if (key) {
+                    out_ += it != begin() ? ",[" : "[";
+                }
+                (*it).jsonTo (out_);
+                out_ += key ? ',' : ']';
+            }
+            out_ += ']';
+            break;
+        }
+        case Document::double_t : {
+            auto value = get<double>();
+
+            if (std::isfinite (value)) {
+                reader::appendNumber (out_, value);
+            } else {
+                out_ += "null";
+            }
+            break;
+        }
+        case Document::true_t :
+        case Document::false_t :
+            out_ += get<bool>() ? "true" : "false";
+            break;
+        default :
+            // numbers, strings and null are already what JSON wants
+            dumpTo (out_);
+    }
+}
+
+/******************************************************************************/
+
+std::string
+amqp::internal::dom::
+Element::dump() const {
+    std::string rtn;
+    dumpTo (rtn);
+    return rtn;
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::dom::
+Element::visit (amqp::reader::IVisitor & visitor_) const {
+    switch (tag()) {
+        case Document::composite_t :
+            visitor_.beginComposite (std::string { type() });
+            for (auto it = begin() ; it != end() && !visitor_.halted() ; ++it) {
+                visitor_.property (std::string { it.name() });
+                (*it).visit (visitor_);
+            }
+            visitor_.endComposite();
+            break;
+        case Document::list_t :
+            visitor_.beginList (size());
+            for (auto it = begin() ; it != end() && !visitor_.halted() ; ++it) {
+                (*it).visit (visitor_);
+            }
+            visitor_.endList();
+            break;
+        case Document::map_t :
+            visitor_.beginMap (size());
+            for (auto it = begin() ; it != end() && !visitor_.halted() ; ++it) {
+                (*it).visit (visitor_);
+            }
+            visitor_.endMap();
+            break;
+        case Document::int_t :
+            visitor_.value (static_cast<int32_t> (get<int64_t>()));
+            break;
+        case Document::long_t :
+            visitor_.value (get<int64_t>());
+            break;
+        case Document::double_t :
+            visitor_.value (get<double>());
+            break;
+        case Document::true_t :
+        case Document::false_t :
+            visitor_.value (get<bool>());
+            break;
+        case Document::string_t :
+            visitor_.value (std::string { get<std::string_view>() });
+            break;
+        case Document::null_t :
+            visitor_.null();
+            break;
+        default :
+            error ("a value");
+    }
+}
+
+/******************************************************************************
+ *
+ * amqp::internal::dom::Element::Iterator
+ *
+ ******************************************************************************/
+
+amqp::internal::dom::Element::
+Iterator::Iterator (const Document & document_, size_t index_, bool named_)
+    : m_document (&document_)
+    , m_index (index_)
+    , m_named (named_)
+{ }
+
+/******************************************************************************/
+
+amqp::internal::dom::Element
+amqp::internal::dom::Element::
+Iterator::operator * () const {
+    return Element (*m_document, m_named ? m_index + 1 : m_index);
+}
+
+/******************************************************************************/
+
+std::string_view
+amqp::internal::dom::Element::
+Iterator::name() const {
+    return m_document->string (
+        Document::payload (m_document->tape()[m_index]));
+}
+
+/******************************************************************************/
+
+amqp::internal::dom::Element::Iterator &
+amqp::internal::dom::Element::
+Iterator::operator ++ () {
+    m_index = (**this).after();
+    return *this;
+}
+
+/******************************************************************************/
@@ -0,0 +1,249 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <iosfwd>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <string_view>
+
+#include "types.h"
+
+#include "amqp/reader/IVisitor.h"
+
+/******************************************************************************/
+
+namespace amqp::internal::dom {
+
+    class Element;
+
+    /**
+     * A decoded blob held as one contiguous tape of 64 bit words rather
+     * than a tree of [IValue]s. The top byte of each word is a [Tag],
+     * the remaining 56 bits its payload.
+     *
+     *      {  next | count<<32     composite, followed by a raw word
+     *                              holding the offset of its type name
+     *      p  name offset          a property of the enclosing composite,
+     *                              its value follows immediately
+     *      }  index of the {
+     *      [  next | count<<32     list of count elements
+     *      ]  index of the [
+     *      (  next | count<<32     map of count entries, key then value
+     *      )  index of the (
+     *      i  int32                inline
+     *      l                       followed by a raw word, the int64
+     *      d                       followed by a raw word, the double's bits
+     *      t / f                   booleans
+     *      s  string offset
+     *      n                       null
+     *
+     * where next is the index of the word after the matching close, so
+     * a whole composite, list or map can be stepped over without looking
+     * inside it. Strings, property and type names live in a side buffer,
+     * each prefixed with its length as a native u32.
+     *
+     * Compared to the [IValue] tree a primitive property costs two words
+     * rather than a heap node with a vtable, a std::string for its name
+     * and a unique_ptr in its parent, and walking it touches memory in
+     * order.
+     */
+    class Document {
+        public :
+            enum Tag : uint8_t {
+                composite_t    = '{',
+                compositeEnd_t = '}',
+                list_t         = '[',
+                listEnd_t      = ']',
+                map_t          = '(',
+                mapEnd_t       = ')',
+                property_t     = 'p',
+                int_t          = 'i',
+                long_t         = 'l',
+                double_t       = 'd',
+                true_t         = 't',
+                false_t        = 'f',
+                string_t       = 's',
+                null_t         = 'n'
+            };
+
+        private :
+            sVec<uint64_t> m_tape;
+            std::string    m_strings;
+
+            friend class DocumentBuilder;
+            friend class Element;
+
+        public :
+            static Tag tag (uint64_t word_) {
+                return static_cast<Tag> (word_ >> 56);
+            }
+
+            static uint64_t payload (uint64_t word_) {
+                return word_ & 0x00FFFFFFFFFFFFFFULL;
+            }
+
+            const sVec<uint64_t> & tape() const { return m_tape; }
+
+            std::string_view string (size_t) const;
+
+            /**
+             * Bytes used by the tape and string buffer
+             */
+            size_t bytes() const;
+
+            /**
+             * Write the document out as is so another process can walk
+             * it without decoding anything, every integer little endian
+             *
+             *      words   : u64, the length of the tape
+             *      strings : u64, the size of the string buffer
+             *      tape    : words * u64
+             *      buffer  : strings bytes
+             */
+            void write (std::ostream &) const;
+
+            /**
+             * The top level object. Only valid if something has
+             * been written to the document.
+             */
+            Element root() const;
+    };
+
+}
+
+/******************************************************************************/
+
+namespace amqp::internal::dom {
+
+    /**
+     * A lightweight handle onto a value within a [Document], no more
+     * than a pointer and an index so cheap to copy about.
+     */
+    class Element {
+        private :
+            const Document * m_document;
+            size_t           m_index;
+
+            uint64_t word() const { return m_document->m_tape[m_index]; }
+
+            /**
+             * The index of the first word after this value
+             */
+            size_t after() const;
+
+            [[noreturn]] void error (const std::string &) const;
+
+        public :
+            class Iterator;
+
+            Element (const Document &, size_t);
+
+            Document::Tag tag() const { return Document::tag (word()); }
+
+            bool isComposite() const { return tag() == Document::composite_t; }
+            bool isList() const { return tag() == Document::list_t; }
+            bool isMap() const { return tag() == Document::map_t; }
+            bool isNull() const { return tag() == Document::null_t; }
+
+            /**
+             * The number of properties of a composite, elements of a
+             * list or entries of a map
+             */
+            size_t size() const;
+
+            /**
+             * The name of a composite's type
+             */
+            std::string_view type() const;
+
+            /**
+             * A property of a composite by name
+             */
+            Element operator [] (std::string_view) const;
+
+            /**
+             * The i'th element of a list, or for a map the i'th of its
+             * keys and values in turn
+             */
+            Element operator [] (size_t) const;
+
+            /**
+             * The children of a composite, list or map in order. For
+             * a composite that's its property values, the iterator
+             * knowing what they're called.
+             */
+            Iterator begin() const;
+            Iterator end() const;
+
+            /**
+             * Specialised in the CXX file for bool, int64_t, double and
+             * std::string_view. Ints and longs are both int64_t.
+             */
+            template<typename T>
+            T get() const;
+
+            /**
+             * Append this value formatted as [IValue::dumpTo] would have,
+             * other than strings always being quoted
+             */
+            void dumpTo (std::string &) const;
+            std::string dump() const;
+
+            /**
+             * Append this value as strict JSON. Property names are quoted,
+             * bools are true and false, doubles that aren't finite are
+             * null and, as their keys needn't be strings, maps are arrays
+             * of [ key, value ] pairs.
+             */
+            void jsonTo (std::string &) const;
+
+            /**
+             * Replay this value to a visitor as the readers would have
+             */
+            void visit (amqp::reader::IVisitor &) const;
+    };
+
+    template<> bool Element::get<bool>() const;
+    template<> int64_t Element::get<int64_t>() const;
+    template<> double Element::get<double>() const;
+    template<> std::string_view Element::get<std::string_view>() const;
+
+}
+
+/******************************************************************************/
+
+namespace amqp::internal::dom {
+
+    class Element::Iterator {
+        private :
+            const Document * m_document;
+
+            /**
+             * Within a composite we sit on the name of each property
+             * rather than its value
+             */
+            size_t           m_index;
+            bool             m_named;
+
+        public :
+            Iterator (const Document &, size_t, bool);
+
+            Element operator * () const;
+
+            /**
+             * The name of the current property of a composite
+             */
+            std::string_view name() const;
+
+            Iterator & operator ++ ();
+
+            bool operator != (const Iterator & rhs_) const {
+                return m_index != rhs_.m_index;
+            }
+    };
+
+}
+
+/******************************************************************************/
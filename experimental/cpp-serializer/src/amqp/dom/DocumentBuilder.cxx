@@ -0,0 +1,229 @@
+#include "DocumentBuilder.h"
+
+#include <limits>
+#include <cstring>
+#include <stdexcept>
+
+/******************************************************************************
+ *
+ * amqp::internal::dom::DocumentBuilder
+ *
+ ******************************************************************************/
+
+void
+amqp::internal::dom::
+DocumentBuilder::push (Document::Tag tag_, uint64_t payload_) {
+    m_document.m_tape.push_back ((uint64_t { tag_ } << 56) | payload_);
+}
+
+/******************************************************************************/
+
+/**
+ * Copy [str_] into the string buffer, returning where it went
+ */
+uint64_t
+amqp::internal::dom::
+DocumentBuilder::string (const std::string & str_) {
+    auto & strings = m_document.m_strings;
+
+    if (str_.size() > std::numeric_limits<uint32_t>::max()) {
+        throw std::runtime_error ("String too long to put in a document");
+    }
+
+    uint64_t rtn = strings.size();
+    auto len = static_cast<uint32_t> (str_.size());
+
+    strings.append (reinterpret_cast<const char *> (&len), sizeof (len));
+    strings.append (str_);
+
+    return rtn;
+}
+
+/******************************************************************************/
+
+/**
+ * As [string] but for names, which repeat across every composite of a
+ * type, so only copying each one in the first time we see it
+ */
+uint64_t
+amqp::internal::dom::
+DocumentBuilder::name (const std::string & name_) {
+    auto it = m_names.find (name_);
+
+    if (it != m_names.end()) {
+        return it->second;
+    }
+
+    return m_names.emplace (name_, string (name_)).first->second;
+}
+
+/******************************************************************************/
+
+/**
+ * Open a composite, list or map. The word's payload is filled in once
+ * we know where it ends.
+ */
+void
+amqp::internal::dom::
+DocumentBuilder::begin (Document::Tag tag_, size_t count_) {
+    if (count_ > 0xFFFFFF) {
+        throw std::runtime_error ("Too many elements to put in a document");
+    }
+
+    m_open.push_back (m_document.m_tape.size());
+    push (tag_, uint64_t { count_ } << 32);
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::dom::
+DocumentBuilder::end (Document::Tag tag_) {
+    auto & tape = m_document.m_tape;
+
+    auto open = m_open.back();
+    m_open.pop_back();
+
+    push (tag_, open);
+
+    if (tape.size() > std::numeric_limits<uint32_t>::max()) {
+        throw std::runtime_error ("Too many values to put in a document");
+    }
+
+    tape[open] |= tape.size();
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::dom::
+DocumentBuilder::property (const std::string & name_) {
+    auto & tape = m_document.m_tape;
+
+    // count the properties of the composite we're within as we go
+    tape[m_open.back()] += uint64_t { 1 } << 32;
+
+    push (Document::property_t, name (name_));
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::dom::
+DocumentBuilder::beginComposite (const std::string & type_) {
+    begin (Document::composite_t, 0);
+    m_document.m_tape.push_back (name (type_));
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::dom::
+DocumentBuilder::endComposite() {
+    end (Document::compositeEnd_t);
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::dom::
+DocumentBuilder::beginList (size_t elements_) {
+    begin (Document::list_t, elements_);
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::dom::
+DocumentBuilder::endList() {
+    end (Document::listEnd_t);
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::dom::
+DocumentBuilder::beginMap (size_t entries_) {
+    begin (Document::map_t, entries_);
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::dom::
+DocumentBuilder::endMap() {
+    end (Document::mapEnd_t);
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::dom::
+DocumentBuilder::value (bool value_) {
+    push (value_ ? Document::true_t : Document::false_t);
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::dom::
+DocumentBuilder::value (int32_t value_) {
+    push (Document::int_t, static_cast<uint32_t> (value_));
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::dom::
+DocumentBuilder::value (int64_t value_) {
+    push (Document::long_t);
+    m_document.m_tape.push_back (static_cast<uint64_t> (value_));
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::dom::
+DocumentBuilder::value (double value_) {
+    static_assert (sizeof (double) == sizeof (uint64_t));
+
+    uint64_t bits;
+    memcpy (&bits, &value_, sizeof (bits));
+
+    push (Document::double_t);
+    m_document.m_tape.push_back (bits);
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::dom::
+DocumentBuilder::value (const std::string & value_) {
+    push (Document::string_t, string (value_));
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::dom::
+DocumentBuilder::null() {
+    push (Document::null_t);
+}
+
+/******************************************************************************/
+
+amqp::internal::dom::Document
+amqp::internal::dom::
+DocumentBuilder::document() {
+    if (!m_open.empty()) {
+        throw std::logic_error ("Document taken before it was finished");
+    }
+
+    auto rtn = std::move (m_document);
+    m_document = Document { };
+    m_names.clear();
+
+    return rtn;
+}
+
+/******************************************************************************/
@@ -0,0 +1,72 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <string>
+#include <unordered_map>
+
+#include "types.h"
+#include "Document.h"
+
+#include "amqp/reader/IVisitor.h"
+
+/******************************************************************************/
+
+namespace amqp::internal::dom {
+
+    /**
+     * Driven by the readers, writes what it's shown onto the tape of a
+     * [Document]. Visit a single blob with each builder.
+     */
+    class DocumentBuilder : public amqp::reader::IVisitor {
+        private :
+            Document m_document;
+
+            /**
+             * The indices of the composites, lists and maps we're
+             * within, so they can be told where they end
+             */
+            sVec<size_t> m_open;
+
+            /**
+             * Where each property and type name already in the string
+             * buffer is, so a list of composites only holds its names once
+             */
+            std::unordered_map<std::string, uint64_t> m_names;
+
+            void push (Document::Tag, uint64_t = 0);
+            uint64_t string (const std::string &);
+            uint64_t name (const std::string &);
+
+            void begin (Document::Tag, size_t);
+            void end (Document::Tag);
+
+        public :
+            void property (const std::string &) override;
+
+            void beginComposite (const std::string &) override;
+            void endComposite() override;
+
+            void beginList (size_t) override;
+            void endList() override;
+
+            void beginMap (size_t) override;
+            void endMap() override;
+
+            void value (bool) override;
+            void value (int32_t) override;
+            void value (int64_t) override;
+            void value (double) override;
+            void value (const std::string &) override;
+
+            void null() override;
+
+            /**
+             * Hand over the finished document, leaving the builder empty
+             */
+            Document document();
+    };
+
+}
+
+/******************************************************************************/
@@ -0,0 +1,90 @@
+#include "Plan.h"
+
+#include <sstream>
+#include <utility>
+#include <stdexcept>
+#include <functional>
+
+#include "SnapshotMap.h"
+
+#include "amqp/schema/field-types/Field.h"
+
+/******************************************************************************/
+
+namespace {
+
+    using Key = std::pair<std::string, std::string>;
+
+    struct KeyHash {
+        size_t operator () (const Key & key_) const {
+            return std::hash<std::string>() (key_.first)
+                ^ (std::hash<std::string>() (key_.second) << 1);
+        }
+    };
+
+}
+
+/******************************************************************************
+ *
+ * amqp::internal::evolution::Plan
+ *
+ ******************************************************************************/
+
+amqp::internal::evolution::
+Plan::Plan (
+    const schema::Composite & remote_,
+    const schema::Composite & local_
+) : m_remoteProperties (remote_.fields().size())
+  , m_locals (remote_.fields().size(), -1)
+{
+    const auto & remote = remote_.fields();
+
+    for (const auto & field : local_) {
+        int index { -1 };
+
+        for (size_t i { 0 } ; i < remote.size() ; ++i) {
+            if (remote[i]->name() == field->name()) {
+                index = static_cast<int> (i);
+                break;
+            }
+        }
+
+        if (index != -1 && remote[index]->resolvedType() != field->resolvedType()) {
+            std::stringstream ss;
+            ss << "Can't evolve " << remote_.name() << ": property "
+               << field->name() << " has changed type from "
+               << remote[index]->resolvedType() << " to "
+               << field->resolvedType();
+            throw std::runtime_error (ss.str());
+        }
+
+        if (index != -1) {
+            m_locals[index] = static_cast<int> (m_slots.size());
+        }
+
+        m_slots.push_back ({ index, field->resolvedType() });
+        m_names.emplace_back (field->name());
+    }
+}
+
+/******************************************************************************/
+
+sPtr<const amqp::internal::evolution::Plan>
+amqp::internal::evolution::
+Plan::get (
+    const schema::Composite & remote_,
+    const schema::Composite & local_
+) {
+    static SnapshotMap<Key, sPtr<const Plan>, KeyHash> plans; // NOLINT
+
+    Key key { remote_.descriptor(), local_.descriptor() };
+
+    // copied only on the way out, to the reader that keeps hold of it
+    if (const auto & plan = plans.find (key)) {
+        return plan;
+    }
+
+    return plans.insert (key, std::make_shared<const Plan> (remote_, local_));
+}
+
+/******************************************************************************/
@@ -0,0 +1,79 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <string>
+
+#include "types.h"
+
+#include "amqp/reader/Name.h"
+#include "amqp/schema/described-types/Composite.h"
+
+/******************************************************************************/
+
+namespace amqp::internal::evolution {
+
+    /**
+     * How to present a composite written with one version of a class,
+     * the remote one in the blob's schema, as another version of it, the
+     * local one we want to read it as.
+     *
+     * Properties are matched by name. Every local property is either read
+     * from the remote property with the same name, which must have the
+     * same type, or, where the remote version doesn't have it, filled in
+     * with the default for its type, as Java would, zero for a primitive
+     * and null for anything else, strings included. Remote properties the
+     * local version doesn't have are never read at all.
+     *
+     * Working this out is the expensive part so it's done once for each
+     * pair of versions and shared, see [get], leaving reading an evolved
+     * blob no slower than reading one written with the local version.
+     */
+    class Plan {
+        public :
+            struct Slot {
+                /**
+                 * Index of the remote property this one is read from,
+                 * or -1 if it's to be defaulted
+                 */
+                int         remote;
+                std::string type;
+            };
+
+        private :
+            sVec<Slot>               m_slots;
+            sVec<amqp::reader::Name> m_names;
+            size_t                   m_remoteProperties;
+            sVec<int>                m_locals;
+
+        public :
+            Plan (const schema::Composite &, const schema::Composite &);
+
+            /**
+             * The plan for reading [remote_] as [local_], compiled on first
+             * use and cached by the descriptors, i.e. the fingerprints, of
+             * the pair
+             */
+            static sPtr<const Plan> get (
+                const schema::Composite & remote_,
+                const schema::Composite & local_);
+
+            /**
+             * One per local property, in local order
+             */
+            const sVec<Slot> & slots() const { return m_slots; }
+            const sVec<amqp::reader::Name> & names() const { return m_names; }
+
+            size_t remoteProperties() const { return m_remoteProperties; }
+
+            /**
+             * One per remote property, in remote order, the index of the
+             * local property read from it or -1 if it's dropped, so the
+             * remote properties can be read in a single pass
+             */
+            const sVec<int> & locals() const { return m_locals; }
+    };
+
+}
+
+/******************************************************************************/
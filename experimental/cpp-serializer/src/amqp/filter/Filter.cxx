@@ -0,0 +1,499 @@
+#include "Filter.h"
+
+#include <cctype>
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+#include "schema/field-types/Field.h"
+#include "schema/restricted-types/Map.h"
+#include "schema/restricted-types/List.h"
+#include "schema/restricted-types/Array.h"
+#include "schema/restricted-types/Restricted.h"
+#include "amqp/schema/described-types/Composite.h"
+
+/******************************************************************************/
+
+namespace {
+
+    using namespace amqp::internal;
+
+    [[noreturn]] void
+    error (const std::string & expr_, size_t pos_, const std::string & what_) {
+        std::stringstream ss;
+        ss << "Bad filter \"" << expr_ << "\" at " << pos_ << ": " << what_;
+        throw std::runtime_error (ss.str());
+    }
+
+    bool
+    isSpace (char c_) {
+        return std::isspace (static_cast<unsigned char> (c_));
+    }
+
+    void
+    skipSpace (const std::string & expr_, size_t & pos_) {
+        while (pos_ < expr_.size() && isSpace (expr_[pos_])) ++pos_;
+    }
+
+    bool
+    isOpChar (char c_) {
+        return c_ == '=' || c_ == '!' || c_ == '<' || c_ == '>';
+    }
+
+    /**
+     * Paths run up to the first space or operator
+     */
+    bool
+    isPathChar (char c_) {
+        return !isSpace (c_) && !isOpChar (c_);
+    }
+
+    /**
+     * Is [word_] at [pos_] as a whole word rather than the start of a path
+     * such as "android.x"?
+     */
+    bool
+    keyword (const std::string & expr_, size_t pos_, const std::string & word_) {
+        auto end = pos_ + word_.size();
+
+        return expr_.compare (pos_, word_.size(), word_) == 0
+            && (end == expr_.size() || !isPathChar (expr_[end]));
+    }
+
+    filter::Op
+    parseOp (const std::string & expr_, size_t & pos_) {
+        auto start { pos_ };
+        while (pos_ < expr_.size() && isOpChar (expr_[pos_])) ++pos_;
+
+        auto op = expr_.substr (start, pos_ - start);
+
+        if (op == "=" || op == "==") return filter::eq_o;
+        if (op == "!=") return filter::ne_o;
+        if (op == "<")  return filter::lt_o;
+        if (op == "<=") return filter::le_o;
+        if (op == ">")  return filter::gt_o;
+        if (op == ">=") return filter::ge_o;
+
+        error (expr_, start, "expected a comparison operator");
+    }
+
+    std::string
+    parseLiteral (const std::string & expr_, size_t & pos_) {
+        std::string rtn;
+
+        if (pos_ < expr_.size() && expr_[pos_] == '"') {
+            auto start { pos_++ };
+            while (pos_ < expr_.size() && expr_[pos_] != '"') {
+                if (expr_[pos_] == '\\' && pos_ + 1 < expr_.size()) ++pos_;
+                rtn += expr_[pos_++];
+            }
+
+            if (pos_ == expr_.size()) {
+                error (expr_, start, "unterminated string");
+            }
+            ++pos_;
+        } else {
+            while (pos_ < expr_.size() && !isSpace (expr_[pos_])) {
+                rtn += expr_[pos_++];
+            }
+
+            if (rtn.empty()) {
+                error (expr_, pos_, "expected a value");
+            }
+        }
+
+        return rtn;
+    }
+
+    sVec<filter::Clause>
+    parse (const std::string & expr_) {
+        sVec<filter::Clause> rtn;
+        size_t pos { 0 };
+
+        while (true) {
+            skipSpace (expr_, pos);
+
+            auto start { pos };
+            while (pos < expr_.size() && isPathChar (expr_[pos])) {
+                ++pos;
+            }
+
+            if (start == pos) {
+                error (expr_, pos, "expected a field path");
+            }
+
+            auto path = expr_.substr (start, pos - start);
+
+            skipSpace (expr_, pos);
+            auto op = parseOp (expr_, pos);
+            skipSpace (expr_, pos);
+            auto literal = parseLiteral (expr_, pos);
+
+            rtn.push_back ({ std::move (path), op, std::move (literal) });
+
+            skipSpace (expr_, pos);
+            if (pos == expr_.size()) {
+                break;
+            }
+
+            if (keyword (expr_, pos, "and")) {
+                pos += 3;
+            } else if (expr_.compare (pos, 2, "&&") == 0) {
+                pos += 2;
+            } else {
+                error (expr_, pos, "expected \"and\"");
+            }
+        }
+
+        return rtn;
+    }
+
+    /**
+     * Break a path up into the names of properties and the "[]" and "{}"
+     * markers for collections
+     */
+    sVec<std::string>
+    split (const std::string & path_) {
+        sVec<std::string> rtn;
+        std::string current;
+
+        for (size_t i { 0 } ; i < path_.size() ; ++i) {
+            if (path_[i] == '.') {
+                if (!current.empty()) rtn.push_back (std::move (current));
+                current.clear();
+            } else if (   (path_[i] == '[' || path_[i] == '{')
+                       && i + 1 < path_.size())
+            {
+                if (!current.empty()) rtn.push_back (std::move (current));
+                current.clear();
+                rtn.push_back (path_.substr (i, 2));
+                ++i;
+            } else {
+                current += path_[i];
+            }
+        }
+
+        if (!current.empty()) rtn.push_back (std::move (current));
+
+        return rtn;
+    }
+
+    const schema::AMQPTypeNotation &
+    notation (const schema::SchemaMap::const_iterator & it_) {
+        return *(it_->second.get());
+    }
+
+    /**
+     * Walk the schema from the root type down the given path
+     *
+     * @return the primitive type the path ends at and whether or not
+     * we passed through a collection to get there
+     */
+    std::pair<std::string, bool>
+    resolve (
+        const std::string & path_,
+        const schema::ISchemaType & schema_,
+        const std::string & descriptor_
+    ) {
+        auto segments = split (path_);
+
+        const schema::AMQPTypeNotation * current =
+            &notation (schema_.fromDescriptor (descriptor_));
+
+        std::string type;
+        bool repeated { false };
+
+        auto bad = [&path_](const std::string & why_) {
+            std::stringstream ss;
+            ss << "Cannot filter on \"" << path_ << "\", " << why_;
+            throw std::runtime_error (ss.str());
+        };
+
+        for (auto seg = segments.begin() ; seg != segments.end() ; ++seg) {
+            if (!current) {
+                bad ("it continues past the primitive \"" + type + "\"");
+            }
+
+            if (current->type() == schema::AMQPTypeNotation::composite_t) {
+                const auto & fields = dynamic_cast<const schema::Composite &> (
+                        *current).fields();
+
+                auto field = std::find_if (
+                        fields.begin(), fields.end(),
+                        [&seg](const auto & f_) { return f_->name() == *seg; });
+
+                if (field == fields.end()) {
+                    bad (current->name() + " has no property " + *seg);
+                }
+
+                type = (*field)->resolvedType();
+            } else {
+                const auto & restricted = dynamic_cast<const schema::Restricted &> (
+                        *current);
+
+                switch (restricted.restrictedType()) {
+                    case schema::Restricted::list_t : {
+                        if (*seg != "[]") bad ("expected [] after a list");
+                        type = dynamic_cast<const schema::List &> (
+                                restricted).listOf();
+                        break;
+                    }
+                    case schema::Restricted::array_t : {
+                        if (*seg != "[]") bad ("expected [] after an array");
+                        type = dynamic_cast<const schema::Array &> (
+                                restricted).arrayOf();
+                        break;
+                    }
+                    case schema::Restricted::map_t : {
+                        if (*seg != "{}" || std::next (seg) == segments.end()) {
+                            bad ("expected {}.key or {}.value after a map");
+                        }
+
+                        auto mapOf = dynamic_cast<const schema::Map &> (
+                                restricted).mapOf();
+
+                        ++seg;
+                        if (*seg == "key") {
+                            type = mapOf.first.get();
+                        } else if (*seg == "value") {
+                            type = mapOf.second.get();
+                        } else {
+                            bad ("expected {}.key or {}.value after a map");
+                        }
+                        break;
+                    }
+                    case schema::Restricted::enum_t : {
+                        bad ("it continues past the enum " + current->name());
+                    }
+                }
+
+                repeated = true;
+            }
+
+            type = schema::Restricted::unbox (type);
+
+            current = schema::Field::typeIsPrimitive (type)
+                ? nullptr
+                : &notation (schema_.fromType (type));
+        }
+
+        if (current) {
+            const auto * restricted = dynamic_cast<const schema::Restricted *> (current);
+
+            if (!restricted || restricted->restrictedType() != schema::Restricted::enum_t) {
+                bad ("it doesn't refer to a primitive value");
+            }
+
+            // enums are handed to visitors as the string of their value
+            type = "string";
+        }
+
+        return std::make_pair (type, repeated);
+    }
+
+}
+
+/******************************************************************************/
+
+namespace amqp::internal::filter {
+
+    std::ostream &
+    operator << (std::ostream & stream_, const Op & op_) {
+        switch (op_) {
+            case eq_o : stream_ << "="; break;
+            case ne_o : stream_ << "!="; break;
+            case lt_o : stream_ << "<"; break;
+            case le_o : stream_ << "<="; break;
+            case gt_o : stream_ << ">"; break;
+            case ge_o : stream_ << ">="; break;
+        }
+
+        return stream_;
+    }
+
+}
+
+/******************************************************************************
+ *
+ * amqp::internal::filter::Predicate
+ *
+ ******************************************************************************/
+
+amqp::internal::filter::
+Predicate::Predicate (
+    const Clause & clause_,
+    const std::string & type_,
+    bool repeated_
+) : m_op (clause_.op)
+  , m_kind (string_k)
+  , m_integer (0)
+  , m_real (0)
+  , m_boolean (false)
+  , m_repeated (repeated_)
+{
+    auto bad = [&clause_, &type_]() {
+        std::stringstream ss;
+        ss << "Cannot compare " << clause_.path << " of type " << type_
+           << " " << clause_.op << " " << clause_.literal;
+        throw std::runtime_error (ss.str());
+    };
+
+    if (type_ == "int" || type_ == "long" || type_ == "double") {
+        size_t used { 0 };
+
+        try {
+            if (type_ != "double") {
+                m_integer = std::stoll (clause_.literal, &used);
+                m_kind = integer_k;
+            }
+
+            if (used != clause_.literal.size()) {
+                m_real = std::stod (clause_.literal, &used);
+                m_kind = real_k;
+            }
+        } catch (const std::logic_error &) {
+            bad();
+        }
+
+        if (used != clause_.literal.size()) {
+            bad();
+        }
+    } else if (type_ == "boolean") {
+        if (   (clause_.literal != "true" && clause_.literal != "false")
+            || (m_op != eq_o && m_op != ne_o))
+        {
+            bad();
+        }
+
+        m_kind = boolean_k;
+        m_boolean = clause_.literal == "true";
+    } else if (type_ == "string") {
+        m_kind = string_k;
+        m_string = clause_.literal;
+    } else {
+        bad();
+    }
+}
+
+/******************************************************************************/
+
+template<typename T>
+bool
+amqp::internal::filter::
+Predicate::compare (const T & lhs_, const T & rhs_) const {
+    switch (m_op) {
+        case eq_o : return lhs_ == rhs_;
+        case ne_o : return lhs_ != rhs_;
+        case lt_o : return lhs_ < rhs_;
+        case le_o : return lhs_ <= rhs_;
+        case gt_o : return lhs_ > rhs_;
+        case ge_o : return lhs_ >= rhs_;
+    }
+
+    return false;
+}
+
+/******************************************************************************/
+
+bool
+amqp::internal::filter::
+Predicate::test (int64_t value_) const {
+    switch (m_kind) {
+        case integer_k : return compare (value_, m_integer);
+        case real_k    : return compare (static_cast<double> (value_), m_real);
+        default        : return false;
+    }
+}
+
+/******************************************************************************/
+
+bool
+amqp::internal::filter::
+Predicate::test (double value_) const {
+    switch (m_kind) {
+        case integer_k : return compare (value_, static_cast<double> (m_integer));
+        case real_k    : return compare (value_, m_real);
+        default        : return false;
+    }
+}
+
+/******************************************************************************/
+
+bool
+amqp::internal::filter::
+Predicate::test (bool value_) const {
+    return m_kind == boolean_k && compare (value_, m_boolean);
+}
+
+/******************************************************************************/
+
+bool
+amqp::internal::filter::
+Predicate::test (const std::string & value_) const {
+    return m_kind == string_k && compare (value_, m_string);
+}
+
+/******************************************************************************
+ *
+ * amqp::internal::filter::CompiledFilter
+ *
+ ******************************************************************************/
+
+amqp::internal::filter::
+CompiledFilter::CompiledFilter (
+    const sVec<Clause> & clauses_,
+    const schema::ISchemaType & schema_,
+    const std::string & descriptor_
+) {
+    m_predicates.reserve (clauses_.size());
+
+    for (const auto & clause : clauses_) {
+        auto resolved = resolve (clause.path, schema_, descriptor_);
+
+        m_byPath[clause.path].push_back (m_predicates.size());
+        m_predicates.emplace_back (clause, resolved.first, resolved.second);
+    }
+}
+
+/******************************************************************************/
+
+const sVec<size_t> *
+amqp::internal::filter::
+CompiledFilter::forPath (const std::string & path_) const {
+    auto it = m_byPath.find (path_);
+
+    return it == m_byPath.end() ? nullptr : &(it->second);
+}
+
+/******************************************************************************
+ *
+ * amqp::internal::filter::Filter
+ *
+ ******************************************************************************/
+
+amqp::internal::filter::
+Filter::Filter (const std::string & expression_)
+    : m_clauses (parse (expression_))
+{ }
+
+/******************************************************************************/
+
+const amqp::internal::filter::CompiledFilter &
+amqp::internal::filter::
+Filter::compile (
+    const schema::ISchemaType & schema_,
+    const std::string & descriptor_
+) {
+    auto it = m_compiled.find (descriptor_);
+
+    if (it == m_compiled.end()) {
+        it = m_compiled.emplace (
+            descriptor_,
+            std::make_unique<CompiledFilter> (
+                m_clauses, schema_, descriptor_)).first;
+    }
+
+    return *(it->second);
+}
+
+/******************************************************************************/
@@ -0,0 +1,144 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <map>
+#include <string>
+#include <iosfwd>
+#include <unordered_map>
+
+#include "types.h"
+
+#include "amqp/schema/described-types/Schema.h"
+
+/******************************************************************************/
+
+namespace amqp::internal::filter {
+
+    enum Op { eq_o, ne_o, lt_o, le_o, gt_o, ge_o };
+
+    std::ostream & operator << (std::ostream &, const Op &);
+
+    /**
+     * One term of a filter as written by the user, e.g. amount > 10
+     */
+    struct Clause {
+        std::string path;
+        Op          op;
+        std::string literal;
+    };
+
+}
+
+/******************************************************************************/
+
+namespace amqp::internal::filter {
+
+    /**
+     * A [Clause] that has been resolved against a schema. The type of the
+     * field the path refers to is known so the literal has already been
+     * converted to something we can compare directly against the values
+     * the readers hand us.
+     */
+    class Predicate {
+        public :
+            enum Kind { integer_k, real_k, boolean_k, string_k };
+
+        private :
+            Op          m_op;
+            Kind        m_kind;
+            int64_t     m_integer;
+            double      m_real;
+            bool        m_boolean;
+            std::string m_string;
+
+            /**
+             * true when the path passes through a list or map and thus
+             * may be seen many times in a single blob
+             */
+            bool        m_repeated;
+
+            template<typename T>
+            bool compare (const T &, const T &) const;
+
+        public :
+            Predicate (const Clause &, const std::string &, bool);
+
+            bool repeated() const { return m_repeated; }
+
+            bool test (int64_t) const;
+            bool test (double) const;
+            bool test (bool) const;
+            bool test (const std::string &) const;
+    };
+
+}
+
+/******************************************************************************/
+
+namespace amqp::internal::filter {
+
+    /**
+     * The set of [Predicate]s for a single root type, indexed by the path
+     * they apply to
+     */
+    class CompiledFilter {
+        private :
+            sVec<Predicate> m_predicates;
+            std::unordered_map<std::string, sVec<size_t>> m_byPath;
+
+        public :
+            CompiledFilter (
+                const sVec<Clause> &,
+                const schema::ISchemaType &,
+                const std::string &);
+
+            const sVec<Predicate> & predicates() const { return m_predicates; }
+
+            /**
+             * @return the indices of the predicates that apply to the
+             * given path, nullptr if none do
+             */
+            const sVec<size_t> * forPath (const std::string &) const;
+    };
+
+}
+
+/******************************************************************************/
+
+namespace amqp::internal::filter {
+
+    /**
+     * A conjunction of clauses of the form
+     *
+     *      path op literal [and path op literal ...]
+     *
+     * Where path is as described by [reader::PathVisitor], op is one of
+     * = == != < <= > >=, and a literal is a number, true, false, or a
+     * string which may be double quoted.
+     *
+     * Paths that pass through a list or map are satisfied if any of the
+     * values found at that path matches.
+     *
+     * Blobs of the same type share a fingerprint so the work of resolving
+     * the expression against a schema is only done once per type.
+     */
+    class Filter {
+        private :
+            sVec<Clause> m_clauses;
+
+            std::map<std::string, uPtr<CompiledFilter>> m_compiled;
+
+        public :
+            explicit Filter (const std::string &);
+
+            const sVec<Clause> & clauses() const { return m_clauses; }
+
+            const CompiledFilter & compile (
+                const schema::ISchemaType &,
+                const std::string &);
+    };
+
+}
+
+/******************************************************************************/
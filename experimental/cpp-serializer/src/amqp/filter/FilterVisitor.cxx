@@ -0,0 +1,95 @@
+#include "FilterVisitor.h"
+
+/******************************************************************************
+ *
+ * amqp::internal::filter::FilterVisitor
+ *
+ ******************************************************************************/
+
+amqp::internal::filter::
+FilterVisitor::FilterVisitor (const CompiledFilter & filter_)
+    : m_filter (filter_)
+    , m_satisfied (filter_.predicates().size(), false)
+    , m_rejected (false)
+{ }
+
+/******************************************************************************/
+
+template<typename T>
+void
+amqp::internal::filter::
+FilterVisitor::test (const T & value_) {
+    const auto * predicates = m_filter.forPath (leafPath());
+
+    if (!predicates) {
+        return;
+    }
+
+    for (const auto i : *predicates) {
+        const auto & predicate = m_filter.predicates()[i];
+
+        if (predicate.test (value_)) {
+            m_satisfied[i] = true;
+        } else if (!predicate.repeated()) {
+            m_rejected = true;
+        }
+    }
+}
+
+/******************************************************************************/
+
+bool
+amqp::internal::filter::
+FilterVisitor::accepted() const {
+    if (m_rejected) {
+        return false;
+    }
+
+    for (const auto satisfied : m_satisfied) {
+        if (!satisfied) return false;
+    }
+
+    return true;
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::filter::
+FilterVisitor::value (bool value_) {
+    test (value_);
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::filter::
+FilterVisitor::value (int32_t value_) {
+    test (static_cast<int64_t> (value_));
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::filter::
+FilterVisitor::value (int64_t value_) {
+    test (value_);
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::filter::
+FilterVisitor::value (double value_) {
+    test (value_);
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::filter::
+FilterVisitor::value (const std::string & value_) {
+    test (value_);
+}
+
+/******************************************************************************/
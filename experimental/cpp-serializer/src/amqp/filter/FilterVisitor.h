@@ -0,0 +1,48 @@
+#pragma once
+
+/******************************************************************************/
+
+#include "types.h"
+#include "Filter.h"
+
+#include "reader/PathVisitor.h"
+
+/******************************************************************************/
+
+namespace amqp::internal::filter {
+
+    /**
+     * Evaluates a [CompiledFilter] as the readers walk a blob. As soon as
+     * a predicate on a value that can only appear once fails we know the
+     * blob can't match and halt, leaving the readers to skip the rest.
+     */
+    class FilterVisitor : public reader::PathVisitor {
+        private :
+            const CompiledFilter & m_filter;
+
+            sVec<bool> m_satisfied;
+            bool       m_rejected;
+
+            template<typename T>
+            void test (const T &);
+
+        public :
+            explicit FilterVisitor (const CompiledFilter &);
+
+            /**
+             * Only meaningful once the blob has been visited
+             */
+            bool accepted() const;
+
+            bool halted() const override { return m_rejected; }
+
+            void value (bool) override;
+            void value (int32_t) override;
+            void value (int64_t) override;
+            void value (double) override;
+            void value (const std::string &) override;
+    };
+
+}
+
+/******************************************************************************/
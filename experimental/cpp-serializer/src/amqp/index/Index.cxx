@@ -0,0 +1,368 @@
+#include "Index.h"
+
+#include <cerrno>
+#include <cstring>
+#include <string_view>
+#include <charconv>
+#include <sstream>
+#include <ostream>
+#include <algorithm>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "columnar/Column.h"
+
+/******************************************************************************/
+
+namespace {
+
+    const char     magic[] = { 'C', 'I', 'D', 'X' }; // NOLINT
+    const uint32_t version = 1;
+
+    const size_t headerSize  = 32;
+    const size_t keySize     = 24;
+    const size_t blobSize    = 16;
+    const size_t postingSize = 8;
+
+    using amqp::internal::columnar::writeLE;
+
+    uint64_t
+    readLE (const char * at_, size_t bytes_) {
+        uint64_t rtn { 0 };
+        for (size_t i { 0 } ; i < bytes_ ; ++i) {
+            rtn |= static_cast<uint64_t> (
+                    static_cast<unsigned char> (at_[i])) << (8 * i);
+        }
+        return rtn;
+    }
+
+    void
+    pad (std::ostream & out_, size_t written_) {
+        static const char zeros[8] { };
+        out_.write (zeros, (8 - written_ % 8) % 8);
+    }
+
+}
+
+/******************************************************************************
+ *
+ * amqp::internal::index
+ *
+ ******************************************************************************/
+
+std::string
+amqp::internal::index::
+key (
+    const std::string & type_,
+    const std::string & path_,
+    Kind kind_,
+    const std::string & value_
+) {
+    std::string rtn;
+    rtn.reserve (type_.size() + path_.size() + value_.size() + 3);
+
+    rtn += type_;
+    rtn += '\0';
+    rtn += path_;
+    rtn += '\0';
+    rtn += static_cast<char> (kind_);
+    rtn += value_;
+
+    return rtn;
+}
+
+/******************************************************************************
+ *
+ * amqp::internal::index::IndexWriter
+ *
+ ******************************************************************************/
+
+uint32_t
+amqp::internal::index::
+IndexWriter::addBlob (const std::string & name_) {
+    m_blobs.push_back (name_);
+    return static_cast<uint32_t> (m_blobs.size() - 1);
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::index::
+IndexWriter::add (const std::string & key_, const Posting & posting_) {
+    m_postings[key_].push_back (posting_);
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::index::
+IndexWriter::write (std::ostream & out_) const {
+    uint64_t postings { 0 };
+    uint64_t strings { 0 };
+
+    for (const auto & entry : m_postings) {
+        postings += entry.second.size();
+    }
+
+    out_.write (magic, sizeof (magic));
+    writeLE (out_, version, 4);
+    writeLE (out_, m_blobs.size(), 8);
+    writeLE (out_, m_postings.size(), 8);
+    writeLE (out_, postings, 8);
+
+    uint64_t first { 0 };
+    for (const auto & entry : m_postings) {
+        writeLE (out_, strings, 8);
+        writeLE (out_, entry.first.size(), 4);
+        writeLE (out_, entry.second.size(), 4);
+        writeLE (out_, first, 8);
+
+        strings += entry.first.size();
+        first += entry.second.size();
+    }
+
+    for (const auto & blob : m_blobs) {
+        writeLE (out_, strings, 8);
+        writeLE (out_, blob.size(), 8);
+
+        strings += blob.size();
+    }
+
+    for (const auto & entry : m_postings) {
+        for (const auto & posting : entry.second) {
+            writeLE (out_, posting.blob, 4);
+            writeLE (out_, posting.ordinal, 4);
+        }
+    }
+
+    for (const auto & entry : m_postings) {
+        out_.write (entry.first.data(), entry.first.size());
+    }
+
+    for (const auto & blob : m_blobs) {
+        out_.write (blob.data(), blob.size());
+    }
+
+    pad (out_, strings);
+}
+
+/******************************************************************************
+ *
+ * amqp::internal::index::Index
+ *
+ ******************************************************************************/
+
+amqp::internal::index::
+Index::Index (const std::string & path_)
+    : m_base (nullptr)
+    , m_size (0)
+{
+    auto fail = [&path_](const std::string & why_) {
+        std::stringstream ss;
+        ss << "Cannot open index \"" << path_ << "\", " << why_;
+        throw std::runtime_error (ss.str());
+    };
+
+    int fd = open (path_.c_str(), O_RDONLY);
+    if (fd < 0) {
+        fail (strerror (errno));
+    }
+
+    struct stat results { };
+    if (fstat (fd, &results) != 0 || results.st_size < (off_t)headerSize) {
+        close (fd);
+        fail ("it is too short");
+    }
+
+    m_size = results.st_size;
+    auto base = mmap (nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+    close (fd);
+
+    if (base == MAP_FAILED) {
+        fail (strerror (errno));
+    }
+
+    m_base = static_cast<const char *> (base);
+
+    if (   memcmp (m_base, magic, sizeof (magic)) != 0
+        || readLE (m_base + 4, 4) != version)
+    {
+        munmap (base, m_size);
+        fail ("it is not an index");
+    }
+
+    m_blobs    = readLE (m_base + 8, 8);
+    m_keys     = readLE (m_base + 16, 8);
+    m_postings = readLE (m_base + 24, 8);
+
+    auto invalid = [&](const std::string & why_) {
+        munmap (base, m_size);
+        fail (why_);
+    };
+
+    // Everything below comes from the file so check it all lies within
+    // the mapping before anything is trusted, dividing rather than
+    // multiplying the counts so that silly ones can't overflow
+    size_t left = m_size - headerSize;
+
+    auto section = [&](uint64_t count_, size_t entry_) {
+        if (count_ > left / entry_) {
+            invalid ("it is truncated");
+        }
+        left -= count_ * entry_;
+    };
+
+    section (m_keys, keySize);
+    section (m_blobs, blobSize);
+    section (m_postings, postingSize);
+
+    m_keyTable     = m_base + headerSize;
+    m_blobTable    = m_keyTable + m_keys * keySize;
+    m_postingTable = m_blobTable + m_blobs * blobSize;
+    m_strings      = m_postingTable + m_postings * postingSize;
+
+    auto within = [](uint64_t offset_, uint64_t length_, uint64_t size_) {
+        return offset_ <= size_ && length_ <= size_ - offset_;
+    };
+
+    for (uint64_t i { 0 } ; i < m_keys ; ++i) {
+        const char * entry = m_keyTable + i * keySize;
+
+        if (!within (readLE (entry, 8), readLE (entry + 8, 4), left)) {
+            invalid ("a key lies outside the string section");
+        }
+
+        if (!within (readLE (entry + 16, 8), readLE (entry + 12, 4), m_postings)) {
+            invalid ("a key's postings lie outside the posting table");
+        }
+    }
+
+    for (uint64_t i { 0 } ; i < m_blobs ; ++i) {
+        const char * entry = m_blobTable + i * blobSize;
+
+        if (!within (readLE (entry, 8), readLE (entry + 8, 8), left)) {
+            invalid ("a blob name lies outside the string section");
+        }
+    }
+
+    for (uint64_t i { 0 } ; i < m_postings ; ++i) {
+        if (readLE (m_postingTable + i * postingSize, 4) >= m_blobs) {
+            invalid ("a posting refers to a blob it does not have");
+        }
+    }
+}
+
+/******************************************************************************/
+
+amqp::internal::index::
+Index::~Index() {
+    munmap (const_cast<char *> (m_base), m_size);
+}
+
+/******************************************************************************/
+
+std::string_view
+amqp::internal::index::
+Index::blob (uint32_t blob_) const {
+    if (blob_ >= m_blobs) {
+        std::stringstream ss;
+        ss << "Index has no blob " << blob_;
+        throw std::out_of_range (ss.str());
+    }
+
+    const char * entry = m_blobTable + blob_ * blobSize;
+
+    return std::string_view (
+        m_strings + readLE (entry, 8),
+        readLE (entry + 8, 8));
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::index::
+Index::find (const std::string & key_, sVec<Posting> & out_) const {
+    size_t lo { 0 }, hi { m_keys };
+
+    while (lo < hi) {
+        auto mid = lo + (hi - lo) / 2;
+        const char * entry = m_keyTable + mid * keySize;
+
+        std::string_view candidate (
+            m_strings + readLE (entry, 8),
+            readLE (entry + 8, 4));
+
+        auto cmp = candidate.compare (key_);
+
+        if (cmp < 0) {
+            lo = mid + 1;
+        } else if (cmp > 0) {
+            hi = mid;
+        } else {
+            auto count = readLE (entry + 12, 4);
+            const char * posting = m_postingTable
+                    + readLE (entry + 16, 8) * postingSize;
+
+            out_.reserve (out_.size() + count);
+
+            for (uint64_t i { 0 } ; i < count ; ++i, posting += postingSize) {
+                out_.push_back ({
+                    static_cast<uint32_t> (readLE (posting, 4)),
+                    static_cast<uint32_t> (readLE (posting + 4, 4)) });
+            }
+
+            return;
+        }
+    }
+}
+
+/******************************************************************************/
+
+sVec<amqp::internal::index::Posting>
+amqp::internal::index::
+Index::lookup (
+    const std::string & type_,
+    const std::string & path_,
+    const std::string & value_
+) const {
+    sVec<Posting> rtn;
+
+    find (key (type_, path_, string_k, value_), rtn);
+
+    auto merge = [&](Kind kind_, const std::string & value_) {
+        find (key (type_, path_, kind_, value_), rtn);
+    };
+
+    const char * first = value_.data();
+    const char * last  = first + value_.size();
+
+    int64_t integer;
+    auto ir = std::from_chars (first, last, integer);
+    if (ir.ec == std::errc() && ir.ptr == last) {
+        merge (integer_k, std::to_string (integer));
+    }
+
+    double real;
+    auto rr = std::from_chars (first, last, real);
+    if (rr.ec == std::errc() && rr.ptr == last) {
+        char buf[32];
+        auto end = std::to_chars (buf, buf + sizeof (buf), real).ptr;
+        merge (real_k, std::string (buf, end));
+    }
+
+    if (value_ == "true" || value_ == "false") {
+        merge (boolean_k, value_);
+    }
+
+    std::sort (rtn.begin(), rtn.end(), [](const auto & a_, const auto & b_) {
+        return a_.blob < b_.blob || (a_.blob == b_.blob && a_.ordinal < b_.ordinal);
+    });
+
+    return rtn;
+}
+
+/******************************************************************************/
@@ -0,0 +1,158 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <map>
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <iosfwd>
+
+#include "types.h"
+
+/******************************************************************************/
+
+namespace amqp::internal::index {
+
+    /**
+     * Where a value was seen. Proton doesn't tell us where in the encoded
+     * bytes a value came from so rather than a byte offset we record which
+     * occurrence of the field within the blob it was, i.e. the n'th value
+     * at that path.
+     */
+    struct Posting {
+        uint32_t blob;
+        uint32_t ordinal;
+    };
+
+    /**
+     * Every key carries the kind of the value it was built from so that
+     * 10, 10.0 and "10" remain distinct
+     */
+    enum Kind : char {
+        integer_k = 'i',
+        real_k    = 'r',
+        boolean_k = 'b',
+        string_k  = 's'
+    };
+
+    std::string key (
+        const std::string &,
+        const std::string &,
+        Kind,
+        const std::string &);
+
+}
+
+/******************************************************************************/
+
+namespace amqp::internal::index {
+
+    /**
+     * Accumulates postings for a corpus of blobs and writes them out in a
+     * form [Index] can map straight into memory. Every integer is little
+     * endian and every section is 8 byte aligned.
+     *
+     *      magic       : 4 bytes "CIDX"
+     *      version     : u32 (1)
+     *      blobs       : u64
+     *      keys        : u64
+     *      postings    : u64
+     *
+     *      keys * {
+     *          offset  : u64 into the string section
+     *          length  : u32
+     *          count   : u32 number of postings
+     *          first   : u64 index of the first posting
+     *      }           - sorted by the bytes of the key
+     *
+     *      blobs * {
+     *          offset  : u64 into the string section
+     *          length  : u64
+     *      }
+     *
+     *      postings * {
+     *          blob    : u32
+     *          ordinal : u32
+     *      }
+     *
+     *      strings     : the keys followed by the names of the blobs
+     *
+     * Keys are the type of the blob, the path to the field, the kind of
+     * the value and its textual form separated by NUL bytes.
+     */
+    class IndexWriter {
+        private :
+            sVec<std::string> m_blobs;
+
+            std::map<std::string, sVec<Posting>> m_postings;
+
+        public :
+            uint32_t addBlob (const std::string &);
+
+            void add (const std::string &, const Posting &);
+
+            void write (std::ostream &) const;
+    };
+
+}
+
+/******************************************************************************/
+
+namespace amqp::internal::index {
+
+    /**
+     * A read only, memory mapped, view of a file written by [IndexWriter].
+     * Lookups are a binary search over the key table, comparing keys in
+     * place, and blob names are views into the mapping. The only thing
+     * built is the result of [lookup], postings being decoded straight
+     * into it.
+     */
+    class Index {
+        private :
+            const char * m_base;
+            size_t       m_size;
+
+            uint64_t m_blobs;
+            uint64_t m_keys;
+            uint64_t m_postings;
+
+            const char * m_keyTable;
+            const char * m_blobTable;
+            const char * m_postingTable;
+            const char * m_strings;
+
+            /**
+             * Append the postings for a key to [out_]
+             */
+            void find (const std::string &, sVec<Posting> & out_) const;
+
+        public :
+            explicit Index (const std::string &);
+            Index (const Index &) = delete;
+
+            ~Index();
+
+            uint64_t blobs() const { return m_blobs; }
+            uint64_t keys() const { return m_keys; }
+
+            /**
+             * The name of a blob, valid for as long as the index is
+             */
+            std::string_view blob (uint32_t) const;
+
+            /**
+             * Find every occurrence of a value at the given path in blobs
+             * of the given type. The value is matched against each kind
+             * it could be read as, e.g. "1" as both an integer and a
+             * string.
+             */
+            sVec<Posting> lookup (
+                const std::string &,
+                const std::string &,
+                const std::string &) const;
+    };
+
+}
+
+/******************************************************************************/
@@ -0,0 +1,82 @@
+#include "IndexVisitor.h"
+
+#include <charconv>
+
+/******************************************************************************
+ *
+ * amqp::internal::index::IndexVisitor
+ *
+ ******************************************************************************/
+
+amqp::internal::index::
+IndexVisitor::IndexVisitor (IndexWriter & writer_, uint32_t blob_)
+    : m_writer (writer_)
+    , m_blob (blob_)
+{ }
+
+/******************************************************************************/
+
+void
+amqp::internal::index::
+IndexVisitor::add (Kind kind_, const std::string & value_) {
+    const auto & path = leafPath();
+    auto ordinal = m_ordinals[path]++;
+
+    m_writer.add (key (m_type, path, kind_, value_), { m_blob, ordinal });
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::index::
+IndexVisitor::beginComposite (const std::string & type_) {
+    if (root()) {
+        m_type = type_;
+    }
+
+    PathVisitor::beginComposite (type_);
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::index::
+IndexVisitor::value (bool value_) {
+    add (boolean_k, value_ ? "true" : "false");
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::index::
+IndexVisitor::value (int32_t value_) {
+    add (integer_k, std::to_string (value_));
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::index::
+IndexVisitor::value (int64_t value_) {
+    add (integer_k, std::to_string (value_));
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::index::
+IndexVisitor::value (double value_) {
+    char buf[32];
+    auto end = std::to_chars (buf, buf + sizeof (buf), value_).ptr;
+    add (real_k, std::string (buf, end));
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::index::
+IndexVisitor::value (const std::string & value_) {
+    add (string_k, value_);
+}
+
+/******************************************************************************/
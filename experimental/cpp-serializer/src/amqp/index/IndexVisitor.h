@@ -0,0 +1,46 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <string>
+#include <unordered_map>
+
+#include "types.h"
+#include "Index.h"
+
+#include "reader/PathVisitor.h"
+
+/******************************************************************************/
+
+namespace amqp::internal::index {
+
+    /**
+     * Adds a [Posting] to an [IndexWriter] for every primitive in a single
+     * blob, keyed on the type of the blob, the path to the value and the
+     * value itself.
+     */
+    class IndexVisitor : public reader::PathVisitor {
+        private :
+            IndexWriter & m_writer;
+            uint32_t      m_blob;
+            std::string   m_type;
+
+            std::unordered_map<std::string, uint32_t> m_ordinals;
+
+            void add (Kind, const std::string &);
+
+        public :
+            IndexVisitor (IndexWriter &, uint32_t);
+
+            void beginComposite (const std::string &) override;
+
+            void value (bool) override;
+            void value (int32_t) override;
+            void value (int64_t) override;
+            void value (double) override;
+            void value (const std::string &) override;
+    };
+
+}
+
+/******************************************************************************/
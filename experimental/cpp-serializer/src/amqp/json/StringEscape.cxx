@@ -0,0 +1,211 @@
+#include "StringEscape.h"
+
+#include <cstdint>
+
+#if defined (__GNUC__) && (defined (__x86_64__) || defined (__i386__))
+#   define AMQP_JSON_X86
+#   include <immintrin.h>
+#endif
+
+/******************************************************************************/
+
+namespace {
+
+    inline bool
+    plain (unsigned char c_) {
+        return c_ >= 0x20 && c_ < 0x80 && c_ != '"' && c_ != '\\';
+    }
+
+    /**
+     * @return the length of the well formed UTF-8 sequence at the start
+     * of [str_] or 0 if there isn't one. Overlong encodings, surrogates
+     * and code points beyond U+10FFFF are all rejected.
+     */
+    size_t
+    utf8Length (const unsigned char * str_, size_t len_) {
+        auto c = str_[0];
+
+        size_t   need;
+        uint32_t cp;
+
+        if      (c >= 0xC2 && c <= 0xDF) { need = 2; cp = c & 0x1F; }
+        else if (c >= 0xE0 && c <= 0xEF) { need = 3; cp = c & 0x0F; }
+        else if (c >= 0xF0 && c <= 0xF4) { need = 4; cp = c & 0x07; }
+        else return 0;
+
+        if (need > len_) return 0;
+
+        for (size_t i { 1 } ; i < need ; ++i) {
+            if ((str_[i] & 0xC0) != 0x80) return 0;
+            cp = (cp << 6) | (str_[i] & 0x3F);
+        }
+
+        if (   (need == 3 && cp < 0x800)
+            || (need == 4 && cp < 0x10000)
+            || (cp >= 0xD800 && cp <= 0xDFFF)
+            || cp > 0x10FFFF)
+        {
+            return 0;
+        }
+
+        return need;
+    }
+
+    void
+    escape (std::string & out_, unsigned char c_) {
+        static const char hex[] = "0123456789abcdef";
+
+        switch (c_) {
+            case '"'  : out_ += "\\\""; break;
+            case '\\' : out_ += "\\\\"; break;
+            case '\b' : out_ += "\\b"; break;
+            case '\f' : out_ += "\\f"; break;
+            case '\n' : out_ += "\\n"; break;
+            case '\r' : out_ += "\\r"; break;
+            case '\t' : out_ += "\\t"; break;
+            default   : {
+                char buf[] = { '\\', 'u', '0', '0', hex[c_ >> 4], hex[c_ & 0xF] };
+                out_.append (buf, sizeof (buf));
+            }
+        }
+    }
+
+#ifdef AMQP_JSON_X86
+
+    /*
+     * A byte needs attention if it's a quote, a backslash, or less than
+     * 0x20 when compared as signed, which catches both the control
+     * characters and every byte with the top bit set.
+     */
+
+    size_t
+    plainPrefixSSE2 (const char * str_, size_t len_) {
+        const auto quote = _mm_set1_epi8 ('"');
+        const auto slash = _mm_set1_epi8 ('\\');
+        const auto space = _mm_set1_epi8 (0x20);
+
+        size_t i { 0 };
+        for ( ; i + 16 <= len_ ; i += 16) {
+            auto v = _mm_loadu_si128 (reinterpret_cast<const __m128i *> (str_ + i));
+
+            auto mask = _mm_movemask_epi8 (
+                _mm_or_si128 (
+                    _mm_or_si128 (
+                        _mm_cmpeq_epi8 (v, quote),
+                        _mm_cmpeq_epi8 (v, slash)),
+                    _mm_cmplt_epi8 (v, space)));
+
+            if (mask) {
+                return i + __builtin_ctz (mask);
+            }
+        }
+
+        return i + amqp::internal::json::plainPrefixScalar (str_ + i, len_ - i);
+    }
+
+    __attribute__ ((target ("avx2")))
+    size_t
+    plainPrefixAVX2 (const char * str_, size_t len_) {
+        const auto quote = _mm256_set1_epi8 ('"');
+        const auto slash = _mm256_set1_epi8 ('\\');
+        const auto space = _mm256_set1_epi8 (0x20);
+
+        size_t i { 0 };
+        for ( ; i + 32 <= len_ ; i += 32) {
+            auto v = _mm256_loadu_si256 (reinterpret_cast<const __m256i *> (str_ + i));
+
+            auto mask = static_cast<uint32_t> (_mm256_movemask_epi8 (
+                _mm256_or_si256 (
+                    _mm256_or_si256 (
+                        _mm256_cmpeq_epi8 (v, quote),
+                        _mm256_cmpeq_epi8 (v, slash)),
+                    _mm256_cmpgt_epi8 (space, v))));
+
+            if (mask) {
+                return i + __builtin_ctz (mask);
+            }
+        }
+
+        return i + plainPrefixSSE2 (str_ + i, len_ - i);
+    }
+
+    using scan_t = size_t (*)(const char *, size_t);
+
+    scan_t
+    selectScan() {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports ("avx2") ? plainPrefixAVX2 : plainPrefixSSE2;
+    }
+
+#endif
+
+}
+
+/******************************************************************************/
+
+size_t
+amqp::internal::json::
+plainPrefixScalar (const char * str_, size_t len_) {
+    size_t i { 0 };
+    while (i < len_ && plain (static_cast<unsigned char> (str_[i]))) ++i;
+    return i;
+}
+
+/******************************************************************************/
+
+size_t
+amqp::internal::json::
+plainPrefix (const char * str_, size_t len_) {
+#ifdef AMQP_JSON_X86
+    static const scan_t scan = selectScan();
+
+    return scan (str_, len_);
+#else
+    return plainPrefixScalar (str_, len_);
+#endif
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::json::
+appendQuoted (std::string & out_, const char * str_, size_t len_) {
+    out_.reserve (out_.size() + len_ + 2);
+    out_ += '"';
+
+    const auto * bytes = reinterpret_cast<const unsigned char *> (str_);
+
+    size_t i { 0 };
+    while (true) {
+        auto run = plainPrefix (str_ + i, len_ - i);
+        out_.append (str_ + i, run);
+        i += run;
+
+        if (i == len_) break;
+
+        if (bytes[i] < 0x80) {
+            escape (out_, bytes[i]);
+            ++i;
+        } else if (auto n = utf8Length (bytes + i, len_ - i)) {
+            out_.append (str_ + i, n);
+            i += n;
+        } else {
+            out_ += "\\ufffd";
+            ++i;
+        }
+    }
+
+    out_ += '"';
+}
+
+/******************************************************************************/
+
+std::string
+amqp::internal::json::
+quote (std::string_view str_) {
+    std::string rtn;
+    appendQuoted (rtn, str_.data(), str_.size());
+    return rtn;
+}
+
+/******************************************************************************/
@@ -0,0 +1,38 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <string>
+#include <cstddef>
+#include <string_view>
+
+/******************************************************************************/
+
+namespace amqp::internal::json {
+
+    /**
+     * Append [str_] to [out_] as a quoted JSON string. Quotes, backslashes
+     * and control characters are escaped and anything that isn't valid
+     * UTF-8 is replaced, byte by byte, with U+FFFD so the output is always
+     * well formed.
+     *
+     * The common case of a string with nothing in it that needs attention
+     * is found with SSE2, or AVX2 where the CPU supports it, and copied
+     * across in bulk. Other platforms fall back to a scalar scan.
+     */
+    void appendQuoted (std::string & out_, const char * str_, size_t len_);
+
+    std::string quote (std::string_view);
+
+    /**
+     * The number of leading bytes of [str_] that are printable ASCII
+     * and neither a quote nor a backslash, i.e. that can be copied as
+     * is. Exposed so the vectorised and scalar scans can be tested
+     * against each other.
+     */
+    size_t plainPrefix (const char * str_, size_t len_);
+    size_t plainPrefixScalar (const char * str_, size_t len_);
+
+}
+
+/******************************************************************************/
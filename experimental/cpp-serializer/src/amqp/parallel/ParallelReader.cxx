@@ -0,0 +1,231 @@
+#include "ParallelReader.h"
+#include "Run.h"
+
+#include <sstream>
+#include <exception>
+#include <functional>
+
+#include "scan/Tape.h"
+#include "scan/Scanner.h"
+#include "trace/Trace.h"
+#include "reader/RestrictedReader.h"
+#include "amqp/schema/described-types/Composite.h"
+
+/******************************************************************************/
+
+namespace {
+
+    void
+    writeBE (std::string & out_, uint32_t value_) {
+        for (int i { 3 } ; i >= 0 ; --i) {
+            out_ += static_cast<char> ((value_ >> (8 * i)) & 0xFF);
+        }
+    }
+
+}
+
+/******************************************************************************
+ *
+ * amqp::internal::parallel
+ *
+ ******************************************************************************/
+
+std::pair<std::string, std::string_view>
+amqp::internal::parallel::
+splitEnvelope (const char * bytes_, size_t size_) {
+    scan::Scanner scanner (bytes_, size_);
+
+    auto envelope = scanner.children (scanner.at (0));
+    auto entries = scanner.children (envelope[1]);
+
+    if (entries.empty() || entries[0].code != 0x00) {
+        throw std::runtime_error ("Expected a described object in the envelope");
+    }
+
+    auto object = scanner.children (entries[0]);
+
+    std::string body;
+    body += static_cast<char> (0x00);
+    body += scanner.raw (object[0]);
+    body += static_cast<char> (0x45);
+
+    for (size_t i { 1 } ; i < entries.size() ; ++i) {
+        body += scanner.raw (entries[i]);
+    }
+
+    std::string rtn;
+    rtn.reserve (body.size() + envelope[0].size + 10);
+
+    rtn += static_cast<char> (0x00);
+    rtn += scanner.raw (envelope[0]);
+    rtn += static_cast<char> (0xD0);
+    writeBE (rtn, static_cast<uint32_t> (body.size() + 4));
+    writeBE (rtn, static_cast<uint32_t> (entries.size()));
+    rtn += body;
+
+    return { std::move (rtn), scanner.raw (entries[0]) };
+}
+
+/******************************************************************************
+ *
+ * amqp::internal::parallel::ParallelReader
+ *
+ ******************************************************************************/
+
+amqp::internal::parallel::
+ParallelReader::ParallelReader (size_t threads_, size_t minElements_)
+    : m_threads (std::max<size_t> (threads_, 1))
+    , m_minElements (std::max<size_t> (minElements_, 1))
+{ }
+
+/******************************************************************************/
+
+uPtr<amqp::reader::IValue>
+amqp::internal::parallel::
+ParallelReader::dump (
+    amqp::reader::Name name_,
+    const char * bytes_,
+    size_t size_,
+    const reader::CompositeReader & reader_,
+    const reader::Reader::SchemaType & schema_
+) const {
+    trace::Span span ("ParallelReader::dump", &reader_.type());
+
+    std::unique_ptr<scan::Tape> tape;
+
+    {
+        trace::Span scan ("scan::Tape");
+        tape = std::make_unique<scan::Tape> (bytes_, size_);
+    }
+
+    auto root = tape->root();
+    if (!root.isDescribed()) {
+        throw std::runtime_error ("Expected a described composite");
+    }
+
+    const auto & it = schema_.fromDescriptor (
+            std::string (root.descriptor().get<std::string_view>()));
+
+    const auto & fields = dynamic_cast<const schema::Composite &> (
+            *(it->second.get())).fields();
+
+    const auto & readers = reader_.readers();
+
+    auto body = root.value();
+    body.list();
+
+    sVec<scan::Cursor> values;
+    values.reserve (body.count());
+
+    if (body.count()) {
+        auto value = body.first();
+        for (size_t i { 0 } ; i < body.count() ; ++i, value.next()) {
+            values.push_back (value);
+        }
+    }
+
+    if (values.size() != readers.size() || fields.size() != readers.size()) {
+        std::stringstream ss;
+        ss << "Composite " << reader_.type() << " has " << readers.size()
+           << " properties but " << values.size() << " were encoded";
+        throw std::runtime_error (ss.str());
+    }
+
+    /*
+     * Find the biggest list or map amongst the properties to split up.
+     * Collections are always described so we look inside for the list
+     * or map itself.
+     */
+    auto split = values.size();
+    size_t elements { 0 };
+
+    for (size_t i { 0 } ; i < values.size() ; ++i) {
+        if (!values[i].isDescribed()) continue;
+
+        auto node = values[i].value();
+
+        size_t n = node.isList() ? node.count()
+                 : node.isMap() ? node.count() / 2
+                 : 0;
+
+        if (   n >= m_minElements
+            && n > elements
+            && dynamic_cast<const reader::RestrictedReader *> (
+                    readers[i].lock().get()))
+        {
+            split = i;
+            elements = n;
+        }
+    }
+
+    sVec<std::function<void()>> tasks;
+    sVec<uPtr<amqp::reader::IValue>> read (values.size());
+
+    for (size_t i { 0 } ; i < values.size() ; ++i) {
+        if (i == split) continue;
+
+        tasks.emplace_back ([&, i]() {
+            read[i] = readers[i].lock()->dump (
+                fields[i]->name(), values[i], schema_);
+        });
+    }
+
+    sVec<sVec<uPtr<amqp::reader::IValue>>> slices;
+
+    if (split != values.size()) {
+        auto reader = std::dynamic_pointer_cast<reader::RestrictedReader> (
+                readers[split].lock());
+
+        auto collection = reader::RestrictedReader::collection (
+                values[split], schema_);
+
+        size_t width = collection.isMap() ? 2 : 1;
+
+        auto count = std::min (m_threads, elements);
+        slices.resize (count);
+
+        // Stepping over an element on the tape is a single load so
+        // finding where each slice starts is cheap next to reading it
+        auto element = collection.first();
+        size_t at { 0 };
+
+        for (size_t s { 0 } ; s < count ; ++s) {
+            auto first = elements * s / count;
+            auto last = elements * (s + 1) / count;
+
+            for ( ; at < first * width ; ++at) {
+                element.next();
+            }
+
+            tasks.emplace_back ([&, s, first, last, element, reader]() {
+                trace::Span slice ("ParallelReader::slice", &reader->type());
+
+                slices[s] = reader->dumpElements (
+                    element, last - first, schema_);
+            });
+        }
+    }
+
+    run (tasks, m_threads);
+
+    if (split != values.size()) {
+        sVec<uPtr<amqp::reader::IValue>> all;
+        all.reserve (elements);
+
+        for (auto & part : slices) {
+            for (auto & element : part) {
+                all.emplace_back (std::move (element));
+            }
+        }
+
+        read[split] = std::dynamic_pointer_cast<reader::RestrictedReader> (
+            readers[split].lock())->wrapElements (
+                fields[split]->name(), std::move (all));
+    }
+
+    return std::make_unique<reader::TypedPair<sVec<uPtr<amqp::reader::IValue>>>> (
+        name_,
+        std::move (read));
+}
+
+/******************************************************************************/
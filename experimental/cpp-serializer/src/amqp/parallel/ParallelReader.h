@@ -0,0 +1,74 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <string>
+#include <utility>
+#include <string_view>
+
+#include "types.h"
+
+#include "reader/CompositeReader.h"
+
+/******************************************************************************/
+
+namespace amqp::internal::parallel {
+
+    /**
+     * Split the encoding of a Corda envelope in two. A copy of the
+     * envelope with the object replaced by an empty list, which still
+     * has everything needed to build the readers but is quick to decode,
+     * and a view of the encoding of the object itself within [bytes_].
+     */
+    std::pair<std::string, std::string_view> splitEnvelope (
+        const char * bytes_,
+        size_t);
+
+}
+
+/******************************************************************************/
+
+namespace amqp::internal::parallel {
+
+    /**
+     * Reads a single composite spreading the work across several threads.
+     *
+     * Proton can only decode a buffer from start to finish into one tree
+     * that a single thread walks. Rather than hand it the object we index
+     * the raw encoding once with a [scan::Tape], which finds where every
+     * property and, for the largest list or map amongst them, each of its
+     * elements begins. Every property and each slice of that collection
+     * is then read independently, straight from the buffer, with the same
+     * readers, the results being put back together in order so the output
+     * is identical to reading it in one go.
+     *
+     * Collections with fewer than [minElements] elements aren't worth
+     * the overhead and are read whole.
+     */
+    class ParallelReader {
+        private :
+            size_t m_threads;
+            size_t m_minElements;
+
+        public :
+            static constexpr size_t defaultMinElements = 4096;
+
+            explicit ParallelReader (
+                size_t,
+                size_t = defaultMinElements);
+
+            /**
+             * @param bytes_ the encoding of the described composite itself,
+             * not the envelope that wraps it
+             */
+            uPtr<amqp::reader::IValue> dump (
+                amqp::reader::Name,
+                const char *,
+                size_t,
+                const reader::CompositeReader &,
+                const reader::Reader::SchemaType &) const;
+    };
+
+}
+
+/******************************************************************************/
@@ -0,0 +1,167 @@
+#include "Run.h"
+
+#include <mutex>
+#include <deque>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <exception>
+#include <condition_variable>
+
+/******************************************************************************/
+
+namespace {
+
+    /**
+     * One call to [run]. Shared with the pool's threads so that one which
+     * only gets round to it after every task has finished, and the caller
+     * has returned, finds nothing left to do rather than a dead frame.
+     */
+    struct Batch {
+        sVec<std::function<void()>> * tasks;
+        size_t size;
+
+        std::atomic<size_t> next { 0 };
+        sVec<std::exception_ptr> errors;
+
+        std::mutex lock;
+        std::condition_variable finished;
+        size_t done { 0 };
+
+        explicit Batch (sVec<std::function<void()>> & tasks_)
+            : tasks (&tasks_)
+            , size (tasks_.size())
+            , errors (tasks_.size())
+        { }
+
+        void work() {
+            for (auto i = next++ ; i < size ; i = next++) {
+                try {
+                    (*tasks)[i]();
+                } catch (...) {
+                    errors[i] = std::current_exception();
+                }
+
+                std::lock_guard<std::mutex> guard (lock);
+                if (++done == size) {
+                    finished.notify_all();
+                }
+            }
+        }
+    };
+
+    /**
+     * Threads kept for the life of the process, grown to the most any
+     * call to [run] has asked for, so reading one blob after another
+     * doesn't pay to start and join a thread per task each time
+     */
+    class Pool {
+        private :
+            std::mutex m_lock;
+            std::condition_variable m_wake;
+            std::deque<sPtr<Batch>> m_batches;
+            sVec<std::thread> m_threads;
+            bool m_stop { false };
+
+            void worker() {
+                for (;;) {
+                    sPtr<Batch> batch;
+
+                    {
+                        std::unique_lock<std::mutex> lock (m_lock);
+                        m_wake.wait (lock, [this] {
+                            return m_stop || !m_batches.empty();
+                        });
+
+                        if (m_batches.empty()) {
+                            return;
+                        }
+
+                        batch = std::move (m_batches.front());
+                        m_batches.pop_front();
+                    }
+
+                    batch->work();
+                }
+            }
+
+        public :
+            ~Pool() {
+                {
+                    std::lock_guard<std::mutex> lock (m_lock);
+                    m_stop = true;
+                }
+
+                m_wake.notify_all();
+
+                for (auto & thread : m_threads) {
+                    thread.join();
+                }
+            }
+
+            /**
+             * Have [helpers_] of the pool's threads join in with [batch_]
+             */
+            void post (const sPtr<Batch> & batch_, size_t helpers_) {
+                {
+                    std::lock_guard<std::mutex> lock (m_lock);
+
+                    while (m_threads.size() < helpers_) {
+                        m_threads.emplace_back (&Pool::worker, this);
+                    }
+
+                    for (size_t i { 0 } ; i < helpers_ ; ++i) {
+                        m_batches.push_back (batch_);
+                    }
+                }
+
+                m_wake.notify_all();
+            }
+    };
+
+    Pool &
+    pool() {
+        static Pool pool; // NOLINT
+
+        return pool;
+    }
+
+}
+
+/******************************************************************************/
+
+/**
+ * The caller works through the tasks too and only waits for them, not
+ * for the pool's threads, to finish. A task that itself calls [run]
+ * from one of the pool's threads therefore can't deadlock waiting on
+ * threads that are all busy.
+ */
+void
+amqp::internal::parallel::
+run (sVec<std::function<void()>> & tasks_, size_t threads_) {
+    if (tasks_.empty()) {
+        return;
+    }
+
+    auto batch = std::make_shared<Batch> (tasks_);
+
+    auto helpers = std::min (threads_, tasks_.size());
+    if (helpers > 1) {
+        pool().post (batch, helpers - 1);
+    }
+
+    batch->work();
+
+    {
+        std::unique_lock<std::mutex> lock (batch->lock);
+        batch->finished.wait (lock, [&batch] {
+            return batch->done == batch->size;
+        });
+    }
+
+    for (const auto & error : batch->errors) {
+        if (error) std::rethrow_exception (error);
+    }
+}
+
+/******************************************************************************/
@@ -0,0 +1,22 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <functional>
+
+#include "types.h"
+
+/******************************************************************************/
+
+namespace amqp::internal::parallel {
+
+    /**
+     * Run every task using up to [threads_] threads, the calling thread
+     * being one of them and the rest coming from a pool shared by every
+     * call, rethrowing the first failure once they've all finished
+     */
+    void run (sVec<std::function<void()>> &, size_t threads_);
+
+}
+
+/******************************************************************************/
@@ -10,6 +10,8 @@
 #include "Reader.h"
 #include "amqp/reader/IReader.h"
 #include "proton/proton_wrapper.h"
+#include "scan/Tape.h"
+#include "trace/Trace.h"
 
 /******************************************************************************/
 
@@ -27,12 +29,16 @@ CompositeReader::m_name { // NOLINT
 amqp::internal::reader::
 CompositeReader::CompositeReader (
         std::string type_,
-        sVec<std::weak_ptr<Reader>> & readers_
+        sVec<std::weak_ptr<Reader>> & readers_,
+        sVec<amqp::reader::Name> names_
 ) : m_readers (readers_)
+  , m_names (std::move (names_))
   , m_type (std::move (type_))
 {
+    assert (m_names.size() == m_readers.size());
+
     DBG ("MAKE CompositeReader: " << m_type << ": " << m_readers.size() << std::endl); // NOLINT
-    for (auto const reader : m_readers) {
+    for (const auto & reader : m_readers) {
         assert (reader.lock());
         if (auto r = reader.lock()) {
             DBG ("  prop: " << r->name() << " " << r->type() << std::endl); // NOLINT
@@ -84,6 +90,8 @@ CompositeReader::_dump (
         pn_data_t * data_,
         const SchemaType & schema_
 ) const {
+    trace::Span span ("CompositeReader::dump", &m_type);
+
     DBG ("Read Composite: "
         << m_name
         << " : "
@@ -110,12 +118,12 @@ CompositeReader::_dump (
     {
         proton::auto_enter ae (data_);
 
-        for (int i (0) ; i < m_readers.size() ; ++i) {
+        for (size_t i (0) ; i < m_readers.size() ; ++i) {
             if (auto l =  m_readers[i].lock()) {
                 DBG (fields[i]->name() << " "
                     << (l ? "true" : "false") << std::endl); // NOLINT
 
-                read.emplace_back (l->dump (fields[i]->name(), data_, schema_));
+                read.emplace_back (l->dump (m_names[i], data_, schema_));
             } else {
                 std::stringstream s;
                 s << "null field reader: " << fields[i]->name();
@@ -132,7 +140,7 @@ CompositeReader::_dump (
 uPtr<amqp::reader::IValue>
 amqp::internal::reader::
 CompositeReader::dump (
-    const std::string & name_,
+    amqp::reader::Name name_,
     pn_data_t * data_,
     const SchemaType & schema_) const
 {
@@ -162,3 +170,170 @@ CompositeReader::dump (
 
 /******************************************************************************/
 
+
+/**
+ * Walk the composite in the same way as [_dump] but rather than building
+ * up a tree of values, drive [visitor_] with each property as we go
+ */
+void
+amqp::internal::reader::
+CompositeReader::visit (
+    pn_data_t * data_,
+    const SchemaType & schema_,
+    amqp::reader::IVisitor & visitor_) const
+{
+    trace::Span span ("CompositeReader::visit", &m_type);
+
+    proton::auto_next an (data_);
+
+    proton::is_described (data_);
+    proton::auto_enter ae (data_);
+
+    const auto & it = schema_.fromDescriptor (
+            proton::get_symbol<std::string>(data_));
+
+    auto & fields = dynamic_cast<schema::Composite &> (
+            *(it->second.get())).fields();
+
+    assert (fields.size() == m_readers.size());
+
+    pn_data_next (data_);
+
+    proton::is_list (data_);
+
+    visitor_.beginComposite (type());
+    {
+        proton::auto_enter ae (data_);
+
+        for (size_t i (0) ; i < m_readers.size() && !visitor_.halted() ; ++i) {
+            if (auto l =  m_readers[i].lock()) {
+                visitor_.property (m_names[i].str());
+                l->visit (data_, schema_, visitor_);
+            } else {
+                std::stringstream s;
+                s << "null field reader: " << fields[i]->name();
+                throw std::runtime_error (s.str());
+            }
+        }
+    }
+    visitor_.endComposite();
+}
+
+/******************************************************************************/
+
+const sVec<uPtr<amqp::internal::schema::Field>> &
+amqp::internal::reader::
+CompositeReader::fields (
+    const scan::Cursor & cursor_,
+    const SchemaType & schema_
+) const {
+    const auto & it = schema_.fromDescriptor (
+            std::string { cursor_.descriptor().get<std::string_view>() });
+
+    auto & fields = dynamic_cast<schema::Composite &> (
+            *(it->second.get())).fields();
+
+    assert (fields.size() == m_readers.size());
+
+    auto list = cursor_.value();
+    list.list();
+
+    if (list.count() != m_readers.size()) {
+        std::stringstream s;
+        s << type() << " has " << m_readers.size() << " properties but "
+          << list.count() << " were encoded";
+        throw std::runtime_error (s.str());
+    }
+
+    return fields;
+}
+
+/******************************************************************************/
+
+sVec<uPtr<amqp::reader::IValue>>
+amqp::internal::reader::
+CompositeReader::_dump (
+    const scan::Cursor & cursor_,
+    const SchemaType & schema_
+) const {
+    trace::Span span ("CompositeReader::dump", &m_type);
+
+    auto & fields = this->fields (cursor_, schema_);
+
+    sVec<uPtr<amqp::reader::IValue>> read;
+    read.reserve (fields.size());
+
+    auto property = cursor_.value().first();
+
+    for (size_t i { 0 } ; i < m_readers.size() ; ++i, property.next()) {
+        if (auto l = m_readers[i].lock()) {
+            read.emplace_back (l->dump (m_names[i], property, schema_));
+        } else {
+            std::stringstream s;
+            s << "null field reader: " << fields[i]->name();
+            throw std::runtime_error (s.str());
+        }
+    }
+
+    return read;
+}
+
+/******************************************************************************/
+
+uPtr<amqp::reader::IValue>
+amqp::internal::reader::
+CompositeReader::dump (
+    amqp::reader::Name name_,
+    const scan::Cursor & cursor_,
+    const SchemaType & schema_) const
+{
+    return std::make_unique<TypedPair<sVec<uPtr<amqp::reader::IValue>>>> (
+        name_,
+        _dump (cursor_, schema_));
+}
+
+/******************************************************************************/
+
+uPtr<amqp::reader::IValue>
+amqp::internal::reader::
+CompositeReader::dump (
+    const scan::Cursor & cursor_,
+    const SchemaType & schema_) const
+{
+    return std::make_unique<TypedSingle<sVec<uPtr<amqp::reader::IValue>>>> (
+        _dump (cursor_, schema_));
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::reader::
+CompositeReader::visit (
+    const scan::Cursor & cursor_,
+    const SchemaType & schema_,
+    amqp::reader::IVisitor & visitor_) const
+{
+    trace::Span span ("CompositeReader::visit", &m_type);
+
+    auto & fields = this->fields (cursor_, schema_);
+
+    visitor_.beginComposite (type());
+
+    auto property = cursor_.value().first();
+
+    for (size_t i { 0 } ; i < m_readers.size() && !visitor_.halted() ; ++i, property.next()) {
+        if (auto l = m_readers[i].lock()) {
+            visitor_.property (m_names[i].str());
+            visitor_.encoded (property.entry().size);
+            l->visit (property, schema_, visitor_);
+        } else {
+            std::stringstream s;
+            s << "null field reader: " << fields[i]->name();
+            throw std::runtime_error (s.str());
+        }
+    }
+
+    visitor_.endComposite();
+}
+
+/******************************************************************************/
@@ -17,6 +17,12 @@ namespace amqp::internal::reader {
         private :
             std::vector<std::weak_ptr<Reader>> m_readers;
 
+            /**
+             * The interned name of each property, looked up once here
+             * rather than for every value we read
+             */
+            sVec<amqp::reader::Name> m_names;
+
             static const std::string m_name;
 
             std::string m_type;
@@ -24,7 +30,8 @@ namespace amqp::internal::reader {
         public :
             CompositeReader (
                 std::string,
-                std::vector<std::weak_ptr<Reader>> &);
+                std::vector<std::weak_ptr<Reader>> &,
+                sVec<amqp::reader::Name>);
 
             ~CompositeReader() override = default;
 
@@ -33,7 +40,7 @@ namespace amqp::internal::reader {
             std::string readString (pn_data_t *) const override;
 
             std::unique_ptr<amqp::reader::IValue> dump(
-                const std::string &,
+                amqp::reader::Name,
                 pn_data_t *,
                 const SchemaType &) const override;
 
@@ -41,13 +48,53 @@ namespace amqp::internal::reader {
                 pn_data_t *,
                 const SchemaType &) const override;
 
+            void visit (
+                pn_data_t *,
+                const SchemaType &,
+                amqp::reader::IVisitor &) const override;
+
+            std::unique_ptr<amqp::reader::IValue> dump(
+                amqp::reader::Name,
+                const scan::Cursor &,
+                const SchemaType &) const override;
+
+            std::unique_ptr<amqp::reader::IValue> dump(
+                const scan::Cursor &,
+                const SchemaType &) const override;
+
+            void visit (
+                const scan::Cursor &,
+                const SchemaType &,
+                amqp::reader::IVisitor &) const override;
+
             const std::string & name() const override;
             const std::string & type() const override;
 
+            /**
+             * The readers for each property, in the order the properties
+             * appear in the schema
+             */
+            const std::vector<std::weak_ptr<Reader>> & readers() const {
+                return m_readers;
+            }
+
         private :
             std::vector<std::unique_ptr<amqp::reader::IValue>> _dump (
                 pn_data_t *,
                 const SchemaType &) const;
+
+            std::vector<std::unique_ptr<amqp::reader::IValue>> _dump (
+                const scan::Cursor &,
+                const SchemaType &) const;
+
+            /**
+             * Resolve the descriptor of the composite at the cursor to
+             * its properties, checking they line up with both our readers
+             * and the values encoded
+             */
+            const std::vector<uPtr<schema::Field>> & fields (
+                const scan::Cursor &,
+                const SchemaType &) const;
     };
 
 }
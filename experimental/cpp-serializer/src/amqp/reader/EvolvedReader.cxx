@@ -0,0 +1,401 @@
+#include "EvolvedReader.h"
+
+#include <sstream>
+#include <stdexcept>
+
+#include <proton/codec.h>
+
+#include "proton/proton_wrapper.h"
+#include "scan/Tape.h"
+#include "dom/Document.h"
+#include "dom/DocumentBuilder.h"
+
+/******************************************************************************/
+
+namespace {
+
+    using amqp::internal::reader::TypedPair;
+
+    /**
+     * The value of a property the blob doesn't have, what Java would
+     * give it, zero of the right type for a primitive and null for
+     * everything else. Primitives we've no reader for are read as the
+     * nearest we do have.
+     */
+    uPtr<amqp::reader::IValue>
+    fill (amqp::reader::Name name_, const std::string & type_) {
+        if (type_ == "int" || type_ == "short" || type_ == "byte") {
+            return std::make_unique<TypedPair<int>> (name_, 0);
+        } else if (type_ == "long") {
+            return std::make_unique<TypedPair<long>> (name_, 0L);
+        } else if (type_ == "double" || type_ == "float") {
+            return std::make_unique<TypedPair<double>> (name_, 0.0);
+        } else if (type_ == "boolean") {
+            return std::make_unique<TypedPair<bool>> (name_, false);
+        } else if (type_ == "char") {
+            return std::make_unique<TypedPair<std::string>> (name_, std::string (1, '\0'));
+        }
+
+        return std::make_unique<TypedPair<std::nullptr_t>> (name_, nullptr);
+    }
+
+    void
+    fill (amqp::reader::IVisitor & visitor_, const std::string & type_) {
+        if (type_ == "int" || type_ == "short" || type_ == "byte") {
+            visitor_.value (int32_t { 0 });
+        } else if (type_ == "long") {
+            visitor_.value (int64_t { 0 });
+        } else if (type_ == "double" || type_ == "float") {
+            visitor_.value (0.0);
+        } else if (type_ == "boolean") {
+            visitor_.value (false);
+        } else if (type_ == "char") {
+            visitor_.value (std::string (1, '\0'));
+        } else {
+            visitor_.null();
+        }
+    }
+
+    void
+    checkCount (const std::string & type_, size_t expected_, size_t actual_) {
+        if (expected_ != actual_) {
+            std::stringstream s;
+            s << type_ << " has " << expected_ << " properties but "
+              << actual_ << " were encoded";
+            throw std::runtime_error (s.str());
+        }
+    }
+
+}
+
+/******************************************************************************/
+
+const std::string
+amqp::internal::reader::
+EvolvedReader::m_name { // NOLINT
+    "Evolved Reader"
+};
+
+/******************************************************************************
+ *
+ * amqp::internal::reader::EvolvedReader
+ *
+ ******************************************************************************/
+
+amqp::internal::reader::
+EvolvedReader::EvolvedReader (
+    sPtr<CompositeReader> remote_,
+    sPtr<const evolution::Plan> plan_
+) : m_remote (std::move (remote_))
+  , m_plan (std::move (plan_))
+{ }
+
+/******************************************************************************/
+
+const std::string &
+amqp::internal::reader::
+EvolvedReader::name() const {
+    return m_name;
+}
+
+/******************************************************************************/
+
+const std::string &
+amqp::internal::reader::
+EvolvedReader::type() const {
+    return m_remote->type();
+}
+
+/******************************************************************************/
+
+std::any
+amqp::internal::reader::
+EvolvedReader::read (pn_data_t * data_) const {
+    return m_remote->read (data_);
+}
+
+/******************************************************************************/
+
+std::string
+amqp::internal::reader::
+EvolvedReader::readString (pn_data_t * data_) const {
+    return m_remote->readString (data_);
+}
+
+/******************************************************************************/
+
+const amqp::internal::reader::Reader &
+amqp::internal::reader::
+EvolvedReader::reader (int remote_) const {
+    if (auto l = m_remote->readers()[remote_].lock()) {
+        return *l;
+    }
+
+    std::stringstream s;
+    s << "null field reader: " << type() << "[" << remote_ << "]";
+    throw std::runtime_error (s.str());
+}
+
+/******************************************************************************/
+
+/**
+ * Proton only lets us walk forwards so we take the remote properties in
+ * the order they were written, once, putting each in its local slot and
+ * stepping over those we drop without decoding them.
+ */
+sVec<uPtr<amqp::reader::IValue>>
+amqp::internal::reader::
+EvolvedReader::_dump (
+    pn_data_t * data_,
+    const SchemaType & schema_
+) const {
+    proton::is_described (data_);
+    proton::auto_enter ae (data_);
+
+    pn_data_next (data_);
+
+    proton::is_list (data_);
+    checkCount (type(), m_plan->remoteProperties(), pn_data_get_list (data_));
+
+    const auto & slots = m_plan->slots();
+
+    sVec<uPtr<amqp::reader::IValue>> read (slots.size());
+
+    for (size_t i { 0 } ; i < slots.size() ; ++i) {
+        if (slots[i].remote == -1) {
+            read[i] = fill (m_plan->names()[i], slots[i].type);
+        }
+    }
+
+    proton::auto_enter list (data_);
+
+    const auto & locals = m_plan->locals();
+
+    for (size_t remote { 0 } ; remote < locals.size() ; ++remote) {
+        auto local = locals[remote];
+
+        if (local == -1) {
+            pn_data_next (data_);
+        } else {
+            read[local] = reader (remote).dump (m_plan->names()[local], data_, schema_);
+        }
+    }
+
+    return read;
+}
+
+/******************************************************************************/
+
+uPtr<amqp::reader::IValue>
+amqp::internal::reader::
+EvolvedReader::dump (
+    amqp::reader::Name name_,
+    pn_data_t * data_,
+    const SchemaType & schema_) const
+{
+    proton::auto_next an (data_);
+
+    return std::make_unique<TypedPair<sVec<uPtr<amqp::reader::IValue>>>> (
+        name_,
+        _dump (data_, schema_));
+}
+
+/******************************************************************************/
+
+uPtr<amqp::reader::IValue>
+amqp::internal::reader::
+EvolvedReader::dump (
+    pn_data_t * data_,
+    const SchemaType & schema_) const
+{
+    proton::auto_next an (data_);
+
+    return std::make_unique<TypedSingle<sVec<uPtr<amqp::reader::IValue>>>> (
+        _dump (data_, schema_));
+}
+
+/******************************************************************************/
+
+/**
+ * As with [_dump] the remote properties are read in one pass, but the
+ * visitor has to see them in local order. One read before its turn is
+ * held in a [dom::Document] and replayed when its turn comes, which for
+ * the usual case of properties only being added or removed is never.
+ */
+void
+amqp::internal::reader::
+EvolvedReader::visit (
+    pn_data_t * data_,
+    const SchemaType & schema_,
+    amqp::reader::IVisitor & visitor_) const
+{
+    proton::auto_next an (data_);
+
+    proton::is_described (data_);
+    proton::auto_enter ae (data_);
+
+    pn_data_next (data_);
+
+    proton::is_list (data_);
+    checkCount (type(), m_plan->remoteProperties(), pn_data_get_list (data_));
+
+    const auto & slots = m_plan->slots();
+    const auto & locals = m_plan->locals();
+
+    sVec<uPtr<dom::Document>> held (slots.size());
+
+    // the next local property the visitor's to see
+    size_t next { 0 };
+
+    // hand over everything we can until we reach one still to be read
+    auto flush = [&]() {
+        for ( ; next < slots.size() && !visitor_.halted() ; ++next) {
+            if (slots[next].remote == -1) {
+                visitor_.property (m_plan->names()[next].str());
+                fill (visitor_, slots[next].type);
+            } else if (held[next]) {
+                visitor_.property (m_plan->names()[next].str());
+                held[next]->root().visit (visitor_);
+            } else {
+                break;
+            }
+        }
+    };
+
+    visitor_.beginComposite (type());
+
+    flush();
+
+    {
+        proton::auto_enter list (data_);
+
+        for (size_t remote { 0 } ;
+             remote < locals.size() && next < slots.size() && !visitor_.halted() ;
+             ++remote)
+        {
+            auto local = locals[remote];
+
+            if (local == -1) {
+                pn_data_next (data_);
+            } else if (static_cast<size_t> (local) == next) {
+                visitor_.property (m_plan->names()[local].str());
+                reader (remote).visit (data_, schema_, visitor_);
+
+                ++next;
+                flush();
+            } else {
+                dom::DocumentBuilder builder;
+                reader (remote).visit (data_, schema_, builder);
+
+                held[local] = std::make_unique<dom::Document> (builder.document());
+            }
+        }
+    }
+
+    visitor_.endComposite();
+}
+
+/******************************************************************************/
+
+sVec<amqp::internal::scan::Cursor>
+amqp::internal::reader::
+EvolvedReader::properties (const scan::Cursor & cursor_) const {
+    auto list = cursor_.value();
+    list.list();
+
+    checkCount (type(), m_plan->remoteProperties(), list.count());
+
+    sVec<scan::Cursor> rtn;
+    rtn.reserve (list.count());
+
+    auto property = list.first();
+    for (size_t i { 0 } ; i < list.count() ; ++i, property.next()) {
+        rtn.push_back (property);
+    }
+
+    return rtn;
+}
+
+/******************************************************************************/
+
+sVec<uPtr<amqp::reader::IValue>>
+amqp::internal::reader::
+EvolvedReader::_dump (
+    const scan::Cursor & cursor_,
+    const SchemaType & schema_
+) const {
+    auto properties = this->properties (cursor_);
+
+    sVec<uPtr<amqp::reader::IValue>> read;
+    read.reserve (m_plan->slots().size());
+
+    for (size_t i { 0 } ; i < m_plan->slots().size() ; ++i) {
+        const auto & slot = m_plan->slots()[i];
+
+        if (slot.remote == -1) {
+            read.emplace_back (fill (m_plan->names()[i], slot.type));
+        } else {
+            read.emplace_back (reader (slot.remote).dump (
+                m_plan->names()[i], properties[slot.remote], schema_));
+        }
+    }
+
+    return read;
+}
+
+/******************************************************************************/
+
+uPtr<amqp::reader::IValue>
+amqp::internal::reader::
+EvolvedReader::dump (
+    amqp::reader::Name name_,
+    const scan::Cursor & cursor_,
+    const SchemaType & schema_) const
+{
+    return std::make_unique<TypedPair<sVec<uPtr<amqp::reader::IValue>>>> (
+        name_,
+        _dump (cursor_, schema_));
+}
+
+/******************************************************************************/
+
+uPtr<amqp::reader::IValue>
+amqp::internal::reader::
+EvolvedReader::dump (
+    const scan::Cursor & cursor_,
+    const SchemaType & schema_) const
+{
+    return std::make_unique<TypedSingle<sVec<uPtr<amqp::reader::IValue>>>> (
+        _dump (cursor_, schema_));
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::reader::
+EvolvedReader::visit (
+    const scan::Cursor & cursor_,
+    const SchemaType & schema_,
+    amqp::reader::IVisitor & visitor_) const
+{
+    auto properties = this->properties (cursor_);
+
+    visitor_.beginComposite (type());
+
+    for (size_t i { 0 } ; i < m_plan->slots().size() && !visitor_.halted() ; ++i) {
+        const auto & slot = m_plan->slots()[i];
+
+        visitor_.property (m_plan->names()[i].str());
+
+        if (slot.remote == -1) {
+            fill (visitor_, slot.type);
+        } else {
+            visitor_.encoded (properties[slot.remote].entry().size);
+            reader (slot.remote).visit (properties[slot.remote], schema_, visitor_);
+        }
+    }
+
+    visitor_.endComposite();
+}
+
+/******************************************************************************/
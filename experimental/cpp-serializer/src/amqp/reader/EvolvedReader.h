@@ -0,0 +1,87 @@
+#pragma once
+
+/******************************************************************************/
+
+#include "Reader.h"
+#include "CompositeReader.h"
+
+#include "evolution/Plan.h"
+
+/******************************************************************************/
+
+namespace amqp::internal::reader {
+
+    /**
+     * Reads a composite written with an older, or newer, version of a class
+     * as the version we know locally, following an [evolution::Plan]. The
+     * properties are read by the readers for the remote version but come
+     * out named, and in the order, the local version expects, with any
+     * the remote version lacks defaulted.
+     */
+    class EvolvedReader : public Reader {
+        private :
+            static const std::string m_name;
+
+            sPtr<CompositeReader> m_remote;
+
+            sPtr<const evolution::Plan> m_plan;
+
+            const Reader & reader (int) const;
+
+            sVec<uPtr<amqp::reader::IValue>> _dump (
+                pn_data_t *,
+                const SchemaType &) const;
+
+            sVec<uPtr<amqp::reader::IValue>> _dump (
+                const scan::Cursor &,
+                const SchemaType &) const;
+
+            /**
+             * Cursors for each of the remote properties
+             */
+            sVec<scan::Cursor> properties (const scan::Cursor &) const;
+
+        public :
+            EvolvedReader (sPtr<CompositeReader>, sPtr<const evolution::Plan>);
+
+            ~EvolvedReader() override = default;
+
+            std::any read (pn_data_t *) const override;
+
+            std::string readString (pn_data_t *) const override;
+
+            std::unique_ptr<amqp::reader::IValue> dump(
+                amqp::reader::Name,
+                pn_data_t *,
+                const SchemaType &) const override;
+
+            std::unique_ptr<amqp::reader::IValue> dump(
+                pn_data_t *,
+                const SchemaType &) const override;
+
+            void visit (
+                pn_data_t *,
+                const SchemaType &,
+                amqp::reader::IVisitor &) const override;
+
+            std::unique_ptr<amqp::reader::IValue> dump(
+                amqp::reader::Name,
+                const scan::Cursor &,
+                const SchemaType &) const override;
+
+            std::unique_ptr<amqp::reader::IValue> dump(
+                const scan::Cursor &,
+                const SchemaType &) const override;
+
+            void visit (
+                const scan::Cursor &,
+                const SchemaType &,
+                amqp::reader::IVisitor &) const override;
+
+            const std::string & name() const override;
+            const std::string & type() const override;
+    };
+
+}
+
+/******************************************************************************/
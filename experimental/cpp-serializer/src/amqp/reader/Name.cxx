@@ -0,0 +1,45 @@
+#include "amqp/reader/Name.h"
+
+#include <mutex>
+#include <unordered_set>
+
+/******************************************************************************/
+
+namespace {
+
+    /**
+     * Elements of an unordered_set never move once inserted so handing
+     * out pointers to them is safe. Nothing is ever removed, the pool
+     * being bounded by the property names of the types we've seen.
+     */
+    const std::string *
+    intern (const std::string & name_) {
+        static std::mutex mutex;
+        static std::unordered_set<std::string> pool; // NOLINT
+
+        std::lock_guard<std::mutex> lock (mutex);
+
+        return &*pool.insert (name_).first;
+    }
+
+}
+
+/******************************************************************************
+ *
+ * amqp::reader::Name
+ *
+ ******************************************************************************/
+
+amqp::reader::
+Name::Name (const std::string & name_)
+    : m_name (intern (name_))
+{ }
+
+/******************************************************************************/
+
+amqp::reader::
+Name::Name (const char * name_)
+    : m_name (intern (name_))
+{ }
+
+/******************************************************************************/
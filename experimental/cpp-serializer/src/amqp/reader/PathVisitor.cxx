@@ -0,0 +1,127 @@
+#include "PathVisitor.h"
+
+/******************************************************************************
+ *
+ * amqp::internal::reader::PathVisitor
+ *
+ ******************************************************************************/
+
+const std::string &
+amqp::internal::reader::
+PathVisitor::leafPath() {
+    m_scratch = m_path;
+
+    if (m_frames.empty()) {
+        return m_scratch;
+    }
+
+    auto & top = m_frames.back();
+
+    switch (top.kind) {
+        case Frame::composite_k : {
+            if (!m_scratch.empty()) m_scratch += '.';
+            m_scratch += m_property;
+            break;
+        }
+        case Frame::list_k : {
+            break;
+        }
+        case Frame::map_k : {
+            m_scratch += top.key ? ".key" : ".value";
+            top.key = !top.key;
+            break;
+        }
+    }
+
+    return m_scratch;
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::reader::
+PathVisitor::push (
+    Frame::Kind kind_,
+    const std::string & path_,
+    const char * suffix_
+) {
+    m_frames.push_back ({ kind_, m_path.size(), true });
+    m_path = path_;
+    m_path += suffix_;
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::reader::
+PathVisitor::pop() {
+    m_path.resize (m_frames.back().pathLength);
+    m_frames.pop_back();
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::reader::
+PathVisitor::property (const std::string & property_) {
+    m_property = property_;
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::reader::
+PathVisitor::beginComposite (const std::string &) {
+    const auto & path = leafPath();
+
+    enterComposite (path);
+    push (Frame::composite_k, path, "");
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::reader::
+PathVisitor::endComposite() {
+    pop();
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::reader::
+PathVisitor::beginList (size_t elements_) {
+    const auto & path = leafPath();
+
+    enterList (path, elements_);
+    push (Frame::list_k, path, "[]");
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::reader::
+PathVisitor::endList() {
+    pop();
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::reader::
+PathVisitor::beginMap (size_t elements_) {
+    const auto & path = leafPath();
+
+    enterMap (path, elements_);
+    push (Frame::map_k, path, "{}");
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::reader::
+PathVisitor::endMap() {
+    pop();
+}
+
+/******************************************************************************/
@@ -0,0 +1,82 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <string>
+
+#include "types.h"
+
+#include "amqp/reader/IVisitor.h"
+
+/******************************************************************************/
+
+namespace amqp::internal::reader {
+
+    /**
+     * Base for visitors that care where in the type a value lives rather
+     * than just the order values arrive in. Keeps track of the path to
+     * the current value, properties being separated by '.', the elements
+     * of a list by "[]", and the keys and values of a map by "{}.key" and
+     * "{}.value", e.g.
+     *
+     *      a
+     *      b.c
+     *      listy[].a
+     *      m{}.key
+     *      m{}.value
+     *
+     * The top level object has the empty path.
+     */
+    class PathVisitor : public amqp::reader::IVisitor {
+        private :
+            struct Frame {
+                enum Kind { composite_k, list_k, map_k };
+
+                Kind   kind;
+                size_t pathLength;
+                bool   key;
+            };
+
+            sVec<Frame> m_frames;
+            std::string m_path;
+            std::string m_property;
+            std::string m_scratch;
+
+            void push (Frame::Kind, const std::string &, const char *);
+            void pop();
+
+        protected :
+            /**
+             * The path of the next value we're going to see. Within a
+             * map this alternates between the key and the value so it
+             * must be called exactly once per value.
+             */
+            const std::string & leafPath();
+
+            /**
+             * true when we're not within any composite, list or map
+             */
+            bool root() const { return m_frames.empty(); }
+
+            virtual void enterComposite (const std::string &) { }
+            virtual void enterList (const std::string &, size_t) { }
+            virtual void enterMap (const std::string &, size_t) { }
+
+        public :
+            ~PathVisitor() override = default;
+
+            void property (const std::string &) override;
+
+            void beginComposite (const std::string &) override;
+            void endComposite() override;
+
+            void beginList (size_t) override;
+            void endList() override;
+
+            void beginMap (size_t) override;
+            void endMap() override;
+    };
+
+}
+
+/******************************************************************************/
@@ -30,7 +30,7 @@ namespace amqp::internal::reader {
             std::any read (pn_data_t *) const override = 0;
 
             std::unique_ptr<amqp::reader::IValue> dump(
-                const std::string &,
+                amqp::reader::Name,
                 pn_data_t *,
                 const SchemaType &
             ) const override = 0;
@@ -40,6 +40,29 @@ namespace amqp::internal::reader {
                 const SchemaType &
             ) const override = 0;
 
+            void visit (
+                pn_data_t *,
+                const SchemaType &,
+                amqp::reader::IVisitor &
+            ) const override = 0;
+
+            std::unique_ptr<amqp::reader::IValue> dump(
+                amqp::reader::Name,
+                const scan::Cursor &,
+                const SchemaType &
+            ) const override = 0;
+
+            std::unique_ptr<amqp::reader::IValue> dump(
+                const scan::Cursor &,
+                const SchemaType &
+            ) const override = 0;
+
+            void visit (
+                const scan::Cursor &,
+                const SchemaType &,
+                amqp::reader::IVisitor &
+            ) const override = 0;
+
             const std::string & name() const override = 0;
             const std::string & type() const override = 0;
     };
@@ -1,88 +1,96 @@
 #include "Reader.h"
 
 #include <memory>
-#include <sstream>
 
 /******************************************************************************/
 
 namespace {
 
     struct AutoMap {
-        std::stringstream & m_stream;
+        std::string & m_out;
 
         AutoMap (
                 const std::string & s,
-                std::stringstream & stream_
-        ) : m_stream (stream_) {
-            m_stream << s << " : { ";
+                std::string & out_
+        ) : m_out (out_) {
+            m_out += s;
+            m_out += " : { ";
         }
 
-        explicit AutoMap (std::stringstream & stream_)
-            : m_stream (stream_)
+        explicit AutoMap (std::string & out_)
+            : m_out (out_)
         {
-            m_stream << "{ ";
+            m_out += "{ ";
         }
 
         ~AutoMap() {
-            m_stream << " }";
+            m_out += " }";
         }
     };
 
     struct AutoList {
-        std::stringstream & m_stream;
+        std::string & m_out;
 
         AutoList (
                 const std::string & s,
-                std::stringstream & stream_
-        ) : m_stream (stream_) {
-            m_stream << s << " : [ ";
+                std::string & out_
+        ) : m_out (out_) {
+            m_out += s;
+            m_out += " : [ ";
         }
 
-        explicit AutoList (std::stringstream & stream_)
-            : m_stream (stream_)
+        explicit AutoList (std::string & out_)
+            : m_out (out_)
         {
-            m_stream << "[ ";
+            m_out += "[ ";
         }
 
         ~AutoList() {
-            m_stream << " ]";
+            m_out += " ]";
         }
     };
 
-    template<class Auto, class T>
-    std::string
-    dumpPair (const std::string & name_, const T & begin_, const T & end_) {
-        std::stringstream rtn;
-        {
-            Auto am (name_, rtn);
-
-            if (begin_ != end_) {
-                rtn << (*(begin_))->dump();
-                for (auto it(std::next(begin_)); it != end_; ++it) {
-                    rtn << ", " << (*it)->dump();
-                }
+    template<class T>
+    void
+    dumpAll (std::string & out_, const T & begin_, const T & end_) {
+        if (begin_ != end_) {
+            (*(begin_))->dumpTo (out_);
+            for (auto it(std::next(begin_)); it != end_; ++it) {
+                out_ += ", ";
+                (*it)->dumpTo (out_);
             }
         }
+    }
 
-        return rtn.str();
+    template<class Auto, class T>
+    void
+    dumpPair (
+        std::string & out_,
+        const std::string & name_,
+        const T & begin_,
+        const T & end_
+    ) {
+        Auto am (name_, out_);
+        dumpAll (out_, begin_, end_);
     }
 
     template<class Auto, class T>
-    std::string
-    dumpSingle (const T & begin_, const T & end_) {
-        std::stringstream rtn;
-        {
-            Auto am (rtn);
+    void
+    dumpSingle (std::string & out_, const T & begin_, const T & end_) {
+        Auto am (out_);
+        dumpAll (out_, begin_, end_);
+    }
 
-            if (begin_ != end_) {
-                rtn << (*(begin_))->dump();
-                for (auto it(std::next(begin_)); it != end_; ++it) {
-                    rtn << ", " << (*it)->dump();
-                }
+    template<class T>
+    void
+    dumpPrimitives (std::string & out_, const sVec<T> & values_) {
+        if (!values_.empty()) {
+            amqp::internal::reader::appendNumber (out_, values_.front());
+            for (auto it (std::next (values_.begin())) ; it != values_.end() ; ++it) {
+                out_ += ", ";
+                amqp::internal::reader::appendNumber (out_, *it);
             }
         }
-
-        return rtn.str();
     }
 
 }
@@ -93,14 +101,12 @@ namespace {
  *
  ******************************************************************************/
 
-std::string
+void
 amqp::internal::reader::
-ValuePair::dump() const {
-    std::stringstream ss;
-
-    ss << m_key->dump() << " : " << m_value->dump();
-
-    return ss.str();
+ValuePair::dumpTo (std::string & out_) const {
+    m_key->dumpTo (out_);
+    out_ += " : ";
+    m_value->dumpTo (out_);
 }
 
 /******************************************************************************
@@ -110,31 +116,39 @@ ValuePair::dump() const {
  ******************************************************************************/
 
 template<>
-std::string
+void
+amqp::internal::reader::
+TypedPair<sVec<uPtr<amqp::internal::reader::Pair>>>::dumpTo (std::string & out_) const {
+    ::dumpPair<AutoMap> (out_, m_property.str(), m_value.begin(), m_value.end());
+}
+
+template<>
+void
 amqp::internal::reader::
-TypedPair<sVec<uPtr<amqp::internal::reader::Pair>>>::dump() const {
-    return ::dumpPair<AutoMap> (m_property, m_value.begin(), m_value.end());
+TypedPair<sList<uPtr<amqp::internal::reader::Pair>>>::dumpTo (std::string & out_) const {
+    ::dumpPair<AutoMap> (out_, m_property.str(), m_value.begin(), m_value.end());
 }
 
 template<>
-std::string
+void
 amqp::internal::reader::
-TypedPair<sList<uPtr<amqp::internal::reader::Pair>>>::dump() const {
-    return ::dumpPair<AutoMap> (m_property, m_value.begin(), m_value.end());
+TypedPair<sVec<uPtr<amqp::reader::IValue>>>::dumpTo (std::string & out_) const {
+    ::dumpPair<AutoMap> (out_, m_property.str(), m_value.begin(), m_value.end());
 }
 
 template<>
-std::string
+void
 amqp::internal::reader::
-TypedPair<sVec<uPtr<amqp::reader::IValue>>>::dump() const {
-    return ::dumpPair<AutoMap> (m_property, m_value.begin(), m_value.end());
+TypedPair<sList<uPtr<amqp::reader::IValue>>>::dumpTo (std::string & out_) const {
+    ::dumpPair<AutoList> (out_, m_property.str(), m_value.begin(), m_value.end());
 }
 
 template<>
-std::string
+void
 amqp::internal::reader::
-TypedPair<sList<uPtr<amqp::reader::IValue>>>::dump() const {
-    return ::dumpPair<AutoList> (m_property, m_value.begin(), m_value.end());
+TypedPair<amqp::internal::reader::Elements>::dumpTo (std::string & out_) const {
+    ::dumpPair<AutoList> (
+        out_, m_property.str(), m_value.values.begin(), m_value.values.end());
 }
 
 /******************************************************************************
@@ -144,31 +158,92 @@ TypedPair<sList<uPtr<amqp::reader::IValue>>>::dump() const {
  ******************************************************************************/
 
 template<>
-std::string
+void
+amqp::internal::reader::
+TypedSingle<sList<uPtr<amqp::reader::IValue>>>::dumpTo (std::string & out_) const {
+    ::dumpSingle<AutoList> (out_, m_value.begin(), m_value.end());
+}
+
+template<>
+void
+amqp::internal::reader::
+TypedSingle<amqp::internal::reader::Elements>::dumpTo (std::string & out_) const {
+    ::dumpSingle<AutoList> (out_, m_value.values.begin(), m_value.values.end());
+}
+
+template<>
+void
+amqp::internal::reader::
+TypedSingle<sVec<uPtr<amqp::reader::IValue>>>::dumpTo (std::string & out_) const {
+    ::dumpSingle<AutoMap> (out_, m_value.begin(), m_value.end());
+}
+
+template<>
+void
+amqp::internal::reader::
+TypedSingle<sList<uPtr<amqp::internal::reader::Single>>>::dumpTo (std::string & out_) const {
+    ::dumpSingle<AutoList> (out_, m_value.begin(), m_value.end());
+}
+
+template<>
+void
+amqp::internal::reader::
+TypedSingle<sVec<uPtr<amqp::internal::reader::Single>>>::dumpTo (std::string & out_) const {
+    ::dumpSingle<AutoMap> (out_, m_value.begin(), m_value.end());
+}
+
+/******************************************************************************
+ *
+ * amqp::internal::reader::Primitives
+ *
+ ******************************************************************************/
+
+template<>
+void
+amqp::internal::reader::
+TypedPair<amqp::internal::reader::Primitives<int>>::dumpTo (std::string & out_) const {
+    AutoList al (m_property.str(), out_);
+    ::dumpPrimitives (out_, m_value.values);
+}
+
+template<>
+void
+amqp::internal::reader::
+TypedPair<amqp::internal::reader::Primitives<long>>::dumpTo (std::string & out_) const {
+    AutoList al (m_property.str(), out_);
+    ::dumpPrimitives (out_, m_value.values);
+}
+
+template<>
+void
 amqp::internal::reader::
-TypedSingle<sList<uPtr<amqp::reader::IValue>>>::dump() const {
-    return ::dumpSingle<AutoList> (m_value.begin(), m_value.end());
+TypedPair<amqp::internal::reader::Primitives<double>>::dumpTo (std::string & out_) const {
+    AutoList al (m_property.str(), out_);
+    ::dumpPrimitives (out_, m_value.values);
 }
 
 template<>
-std::string
+void
 amqp::internal::reader::
-TypedSingle<sVec<uPtr<amqp::reader::IValue>>>::dump() const {
-    return ::dumpSingle<AutoMap> (m_value.begin(), m_value.end());
+TypedSingle<amqp::internal::reader::Primitives<int>>::dumpTo (std::string & out_) const {
+    AutoList al (out_);
+    ::dumpPrimitives (out_, m_value.values);
 }
 
 template<>
-std::string
+void
 amqp::internal::reader::
-TypedSingle<sList<uPtr<amqp::internal::reader::Single>>>::dump() const {
-    return ::dumpSingle<AutoList> (m_value.begin(), m_value.end());
+TypedSingle<amqp::internal::reader::Primitives<long>>::dumpTo (std::string & out_) const {
+    AutoList al (out_);
+    ::dumpPrimitives (out_, m_value.values);
 }
 
 template<>
-std::string
+void
 amqp::internal::reader::
-TypedSingle<sVec<uPtr<amqp::internal::reader::Single>>>::dump() const {
-    return ::dumpSingle<AutoMap> (m_value.begin(), m_value.end());
+TypedSingle<amqp::internal::reader::Primitives<double>>::dumpTo (std::string & out_) const {
+    AutoList al (out_);
+    ::dumpPrimitives (out_, m_value.values);
 }
 
 /******************************************************************************/
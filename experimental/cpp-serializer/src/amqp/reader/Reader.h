@@ -7,9 +7,20 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <charconv>
+#include <cstddef>
 
 #include "amqp/schema/described-types/Schema.h"
 #include "amqp/reader/IReader.h"
+#include "amqp/json/StringEscape.h"
+
+/******************************************************************************/
+
+namespace amqp::internal::scan {
+
+    class Cursor;
+
+}
 
 /******************************************************************************/
 
@@ -17,11 +28,36 @@ namespace amqp::internal::reader {
 
     class Value : public amqp::reader::IValue {
         public :
-            std::string dump() const override = 0;
+            std::string dump() const override {
+                std::string rtn;
+                dumpTo (rtn);
+                return rtn;
+            }
+
+            void dumpTo (std::string &) const override = 0;
 
             ~Value() override = default;
     };
 
+    /**
+     * Format a number straight onto the end of [out_] without going via
+     * a temporary string. Doubles are written in their shortest form
+     * that still round trips.
+     */
+    template<typename T>
+    inline void
+    appendNumber (std::string & out_, T value_) {
+        char buf[32];
+        auto end = std::to_chars (buf, buf + sizeof (buf), value_).ptr;
+        out_.append (buf, end);
+    }
+
+    template<>
+    inline void
+    appendNumber (std::string & out_, bool value_) {
+        out_ += value_ ? '1' : '0';
+    }
+
     /*
      * A Single represents some value read out of a proton tree that
      * exists without an association. The canonical example is an
@@ -37,7 +73,7 @@ namespace amqp::internal::reader {
      */
     class Single : public Value {
         public :
-            std::string dump() const override = 0;
+            void dumpTo (std::string &) const override = 0;
 
             ~Single() override = default;
     };
@@ -67,7 +103,29 @@ namespace amqp::internal::reader {
                 return m_value;
             }
 
-            std::string dump() const override;
+            void dumpTo (std::string &) const override;
+    };
+
+    /**
+     * Lists and arrays of numeric primitives are read in bulk into
+     * contiguous storage rather than as a [TypedSingle] per element.
+     * Wrapped so they're distinct from the sVec used for maps and so
+     * dump as lists.
+     */
+    template<typename T>
+    struct Primitives {
+        sVec<T> values;
+    };
+
+    /**
+     * The decoded elements of any other list or array. The encoding tells
+     * us how many there are before we read the first so they're held
+     * contiguously, sized up front, rather than as a node per element.
+     * Wrapped, like [Primitives], so they dump as a list rather than the
+     * map the bare sVec of a composite's properties would.
+     */
+    struct Elements {
+        sVec<uPtr<amqp::reader::IValue>> values;
     };
 
     /*
@@ -77,21 +135,21 @@ namespace amqp::internal::reader {
      */
     class Pair : public Value {
         protected :
-            std::string m_property;
+            amqp::reader::Name m_property;
 
         public:
-            explicit Pair (std::string property_)
+            explicit Pair (amqp::reader::Name property_)
                 : Value()
-                , m_property (std::move (property_))
+                , m_property (property_)
             { }
 
             ~Pair() override = default;
 
             Pair (Pair && pair_) noexcept
-                : m_property (std::move (pair_.m_property))
+                : m_property (pair_.m_property)
             { }
 
-            std::string dump() const override = 0;
+            void dumpTo (std::string &) const override = 0;
     };
 
 
@@ -101,18 +159,18 @@ namespace amqp::internal::reader {
             T m_value;
 
         public:
-            TypedPair (const std::string & property_, T & value_)
+            TypedPair (amqp::reader::Name property_, T & value_)
                 : Pair (property_)
                 , m_value (value_)
             { }
 
-            TypedPair (const std::string & property_, T && value_)
+            TypedPair (amqp::reader::Name property_, T && value_)
                 : Pair (property_)
                 , m_value (std::move (value_))
             { }
 
             TypedPair (TypedPair && pair_) noexcept
-                : Pair (std::move (pair_.m_property))
+                : Pair (pair_.m_property)
                 , m_value (std::move (pair_.m_value))
             { }
 
@@ -120,7 +178,7 @@ namespace amqp::internal::reader {
                 return m_value;
             }
 
-            std::string dump() const override;
+            void dumpTo (std::string &) const override;
     };
 
     /**
@@ -143,7 +201,7 @@ namespace amqp::internal::reader {
               , m_value (std::move (value_))
         { }
 
-        std::string dump() const override;
+        void dumpTo (std::string &) const override;
     };
 
 }
@@ -155,38 +213,62 @@ namespace amqp::internal::reader {
  ******************************************************************************/
 
 template<typename T>
-inline std::string
+inline void
 amqp::internal::reader::
-TypedSingle<T>::dump() const {
-    return std::to_string (m_value);
+TypedSingle<T>::dumpTo (std::string & out_) const {
+    appendNumber (out_, m_value);
 }
 
+/**
+ * Strings, and anything else held as one such as an enum's constant, are
+ * held as they were read and quoted and escaped as they're written
+ */
 template<>
-inline std::string
+inline void
 amqp::internal::reader::
-TypedSingle<std::string>::dump() const {
-    return m_value;
+TypedSingle<std::string>::dumpTo (std::string & out_) const {
+    json::appendQuoted (out_, m_value.data(), m_value.size());
 }
 
 template<>
-std::string
+void
+amqp::internal::reader::
+TypedSingle<sVec<uPtr<amqp::reader::IValue>>>::dumpTo (std::string &) const;
+
+template<>
+void
 amqp::internal::reader::
-TypedSingle<sVec<uPtr<amqp::reader::IValue>>>::dump() const;
+TypedSingle<sList<uPtr<amqp::reader::IValue>>>::dumpTo (std::string &) const;
 
 template<>
-std::string
+void
 amqp::internal::reader::
-TypedSingle<sList<uPtr<amqp::reader::IValue>>>::dump() const;
+TypedSingle<sVec<uPtr<amqp::internal::reader::Single>>>::dumpTo (std::string &) const;
 
 template<>
-std::string
+void
 amqp::internal::reader::
-TypedSingle<sVec<uPtr<amqp::internal::reader::Single>>>::dump() const;
+TypedSingle<sList<uPtr<amqp::internal::reader::Single>>>::dumpTo (std::string &) const;
 
 template<>
-std::string
+void
 amqp::internal::reader::
-TypedSingle<sList<uPtr<amqp::internal::reader::Single>>>::dump() const;
+TypedSingle<amqp::internal::reader::Elements>::dumpTo (std::string &) const;
+
+template<>
+void
+amqp::internal::reader::
+TypedSingle<amqp::internal::reader::Primitives<int>>::dumpTo (std::string &) const;
+
+template<>
+void
+amqp::internal::reader::
+TypedSingle<amqp::internal::reader::Primitives<long>>::dumpTo (std::string &) const;
+
+template<>
+void
+amqp::internal::reader::
+TypedSingle<amqp::internal::reader::Primitives<double>>::dumpTo (std::string &) const;
 
 /******************************************************************************
  *
@@ -195,38 +277,70 @@ TypedSingle<sList<uPtr<amqp::internal::reader::Single>>>::dump() const;
  ******************************************************************************/
 
 template<typename T>
-inline std::string
+inline void
 amqp::internal::reader::
-TypedPair<T>::dump() const {
-    return m_property + " : " + std::to_string (m_value);
+TypedPair<T>::dumpTo (std::string & out_) const {
+    out_ += m_property.str();
+    out_ += " : ";
+    appendNumber (out_, m_value);
 }
 
 template<>
-inline std::string
+inline void
 amqp::internal::reader::
-TypedPair<std::string>::dump() const {
-    return m_property + " : " + m_value;
+TypedPair<std::string>::dumpTo (std::string & out_) const {
+    out_ += m_property.str();
+    out_ += " : ";
+    json::appendQuoted (out_, m_value.data(), m_value.size());
 }
 
 template<>
-std::string
+inline void
 amqp::internal::reader::
-TypedPair<sVec<uPtr<amqp::reader::IValue>>>::dump() const;
+TypedPair<std::nullptr_t>::dumpTo (std::string & out_) const {
+    out_ += m_property.str();
+    out_ += " : null";
+}
+
+template<>
+void
+amqp::internal::reader::
+TypedPair<sVec<uPtr<amqp::reader::IValue>>>::dumpTo (std::string &) const;
 
 template<>
-std::string
+void
 amqp::internal::reader::
-TypedPair<sList<uPtr<amqp::reader::IValue>>>::dump() const;
+TypedPair<sList<uPtr<amqp::reader::IValue>>>::dumpTo (std::string &) const;
 
 template<>
-std::string
+void
 amqp::internal::reader::
-TypedPair<sVec<uPtr<amqp::internal::reader::Pair>>>::dump() const;
+TypedPair<sVec<uPtr<amqp::internal::reader::Pair>>>::dumpTo (std::string &) const;
 
 template<>
-std::string
+void
 amqp::internal::reader::
-TypedPair<sList<uPtr<amqp::internal::reader::Pair>>>::dump() const;
+TypedPair<sList<uPtr<amqp::internal::reader::Pair>>>::dumpTo (std::string &) const;
+
+template<>
+void
+amqp::internal::reader::
+TypedPair<amqp::internal::reader::Elements>::dumpTo (std::string &) const;
+
+template<>
+void
+amqp::internal::reader::
+TypedPair<amqp::internal::reader::Primitives<int>>::dumpTo (std::string &) const;
+
+template<>
+void
+amqp::internal::reader::
+TypedPair<amqp::internal::reader::Primitives<long>>::dumpTo (std::string &) const;
+
+template<>
+void
+amqp::internal::reader::
+TypedPair<amqp::internal::reader::Primitives<double>>::dumpTo (std::string &) const;
 
 /******************************************************************************
  *
@@ -260,13 +374,38 @@ namespace amqp::internal::reader  {
             std::string readString (struct pn_data_t *) const override = 0;
 
             uPtr<amqp::reader::IValue> dump(
-                const std::string &,
+                amqp::reader::Name,
                 pn_data_t *,
                 const SchemaType &) const override = 0;
 
             uPtr<amqp::reader::IValue> dump(
                 pn_data_t *,
                 const SchemaType &) const override = 0;
+
+            void visit (
+                pn_data_t *,
+                const SchemaType &,
+                amqp::reader::IVisitor &) const override = 0;
+
+            /**
+             * As above but reading the value at a position on a
+             * [scan::Tape] rather than from a proton tree. Unlike proton
+             * the cursor is left where it is, the caller moves on to the
+             * next value itself.
+             */
+            virtual uPtr<amqp::reader::IValue> dump(
+                amqp::reader::Name,
+                const scan::Cursor &,
+                const SchemaType &) const = 0;
+
+            virtual uPtr<amqp::reader::IValue> dump(
+                const scan::Cursor &,
+                const SchemaType &) const = 0;
+
+            virtual void visit (
+                const scan::Cursor &,
+                const SchemaType &,
+                amqp::reader::IVisitor &) const = 0;
     };
 
 }
@@ -1,11 +1,14 @@
 #include "RestrictedReader.h"
 
+#include <sstream>
 #include <iostream>
+#include <stdexcept>
 
 #include "proton/proton_wrapper.h"
 
 #include "amqp/reader/IReader.h"
 #include "amqp/reader/Reader.h"
+#include "scan/Tape.h"
 
 /******************************************************************************/
 
@@ -55,3 +58,58 @@ RestrictedReader::type() const {
 }
 
 /******************************************************************************/
+
+sVec<uPtr<amqp::reader::IValue>>
+amqp::internal::reader::
+RestrictedReader::dumpElements (
+    pn_data_t *,
+    size_t,
+    const SchemaType &
+) const {
+    std::stringstream ss;
+    ss << "Cannot read the elements of " << m_type << " separately";
+    throw std::runtime_error (ss.str());
+}
+
+/******************************************************************************/
+
+sVec<uPtr<amqp::reader::IValue>>
+amqp::internal::reader::
+RestrictedReader::dumpElements (
+    const scan::Cursor &,
+    size_t,
+    const SchemaType &
+) const {
+    std::stringstream ss;
+    ss << "Cannot read the elements of " << m_type << " separately";
+    throw std::runtime_error (ss.str());
+}
+
+/******************************************************************************/
+
+uPtr<amqp::reader::IValue>
+amqp::internal::reader::
+RestrictedReader::wrapElements (
+    amqp::reader::Name,
+    sVec<uPtr<amqp::reader::IValue>>
+) const {
+    std::stringstream ss;
+    ss << "Cannot read the elements of " << m_type << " separately";
+    throw std::runtime_error (ss.str());
+}
+
+/******************************************************************************/
+
+amqp::internal::scan::Cursor
+amqp::internal::reader::
+RestrictedReader::collection (
+    const scan::Cursor & cursor_,
+    const SchemaType & schema_
+) {
+    schema_.fromDescriptor (
+        std::string { cursor_.descriptor().get<std::string_view>() });
+
+    return cursor_.value();
+}
+
+/******************************************************************************/
@@ -31,12 +31,51 @@ namespace amqp::internal::reader {
             std::string readString (pn_data_t *) const override;
 
             std::unique_ptr<amqp::reader::IValue> dump(
-                const std::string &,
+                amqp::reader::Name,
                 pn_data_t *,
                 const SchemaType &) const override = 0;
 
+            /**
+             * Read [n] elements of the collection from wherever the proton
+             * tree is positioned rather than the whole collection, allowing
+             * a very large collection to be split up and each part read
+             * independently. For a map an element is a key value pair.
+             */
+            virtual sVec<uPtr<amqp::reader::IValue>> dumpElements (
+                pn_data_t *,
+                size_t,
+                const SchemaType &) const;
+
+            /**
+             * As above but reading from a [scan::Tape], starting with the
+             * element at the cursor
+             */
+            virtual sVec<uPtr<amqp::reader::IValue>> dumpElements (
+                const scan::Cursor &,
+                size_t,
+                const SchemaType &) const;
+
+            /**
+             * Put back together the elements read by [dumpElements] as
+             * the value of the named property, i.e. as [dump] would have
+             * returned them
+             */
+            virtual uPtr<amqp::reader::IValue> wrapElements (
+                amqp::reader::Name,
+                sVec<uPtr<amqp::reader::IValue>>) const;
+
             const std::string & name() const override;
             const std::string & type() const override;
+
+            /**
+             * Restricted types are encoded as their descriptor wrapped
+             * around the collection itself. Check the descriptor against
+             * the schema, as the proton readers do, and return the
+             * collection.
+             */
+            static scan::Cursor collection (
+                const scan::Cursor &,
+                const SchemaType &);
     };
 
 }
@@ -1,6 +1,7 @@
 #include "BoolPropertyReader.h"
 
 #include "proton/proton_wrapper.h"
+#include "scan/Tape.h"
 
 /******************************************************************************
  *
@@ -47,13 +48,13 @@ BoolPropertyReader::readString (pn_data_t * data_) const {
 uPtr<amqp::reader::IValue>
 amqp::internal::reader::
 BoolPropertyReader::dump (
-        const std::string & name_,
+        amqp::reader::Name name_,
         pn_data_t * data_,
         const SchemaType & schema_) const
 {
-    return std::make_unique<TypedPair<std::string>> (
+    return std::make_unique<TypedPair<bool>> (
             name_,
-            std::to_string (proton::readAndNext<bool> (data_)));
+            proton::readAndNext<bool> (data_));
 }
 
 /******************************************************************************/
@@ -64,8 +65,58 @@ BoolPropertyReader::dump (
         pn_data_t * data_,
         const SchemaType & schema_) const
 {
-    return std::make_unique<TypedSingle<std::string>> (
-            std::to_string (proton::readAndNext<bool> (data_)));
+    return std::make_unique<TypedSingle<bool>> (
+            proton::readAndNext<bool> (data_));
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::reader::
+BoolPropertyReader::visit (
+    pn_data_t * data_,
+    const SchemaType & schema_,
+    amqp::reader::IVisitor & visitor_) const
+{
+    visitor_.value (proton::readAndNext<bool> (data_));
+}
+
+/******************************************************************************/
+
+uPtr<amqp::reader::IValue>
+amqp::internal::reader::
+BoolPropertyReader::dump (
+    amqp::reader::Name name_,
+    const scan::Cursor & cursor_,
+    const SchemaType & schema_) const
+{
+    return std::make_unique<TypedPair<bool>> (
+            name_,
+            cursor_.get<bool>());
+}
+
+/******************************************************************************/
+
+uPtr<amqp::reader::IValue>
+amqp::internal::reader::
+BoolPropertyReader::dump (
+    const scan::Cursor & cursor_,
+    const SchemaType & schema_) const
+{
+    return std::make_unique<TypedSingle<bool>> (
+            cursor_.get<bool>());
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::reader::
+BoolPropertyReader::visit (
+    const scan::Cursor & cursor_,
+    const SchemaType & schema_,
+    amqp::reader::IVisitor & visitor_) const
+{
+    visitor_.value (cursor_.get<bool>());
 }
 
 /******************************************************************************/
@@ -1,6 +1,7 @@
 #include "DoublePropertyReader.h"
 
 #include "proton/proton_wrapper.h"
+#include "scan/Tape.h"
 
 /******************************************************************************
  *
@@ -45,13 +46,13 @@ DoublePropertyReader::readString (pn_data_t * data_) const {
 uPtr<amqp::reader::IValue>
 amqp::internal::reader::
 DoublePropertyReader::dump (
-    const std::string & name_,
+    amqp::reader::Name name_,
     pn_data_t * data_,
     const SchemaType & schema_) const
 {
-    return std::make_unique<TypedPair<std::string>> (
+    return std::make_unique<TypedPair<double>> (
             name_,
-            std::to_string (proton::readAndNext<double> (data_)));
+            proton::readAndNext<double> (data_));
 }
 
 /******************************************************************************/
@@ -62,8 +63,58 @@ DoublePropertyReader::dump (
         pn_data_t * data_,
         const SchemaType & schema_) const
 {
-    return std::make_unique<TypedSingle<std::string>> (
-            std::to_string (proton::readAndNext<double> (data_)));
+    return std::make_unique<TypedSingle<double>> (
+            proton::readAndNext<double> (data_));
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::reader::
+DoublePropertyReader::visit (
+    pn_data_t * data_,
+    const SchemaType & schema_,
+    amqp::reader::IVisitor & visitor_) const
+{
+    visitor_.value (proton::readAndNext<double> (data_));
+}
+
+/******************************************************************************/
+
+uPtr<amqp::reader::IValue>
+amqp::internal::reader::
+DoublePropertyReader::dump (
+    amqp::reader::Name name_,
+    const scan::Cursor & cursor_,
+    const SchemaType & schema_) const
+{
+    return std::make_unique<TypedPair<double>> (
+            name_,
+            cursor_.get<double>());
+}
+
+/******************************************************************************/
+
+uPtr<amqp::reader::IValue>
+amqp::internal::reader::
+DoublePropertyReader::dump (
+    const scan::Cursor & cursor_,
+    const SchemaType & schema_) const
+{
+    return std::make_unique<TypedSingle<double>> (
+            cursor_.get<double>());
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::reader::
+DoublePropertyReader::visit (
+    const scan::Cursor & cursor_,
+    const SchemaType & schema_,
+    amqp::reader::IVisitor & visitor_) const
+{
+    visitor_.value (cursor_.get<double>());
 }
 
 /******************************************************************************/
@@ -6,6 +6,7 @@
 #include <proton/codec.h>
 
 #include "proton/proton_wrapper.h"
+#include "scan/Tape.h"
 #include "amqp/reader/IReader.h"
 
 /******************************************************************************
@@ -53,13 +54,13 @@ IntPropertyReader::readString (pn_data_t * data_) const {
 uPtr<amqp::reader::IValue>
 amqp::internal::reader::
 IntPropertyReader::dump (
-    const std::string & name_,
+    amqp::reader::Name name_,
     pn_data_t * data_,
     const SchemaType & schema_) const
 {
-    return std::make_unique<TypedPair<std::string>> (
+    return std::make_unique<TypedPair<int>> (
             name_,
-            std::to_string (proton::readAndNext<int> (data_)));
+            proton::readAndNext<int> (data_));
 }
 
 /******************************************************************************/
@@ -70,8 +71,58 @@ IntPropertyReader::dump (
     pn_data_t * data_,
     const SchemaType & schema_) const
 {
-    return std::make_unique<TypedSingle<std::string>> (
-            std::to_string (proton::readAndNext<int> (data_)));
+    return std::make_unique<TypedSingle<int>> (
+            proton::readAndNext<int> (data_));
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::reader::
+IntPropertyReader::visit (
+    pn_data_t * data_,
+    const SchemaType & schema_,
+    amqp::reader::IVisitor & visitor_) const
+{
+    visitor_.value (proton::readAndNext<int> (data_));
+}
+
+/******************************************************************************/
+
+uPtr<amqp::reader::IValue>
+amqp::internal::reader::
+IntPropertyReader::dump (
+    amqp::reader::Name name_,
+    const scan::Cursor & cursor_,
+    const SchemaType & schema_) const
+{
+    return std::make_unique<TypedPair<int>> (
+            name_,
+            cursor_.get<int>());
+}
+
+/******************************************************************************/
+
+uPtr<amqp::reader::IValue>
+amqp::internal::reader::
+IntPropertyReader::dump (
+    const scan::Cursor & cursor_,
+    const SchemaType & schema_) const
+{
+    return std::make_unique<TypedSingle<int>> (
+            cursor_.get<int>());
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::reader::
+IntPropertyReader::visit (
+    const scan::Cursor & cursor_,
+    const SchemaType & schema_,
+    amqp::reader::IVisitor & visitor_) const
+{
+    visitor_.value (cursor_.get<int>());
 }
 
 /******************************************************************************/
@@ -21,7 +21,7 @@ namespace amqp::internal::reader {
         std::any read(pn_data_t *) const override;
 
         uPtr <amqp::reader::IValue> dump(
-                const std::string &,
+                amqp::reader::Name,
                 pn_data_t *,
                 const SchemaType &
         ) const override;
@@ -31,6 +31,29 @@ namespace amqp::internal::reader {
                 const SchemaType &
         ) const override;
 
+        void visit (
+                pn_data_t *,
+                const SchemaType &,
+                amqp::reader::IVisitor &
+        ) const override;
+
+        uPtr<amqp::reader::IValue> dump (
+                amqp::reader::Name,
+                const scan::Cursor &,
+                const SchemaType &
+        ) const override;
+
+        uPtr<amqp::reader::IValue> dump (
+                const scan::Cursor &,
+                const SchemaType &
+        ) const override;
+
+        void visit (
+                const scan::Cursor &,
+                const SchemaType &,
+                amqp::reader::IVisitor &
+        ) const override;
+
         const std::string &name() const override;
         const std::string &type() const override;
     };
@@ -1,6 +1,7 @@
 #include "LongPropertyReader.h"
 
 #include "proton/proton_wrapper.h"
+#include "scan/Tape.h"
 
 /******************************************************************************
  *
@@ -47,13 +48,13 @@ LongPropertyReader::readString (pn_data_t * data_) const {
 uPtr<amqp::reader::IValue>
 amqp::internal::reader::
 LongPropertyReader::dump (
-    const std::string & name_,
+    amqp::reader::Name name_,
     pn_data_t * data_,
     const SchemaType & schema_) const
 {
-    return std::make_unique<TypedPair<std::string>> (
+    return std::make_unique<TypedPair<long>> (
             name_,
-            std::to_string (proton::readAndNext<long> (data_)));
+            proton::readAndNext<long> (data_));
 }
 
 /******************************************************************************/
@@ -64,8 +65,58 @@ LongPropertyReader::dump (
     pn_data_t * data_,
     const SchemaType & schema_) const
 {
-    return std::make_unique<TypedSingle<std::string>> (
-            std::to_string (proton::readAndNext<long> (data_)));
+    return std::make_unique<TypedSingle<long>> (
+            proton::readAndNext<long> (data_));
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::reader::
+LongPropertyReader::visit (
+    pn_data_t * data_,
+    const SchemaType & schema_,
+    amqp::reader::IVisitor & visitor_) const
+{
+    visitor_.value (static_cast<int64_t> (proton::readAndNext<long> (data_)));
+}
+
+/******************************************************************************/
+
+uPtr<amqp::reader::IValue>
+amqp::internal::reader::
+LongPropertyReader::dump (
+    amqp::reader::Name name_,
+    const scan::Cursor & cursor_,
+    const SchemaType & schema_) const
+{
+    return std::make_unique<TypedPair<long>> (
+            name_,
+            cursor_.get<long>());
+}
+
+/******************************************************************************/
+
+uPtr<amqp::reader::IValue>
+amqp::internal::reader::
+LongPropertyReader::dump (
+    const scan::Cursor & cursor_,
+    const SchemaType & schema_) const
+{
+    return std::make_unique<TypedSingle<long>> (
+            cursor_.get<long>());
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::reader::
+LongPropertyReader::visit (
+    const scan::Cursor & cursor_,
+    const SchemaType & schema_,
+    amqp::reader::IVisitor & visitor_) const
+{
+    visitor_.value (static_cast<int64_t> (cursor_.get<long>()));
 }
 
 /******************************************************************************/
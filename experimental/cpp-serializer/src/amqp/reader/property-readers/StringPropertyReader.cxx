@@ -3,6 +3,8 @@
 #include <proton/codec.h>
 
 #include "proton/proton_wrapper.h"
+#include "scan/Tape.h"
+
 
 /******************************************************************************
  *
@@ -49,13 +51,13 @@ StringPropertyReader::readString (pn_data_t * data_) const {
 uPtr<amqp::reader::IValue>
 amqp::internal::reader::
 StringPropertyReader::dump (
-    const std::string & name_,
+    amqp::reader::Name name_,
     pn_data_t * data_,
     const SchemaType & schema_) const
 {
     return std::make_unique<TypedPair<std::string>> (
             name_,
-            "\"" + proton::readAndNext<std::string> (data_) + "\"");
+            proton::readAndNext<std::string> (data_));
 }
 
 /******************************************************************************/
@@ -67,7 +69,57 @@ StringPropertyReader::dump (
         const SchemaType & schema_) const
 {
     return std::make_unique<TypedSingle<std::string>> (
-            "\"" + proton::readAndNext<std::string> (data_) + "\"");
+            proton::readAndNext<std::string> (data_));
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::reader::
+StringPropertyReader::visit (
+    pn_data_t * data_,
+    const SchemaType & schema_,
+    amqp::reader::IVisitor & visitor_) const
+{
+    visitor_.value (proton::readAndNext<std::string> (data_));
+}
+
+/******************************************************************************/
+
+uPtr<amqp::reader::IValue>
+amqp::internal::reader::
+StringPropertyReader::dump (
+    amqp::reader::Name name_,
+    const scan::Cursor & cursor_,
+    const SchemaType & schema_) const
+{
+    return std::make_unique<TypedPair<std::string>> (
+            name_,
+            std::string { cursor_.get<std::string_view>() });
+}
+
+/******************************************************************************/
+
+uPtr<amqp::reader::IValue>
+amqp::internal::reader::
+StringPropertyReader::dump (
+    const scan::Cursor & cursor_,
+    const SchemaType & schema_) const
+{
+    return std::make_unique<TypedSingle<std::string>> (
+            std::string { cursor_.get<std::string_view>() });
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::reader::
+StringPropertyReader::visit (
+    const scan::Cursor & cursor_,
+    const SchemaType & schema_,
+    amqp::reader::IVisitor & visitor_) const
+{
+    visitor_.value (std::string { cursor_.get<std::string_view>() });
 }
 
 /******************************************************************************/
@@ -1,6 +1,7 @@
 #include "ArrayReader.h"
 
 #include "proton/proton_wrapper.h"
+#include "scan/Tape.h"
 
 /******************************************************************************
  *
@@ -14,6 +15,7 @@ ArrayReader::ArrayReader (
     std::weak_ptr<Reader> reader_
 ) : RestrictedReader (std::move (type_))
   , m_reader (std::move (reader_))
+  , m_bulk (m_reader)
 { }
 
 /******************************************************************************/
@@ -29,13 +31,17 @@ ArrayReader::restrictedType() const {
 uPtr<amqp::reader::IValue>
 amqp::internal::reader::
 ArrayReader::dump (
-        const std::string & name_,
+        amqp::reader::Name name_,
         pn_data_t * data_,
         const SchemaType & schema_
 ) const {
     proton::auto_next an (data_);
 
-    return std::make_unique<TypedPair<sList<uPtr<amqp::reader::IValue>>>>(
+    if (m_bulk) {
+        return m_bulk.dump (name_, data_, schema_);
+    }
+
+    return std::make_unique<TypedPair<Elements>>(
             name_,
             dump_ (data_, schema_));
 }
@@ -50,13 +56,17 @@ ArrayReader::dump(
 ) const {
     proton::auto_next an (data_);
 
-    return std::make_unique<TypedSingle<sList<uPtr<amqp::reader::IValue>>>>(
+    if (m_bulk) {
+        return m_bulk.dump (data_, schema_);
+    }
+
+    return std::make_unique<TypedSingle<Elements>>(
             dump_ (data_, schema_));
 }
 
 /******************************************************************************/
 
-sList<uPtr<amqp::reader::IValue>>
+amqp::internal::reader::Elements
 amqp::internal::reader::
 ArrayReader::dump_(
         pn_data_t * data_,
@@ -73,14 +83,197 @@ ArrayReader::dump_(
         {
             proton::auto_list_enter ale (data_, true);
 
+            read.values.reserve (ale.elements());
+
+            auto reader = m_reader.lock();
+
             for (size_t i { 0 } ; i < ale.elements() ; ++i) {
-                read.emplace_back (m_reader.lock()->dump (data_, schema_));
+                read.values.emplace_back (reader->dump (data_, schema_));
+            }
+        }
+    }
+
+    return read;
+}
+
+/******************************************************************************/
+
+
+void
+amqp::internal::reader::
+ArrayReader::visit (
+        pn_data_t * data_,
+        const SchemaType & schema_,
+        amqp::reader::IVisitor & visitor_
+) const {
+    proton::auto_next an (data_);
+
+    if (m_bulk) {
+        m_bulk.visit (data_, schema_, visitor_);
+        return;
+    }
+
+    proton::is_described (data_);
+
+    {
+        proton::auto_enter ae (data_);
+        schema_.fromDescriptor (proton::readAndNext<std::string>(data_));
+
+        {
+            proton::auto_list_enter ale (data_, true);
+
+            visitor_.beginList (ale.elements());
+
+            for (size_t i { 0 } ; i < ale.elements() && !visitor_.halted() ; ++i) {
+                m_reader.lock()->visit (data_, schema_, visitor_);
             }
+
+            visitor_.endList();
         }
     }
+}
+
+/******************************************************************************/
+
+uPtr<amqp::reader::IValue>
+amqp::internal::reader::
+ArrayReader::dump (
+    amqp::reader::Name name_,
+    const scan::Cursor & cursor_,
+    const SchemaType & schema_
+) const {
+    if (m_bulk) {
+        return m_bulk.dump (name_, cursor_, schema_);
+    }
+
+    return std::make_unique<TypedPair<Elements>>(
+            name_,
+            dump_ (cursor_, schema_));
+}
+
+/******************************************************************************/
+
+uPtr<amqp::reader::IValue>
+amqp::internal::reader::
+ArrayReader::dump (
+    const scan::Cursor & cursor_,
+    const SchemaType & schema_
+) const {
+    if (m_bulk) {
+        return m_bulk.dump (cursor_, schema_);
+    }
+
+    return std::make_unique<TypedSingle<Elements>>(
+            dump_ (cursor_, schema_));
+}
+
+/******************************************************************************/
+
+amqp::internal::reader::Elements
+amqp::internal::reader::
+ArrayReader::dump_ (
+    const scan::Cursor & cursor_,
+    const SchemaType & schema_
+) const {
+    auto list = collection (cursor_, schema_);
+    list.list();
+
+    decltype (dump_ (cursor_, schema_)) read;
+    read.values.reserve (list.count());
+
+    auto reader = m_reader.lock();
+    auto element = list.first();
+
+    for (size_t i { 0 } ; i < list.count() ; ++i, element.next()) {
+        read.values.emplace_back (reader->dump (element, schema_));
+    }
 
     return read;
 }
 
 /******************************************************************************/
 
+void
+amqp::internal::reader::
+ArrayReader::visit (
+    const scan::Cursor & cursor_,
+    const SchemaType & schema_,
+    amqp::reader::IVisitor & visitor_
+) const {
+    if (m_bulk) {
+        m_bulk.visit (cursor_, schema_, visitor_);
+        return;
+    }
+
+    auto list = collection (cursor_, schema_);
+    list.list();
+
+    visitor_.beginList (list.count());
+
+    auto reader = m_reader.lock();
+    auto element = list.first();
+
+    for (size_t i { 0 } ; i < list.count() && !visitor_.halted() ; ++i, element.next()) {
+        reader->visit (element, schema_, visitor_);
+    }
+
+    visitor_.endList();
+}
+
+/******************************************************************************/
+
+sVec<uPtr<amqp::reader::IValue>>
+amqp::internal::reader::
+ArrayReader::dumpElements (
+    pn_data_t * data_,
+    size_t elements_,
+    const SchemaType & schema_
+) const {
+    decltype (dumpElements (data_, elements_, schema_)) rtn;
+    rtn.reserve (elements_);
+
+    auto reader = m_reader.lock();
+
+    for (size_t i { 0 } ; i < elements_ ; ++i) {
+        rtn.emplace_back (reader->dump (data_, schema_));
+    }
+
+    return rtn;
+}
+
+/******************************************************************************/
+
+sVec<uPtr<amqp::reader::IValue>>
+amqp::internal::reader::
+ArrayReader::dumpElements (
+    const scan::Cursor & cursor_,
+    size_t elements_,
+    const SchemaType & schema_
+) const {
+    decltype (dumpElements (cursor_, elements_, schema_)) rtn;
+    rtn.reserve (elements_);
+
+    auto reader = m_reader.lock();
+    auto element = cursor_;
+
+    for (size_t i { 0 } ; i < elements_ ; ++i, element.next()) {
+        rtn.emplace_back (reader->dump (element, schema_));
+    }
+
+    return rtn;
+}
+
+/******************************************************************************/
+
+uPtr<amqp::reader::IValue>
+amqp::internal::reader::
+ArrayReader::wrapElements (
+    amqp::reader::Name name_,
+    sVec<uPtr<amqp::reader::IValue>> elements_
+) const {
+    return std::make_unique<TypedPair<Elements>> (
+        name_,
+        Elements { std::move (elements_) });
+}
+
+/******************************************************************************/
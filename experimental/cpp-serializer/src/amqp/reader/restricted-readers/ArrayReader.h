@@ -3,6 +3,7 @@
 /******************************************************************************/
 
 #include "RestrictedReader.h"
+#include "BulkReader.h"
 
 /******************************************************************************/
 
@@ -13,10 +14,17 @@ namespace amqp::internal::reader {
             // How to read the underlying types
             std::weak_ptr<Reader> m_reader;
 
-            std::list<uPtr<amqp::reader::IValue>> dump_(
+            // Set when the elements are primitives we can read in one go
+            BulkReader m_bulk;
+
+            Elements dump_(
                 pn_data_t *,
                 const SchemaType &) const;
 
+            Elements dump_(
+                const scan::Cursor &,
+                const SchemaType &) const;
+
             /**
              * cope with the fact Java can box primitives
              */
@@ -30,13 +38,46 @@ namespace amqp::internal::reader {
             internal::schema::Restricted::RestrictedTypes restrictedType() const;
 
             std::unique_ptr<amqp::reader::IValue> dump(
-                const std::string &,
+                amqp::reader::Name,
+                pn_data_t *,
+                const SchemaType &) const override;
+
+            std::unique_ptr<amqp::reader::IValue> dump(
+                pn_data_t *,
+                const SchemaType &) const override;
+
+            void visit (
                 pn_data_t *,
+                const SchemaType &,
+                amqp::reader::IVisitor &) const override;
+
+            std::unique_ptr<amqp::reader::IValue> dump(
+                amqp::reader::Name,
+                const scan::Cursor &,
                 const SchemaType &) const override;
 
             std::unique_ptr<amqp::reader::IValue> dump(
+                const scan::Cursor &,
+                const SchemaType &) const override;
+
+            void visit (
+                const scan::Cursor &,
+                const SchemaType &,
+                amqp::reader::IVisitor &) const override;
+
+            sVec<uPtr<amqp::reader::IValue>> dumpElements (
                 pn_data_t *,
+                size_t,
+                const SchemaType &) const override;
+
+            sVec<uPtr<amqp::reader::IValue>> dumpElements (
+                const scan::Cursor &,
+                size_t,
                 const SchemaType &) const override;
+
+            uPtr<amqp::reader::IValue> wrapElements (
+                amqp::reader::Name,
+                sVec<uPtr<amqp::reader::IValue>>) const override;
     };
 
 }
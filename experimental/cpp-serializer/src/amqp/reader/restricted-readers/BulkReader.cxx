@@ -0,0 +1,310 @@
+#include "BulkReader.h"
+
+#include <cstring>
+#include <cstdint>
+#include <type_traits>
+
+#include "RestrictedReader.h"
+
+#include "proton/proton_wrapper.h"
+#include "scan/Tape.h"
+
+namespace {
+
+    using amqp::internal::reader::TypedPair;
+    using amqp::internal::reader::TypedSingle;
+
+    /**
+     * Wrap the values read as the value of a named property
+     */
+    struct Named {
+        amqp::reader::Name name;
+
+        template<class T>
+        uPtr<amqp::reader::IValue>
+        operator () (T values_) const {
+            return std::make_unique<TypedPair<T>> (name, std::move (values_));
+        }
+    };
+
+    struct Unnamed {
+        template<class T>
+        uPtr<amqp::reader::IValue>
+        operator () (T values_) const {
+            return std::make_unique<TypedSingle<T>> (std::move (values_));
+        }
+    };
+
+    /**
+     * The full width format code of each of the types we read in bulk
+     */
+    template<typename T> constexpr uint8_t wide();
+    template<> constexpr uint8_t wide<int>() { return 0x71; }
+    template<> constexpr uint8_t wide<long>() { return 0x81; }
+    template<> constexpr uint8_t wide<double>() { return 0x82; }
+
+    /**
+     * If every one of the [values_.size()] elements starting at [first_]
+     * has the full width constructor they sit at a fixed stride through
+     * the buffer, so read them straight out of it, swapping each from
+     * big endian as we go, rather than through a cursor one at a time.
+     * False, and [values_] to be ignored, if any of them doesn't.
+     */
+    template<typename T>
+    bool
+    strided (const amqp::internal::scan::Cursor & first_, sVec<T> & values_) {
+        using Bits = std::conditional_t<sizeof (T) == 4, uint32_t, uint64_t>;
+
+        constexpr size_t stride { 1 + sizeof (T) };
+
+        auto from = first_.raw().data();
+
+        for (auto & value : values_) {
+            if (static_cast<uint8_t> (*from) != wide<T>()) {
+                return false;
+            }
+
+            Bits bits { 0 };
+            for (size_t i { 1 } ; i < stride ; ++i) {
+                bits = (bits << 8) | static_cast<uint8_t> (from[i]);
+            }
+
+            memcpy (&value, &bits, sizeof (T));
+            from += stride;
+        }
+
+        return true;
+    }
+
+}
+
+/******************************************************************************
+ *
+ * class BulkReader
+ *
+ ******************************************************************************/
+
+amqp::internal::reader::
+BulkReader::BulkReader (const std::weak_ptr<Reader> & reader_)
+    : m_kind (none_k)
+{
+    if (auto reader = reader_.lock()) {
+        const auto & type = reader->type();
+
+        if (type == "int") {
+            m_kind = int_k;
+        } else if (type == "long") {
+            m_kind = long_k;
+        } else if (type == "double") {
+            m_kind = double_k;
+        }
+    }
+}
+
+/******************************************************************************/
+
+/**
+ * Expects to be positioned on the described list itself, the caller
+ * is responsible for moving past it
+ */
+template<typename T>
+amqp::internal::reader::Primitives<T>
+amqp::internal::reader::
+BulkReader::read (
+    pn_data_t * data_,
+    const SchemaType & schema_
+) const {
+    proton::is_described (data_);
+
+    Primitives<T> rtn;
+
+    {
+        proton::auto_enter ae (data_);
+        schema_.fromDescriptor (proton::readAndNext<std::string>(data_));
+
+        {
+            proton::auto_list_enter ale (data_, true);
+
+            rtn.values.resize (ale.elements());
+
+            for (auto & value : rtn.values) {
+                value = proton::readAndNext<T> (data_);
+            }
+        }
+    }
+
+    return rtn;
+}
+
+/******************************************************************************/
+
+template<typename T>
+amqp::internal::reader::Primitives<T>
+amqp::internal::reader::
+BulkReader::read (
+    const scan::Cursor & cursor_,
+    const SchemaType & schema_
+) const {
+    auto list = RestrictedReader::collection (cursor_, schema_);
+    list.list();
+
+    Primitives<T> rtn;
+    rtn.values.resize (list.count());
+
+    if (rtn.values.empty()) {
+        return rtn;
+    }
+
+    auto element = list.first();
+
+    // The elements end where the list does so if there's exactly room
+    // for them all at full width that's what they might be
+    auto bytes = list.entry().offset + list.entry().size - element.entry().offset;
+
+    if (bytes == rtn.values.size() * (1 + sizeof (T)) && strided (element, rtn.values)) {
+        return rtn;
+    }
+
+    for (auto & value : rtn.values) {
+        value = element.get<T>();
+        element.next();
+    }
+
+    return rtn;
+}
+
+/******************************************************************************/
+
+template<typename T>
+void
+amqp::internal::reader::
+BulkReader::visit (
+    const Primitives<T> & primitives_,
+    amqp::reader::IVisitor & visitor_
+) const {
+    const auto & values = primitives_.values;
+
+    visitor_.beginList (values.size());
+
+    for (size_t i { 0 } ; i < values.size() && !visitor_.halted() ; ++i) {
+        if constexpr (std::is_same_v<T, long>) {
+            visitor_.value (static_cast<int64_t> (values[i]));
+        } else {
+            visitor_.value (values[i]);
+        }
+    }
+
+    visitor_.endList();
+}
+
+/******************************************************************************/
+
+template<class Source, class Make>
+uPtr<amqp::reader::IValue>
+amqp::internal::reader::
+BulkReader::dumpAs (
+    Source source_,
+    const SchemaType & schema_,
+    Make make_
+) const {
+    switch (m_kind) {
+        case int_k    : return make_ (read<int> (source_, schema_));
+        case long_k   : return make_ (read<long> (source_, schema_));
+        case double_k : return make_ (read<double> (source_, schema_));
+        case none_k   : break;
+    }
+
+    throw std::logic_error ("BulkReader used for a non primitive type");
+}
+
+/******************************************************************************/
+
+template<class Source>
+void
+amqp::internal::reader::
+BulkReader::visitAs (
+    Source source_,
+    const SchemaType & schema_,
+    amqp::reader::IVisitor & visitor_
+) const {
+    switch (m_kind) {
+        case int_k    : visit (read<int> (source_, schema_), visitor_); return;
+        case long_k   : visit (read<long> (source_, schema_), visitor_); return;
+        case double_k : visit (read<double> (source_, schema_), visitor_); return;
+        case none_k   : break;
+    }
+
+    throw std::logic_error ("BulkReader used for a non primitive type");
+}
+
+/******************************************************************************/
+
+uPtr<amqp::reader::IValue>
+amqp::internal::reader::
+BulkReader::dump (
+    amqp::reader::Name name_,
+    pn_data_t * data_,
+    const SchemaType & schema_
+) const {
+    return dumpAs (data_, schema_, Named { name_ });
+}
+
+/******************************************************************************/
+
+uPtr<amqp::reader::IValue>
+amqp::internal::reader::
+BulkReader::dump (
+    pn_data_t * data_,
+    const SchemaType & schema_
+) const {
+    return dumpAs (data_, schema_, Unnamed { });
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::reader::
+BulkReader::visit (
+    pn_data_t * data_,
+    const SchemaType & schema_,
+    amqp::reader::IVisitor & visitor_
+) const {
+    visitAs (data_, schema_, visitor_);
+}
+
+/******************************************************************************/
+
+uPtr<amqp::reader::IValue>
+amqp::internal::reader::
+BulkReader::dump (
+    amqp::reader::Name name_,
+    const scan::Cursor & cursor_,
+    const SchemaType & schema_
+) const {
+    return dumpAs<const scan::Cursor &> (cursor_, schema_, Named { name_ });
+}
+
+/******************************************************************************/
+
+uPtr<amqp::reader::IValue>
+amqp::internal::reader::
+BulkReader::dump (
+    const scan::Cursor & cursor_,
+    const SchemaType & schema_
+) const {
+    return dumpAs<const scan::Cursor &> (cursor_, schema_, Unnamed { });
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::reader::
+BulkReader::visit (
+    const scan::Cursor & cursor_,
+    const SchemaType & schema_,
+    amqp::reader::IVisitor & visitor_
+) const {
+    visitAs<const scan::Cursor &> (cursor_, schema_, visitor_);
+}
+
+/******************************************************************************/
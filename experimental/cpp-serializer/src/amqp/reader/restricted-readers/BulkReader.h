@@ -0,0 +1,101 @@
+#pragma once
+
+/******************************************************************************/
+
+#include "Reader.h"
+
+/******************************************************************************/
+
+namespace amqp::internal::reader {
+
+    /**
+     * Lists and arrays whose elements are int, long or double don't need
+     * to go through the element reader one value at a time, every element
+     * is read straight into a single contiguous buffer.
+     *
+     * Proton has already decoded the wire format into host order values
+     * by the time we see them so there is no byte swapping to be done
+     * here, the saving is the virtual call and allocation per element.
+     *
+     * Reading from a [scan::Tape] each element still has its own
+     * constructor, which may pick a narrower encoding for small values,
+     * so there's no single run of values to copy out whole. Where every
+     * element is at full width, as doubles always are, they sit at a
+     * fixed stride through the buffer and are read in one pass over it,
+     * swapping each from big endian, without touching the tape. Anything
+     * else is decoded one element at a time.
+     */
+    class BulkReader {
+        private :
+            using SchemaType = Reader::SchemaType;
+
+            enum Kind { none_k, int_k, long_k, double_k };
+
+            Kind m_kind;
+
+            template<typename T>
+            Primitives<T> read (pn_data_t *, const SchemaType &) const;
+
+            template<typename T>
+            Primitives<T> read (const scan::Cursor &, const SchemaType &) const;
+
+            template<typename T>
+            void visit (const Primitives<T> &, amqp::reader::IVisitor &) const;
+
+            /**
+             * The switch on [m_kind] is the same whichever of proton or a
+             * tape we're reading from. [make_] is handed the values read
+             * and wraps them up as a named or unnamed value.
+             */
+            template<class Source, class Make>
+            uPtr<amqp::reader::IValue> dumpAs (
+                Source,
+                const SchemaType &,
+                Make make_) const;
+
+            template<class Source>
+            void visitAs (
+                Source,
+                const SchemaType &,
+                amqp::reader::IVisitor &) const;
+
+        public :
+            explicit BulkReader (const std::weak_ptr<Reader> &);
+
+            /**
+             * true if the elements are of a type we can read in bulk
+             */
+            explicit operator bool() const { return m_kind != none_k; }
+
+            uPtr<amqp::reader::IValue> dump (
+                amqp::reader::Name,
+                pn_data_t *,
+                const SchemaType &) const;
+
+            uPtr<amqp::reader::IValue> dump (
+                pn_data_t *,
+                const SchemaType &) const;
+
+            void visit (
+                pn_data_t *,
+                const SchemaType &,
+                amqp::reader::IVisitor &) const;
+
+            uPtr<amqp::reader::IValue> dump (
+                amqp::reader::Name,
+                const scan::Cursor &,
+                const SchemaType &) const;
+
+            uPtr<amqp::reader::IValue> dump (
+                const scan::Cursor &,
+                const SchemaType &) const;
+
+            void visit (
+                const scan::Cursor &,
+                const SchemaType &,
+                amqp::reader::IVisitor &) const;
+    };
+
+}
+
+/******************************************************************************/
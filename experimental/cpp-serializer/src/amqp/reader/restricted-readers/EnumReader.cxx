@@ -4,6 +4,7 @@
 #include "amqp/schema/Descriptors.h"
 #include "amqp/schema/descriptors/AMQPDescriptorRegistory.h"
 #include "proton/proton_wrapper.h"
+#include "scan/Tape.h"
 
 /******************************************************************************/
 
@@ -36,7 +37,7 @@ namespace {
              */
             if (pn_data_type (data_) == PN_ULONG) {
                 if (amqp::stripCorda(pn_data_get_ulong(data_)) ==
-                amqp::schema::descriptors::REFERENCED_OBJECT
+                static_cast<uint32_t> (amqp::schema::descriptors::REFERENCED_OBJECT)
             ) {
                     throw std::runtime_error (
                             "Currently don't support referenced objects");
@@ -58,6 +59,39 @@ namespace {
             // auto idx = proton::readAndNext<int>(data_);
         }
     }
+
+    /**
+     * As above but from a [scan::Tape]
+     */
+    std::string
+    getValue (const amqp::internal::scan::Cursor & cursor_) {
+        auto descriptor = cursor_.descriptor();
+
+        switch (descriptor.code()) {
+            case 0x44 :
+            case 0x53 :
+            case 0x80 : {
+                if (amqp::stripCorda (descriptor.get<uint64_t>()) ==
+                    static_cast<uint32_t> (amqp::schema::descriptors::REFERENCED_OBJECT)
+                ) {
+                    throw std::runtime_error (
+                            "Currently don't support referenced objects");
+                }
+            }
+        }
+
+        // otherwise the descriptor's the enum's fingerprint, which we
+        // don't need to read the value
+
+        auto list = cursor_.value();
+        list.list();
+
+        if (list.count() == 0) {
+            throw std::runtime_error ("Enumerated value is missing its name");
+        }
+
+        return std::string { list.first().get<std::string_view>() };
+    }
 }
 
 /******************************************************************************/
@@ -65,7 +99,7 @@ namespace {
 std::unique_ptr<amqp::reader::IValue>
 amqp::internal::reader::
 EnumReader::dump (
-        const std::string & name_,
+        amqp::reader::Name name_,
         pn_data_t * data_,
         const SchemaType & schema_
 ) const {
@@ -92,3 +126,55 @@ EnumReader::dump(
 }
 
 /******************************************************************************/
+
+void
+amqp::internal::reader::
+EnumReader::visit (
+        pn_data_t * data_,
+        const SchemaType & schema_,
+        amqp::reader::IVisitor & visitor_
+) const {
+    proton::auto_next an (data_);
+    proton::is_described (data_);
+
+    visitor_.value (getValue (data_));
+}
+
+/******************************************************************************/
+
+std::unique_ptr<amqp::reader::IValue>
+amqp::internal::reader::
+EnumReader::dump (
+        amqp::reader::Name name_,
+        const scan::Cursor & cursor_,
+        const SchemaType & schema_
+) const {
+    return std::make_unique<TypedPair<std::string>> (
+            name_,
+            getValue (cursor_));
+}
+
+/******************************************************************************/
+
+std::unique_ptr<amqp::reader::IValue>
+amqp::internal::reader::
+EnumReader::dump (
+        const scan::Cursor & cursor_,
+        const SchemaType & schema_
+) const {
+    return std::make_unique<TypedSingle<std::string>> (getValue (cursor_));
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::reader::
+EnumReader::visit (
+        const scan::Cursor & cursor_,
+        const SchemaType & schema_,
+        amqp::reader::IVisitor & visitor_
+) const {
+    visitor_.value (getValue (cursor_));
+}
+
+/******************************************************************************/
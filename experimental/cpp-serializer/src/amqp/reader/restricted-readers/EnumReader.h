@@ -13,13 +13,32 @@ namespace amqp::internal::reader {
             EnumReader (std::string, std::vector<std::string>);
 
             std::unique_ptr<amqp::reader::IValue> dump(
-                const std::string &,
+                amqp::reader::Name,
                 pn_data_t *,
                 const SchemaType &) const override;
 
             std::unique_ptr<amqp::reader::IValue> dump(
                 pn_data_t *,
                 const SchemaType &) const override;
+
+            void visit (
+                pn_data_t *,
+                const SchemaType &,
+                amqp::reader::IVisitor &) const override;
+
+            std::unique_ptr<amqp::reader::IValue> dump(
+                amqp::reader::Name,
+                const scan::Cursor &,
+                const SchemaType &) const override;
+
+            std::unique_ptr<amqp::reader::IValue> dump(
+                const scan::Cursor &,
+                const SchemaType &) const override;
+
+            void visit (
+                const scan::Cursor &,
+                const SchemaType &,
+                amqp::reader::IVisitor &) const override;
     };
 
 }
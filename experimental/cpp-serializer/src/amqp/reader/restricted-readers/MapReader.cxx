@@ -3,6 +3,7 @@
 #include "Reader.h"
 #include "amqp/reader/IReader.h"
 #include "proton/proton_wrapper.h"
+#include "scan/Tape.h"
 
 /******************************************************************************/
 
@@ -36,10 +37,14 @@ MapReader::dump_(
         decltype (dump_(data_, schema_)) rtn;
         rtn.reserve (am.elements() / 2);
 
-        for (int i {0} ; i < am.elements() ; i += 2) {
+        for (size_t i {0} ; i < am.elements() ; i += 2) {
+            // The order of evaluation of function arguments is unspecified
+            // so make sure we always read the key before its value
+            auto key = m_keyReader.lock()->dump (data_, schema_);
+
             rtn.emplace_back (
                 std::make_unique<ValuePair> (
-                    m_keyReader.lock()->dump (data_, schema_),
+                    std::move (key),
                     m_valueReader.lock()->dump (data_, schema_)
                 )
             );
@@ -54,7 +59,7 @@ MapReader::dump_(
 uPtr<amqp::reader::IValue>
 amqp::internal::reader::
 MapReader::dump(
-        const std::string & name_,
+        amqp::reader::Name name_,
         pn_data_t * data_,
         const SchemaType & schema_
 ) const {
@@ -80,3 +85,193 @@ MapReader::dump(
 }
 
 /******************************************************************************/
+
+void
+amqp::internal::reader::
+MapReader::visit (
+        pn_data_t * data_,
+        const SchemaType & schema_,
+        amqp::reader::IVisitor & visitor_
+) const {
+    proton::auto_next an (data_);
+    proton::is_described (data_);
+    proton::auto_enter ae (data_);
+
+    schema_.fromDescriptor (proton::readAndNext<std::string>(data_));
+
+    {
+        proton::auto_map_enter am (data_, true);
+
+        visitor_.beginMap (am.elements() / 2);
+
+        for (size_t i {0} ; i < am.elements() && !visitor_.halted() ; i += 2) {
+            m_keyReader.lock()->visit (data_, schema_, visitor_);
+            m_valueReader.lock()->visit (data_, schema_, visitor_);
+        }
+
+        visitor_.endMap();
+    }
+}
+
+/******************************************************************************/
+
+sVec<uPtr<amqp::reader::IValue>>
+amqp::internal::reader::
+MapReader::dump_ (
+    const scan::Cursor & cursor_,
+    const SchemaType & schema_
+) const {
+    auto map = collection (cursor_, schema_);
+    map.map();
+
+    decltype (dump_ (cursor_, schema_)) rtn;
+    rtn.reserve (map.count() / 2);
+
+    auto keyReader = m_keyReader.lock();
+    auto valueReader = m_valueReader.lock();
+
+    auto element = map.first();
+
+    for (size_t i { 0 } ; i < map.count() ; i += 2) {
+        auto key = keyReader->dump (element, schema_);
+        element.next();
+
+        rtn.emplace_back (
+            std::make_unique<ValuePair> (
+                std::move (key),
+                valueReader->dump (element, schema_)));
+        element.next();
+    }
+
+    return rtn;
+}
+
+/******************************************************************************/
+
+uPtr<amqp::reader::IValue>
+amqp::internal::reader::
+MapReader::dump (
+    amqp::reader::Name name_,
+    const scan::Cursor & cursor_,
+    const SchemaType & schema_
+) const {
+    return std::make_unique<TypedPair<sVec<uPtr<amqp::reader::IValue>>>>(
+            name_,
+            dump_ (cursor_, schema_));
+}
+
+/******************************************************************************/
+
+uPtr<amqp::reader::IValue>
+amqp::internal::reader::
+MapReader::dump (
+    const scan::Cursor & cursor_,
+    const SchemaType & schema_
+) const {
+    return std::make_unique<TypedSingle<sVec<uPtr<amqp::reader::IValue>>>>(
+            dump_ (cursor_, schema_));
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::reader::
+MapReader::visit (
+    const scan::Cursor & cursor_,
+    const SchemaType & schema_,
+    amqp::reader::IVisitor & visitor_
+) const {
+    auto map = collection (cursor_, schema_);
+    map.map();
+
+    visitor_.beginMap (map.count() / 2);
+
+    auto keyReader = m_keyReader.lock();
+    auto valueReader = m_valueReader.lock();
+
+    auto element = map.first();
+
+    for (size_t i { 0 } ; i < map.count() && !visitor_.halted() ; i += 2) {
+        visitor_.encoded (element.entry().size);
+        keyReader->visit (element, schema_, visitor_);
+        element.next();
+        visitor_.encoded (element.entry().size);
+        valueReader->visit (element, schema_, visitor_);
+        element.next();
+    }
+
+    visitor_.endMap();
+}
+
+/******************************************************************************/
+
+sVec<uPtr<amqp::reader::IValue>>
+amqp::internal::reader::
+MapReader::dumpElements (
+    pn_data_t * data_,
+    size_t elements_,
+    const SchemaType & schema_
+) const {
+    decltype (dumpElements (data_, elements_, schema_)) rtn;
+    rtn.reserve (elements_);
+
+    auto keyReader = m_keyReader.lock();
+    auto valueReader = m_valueReader.lock();
+
+    for (size_t i { 0 } ; i < elements_ ; ++i) {
+        auto key = keyReader->dump (data_, schema_);
+
+        rtn.emplace_back (
+            std::make_unique<ValuePair> (
+                std::move (key),
+                valueReader->dump (data_, schema_)));
+    }
+
+    return rtn;
+}
+
+/******************************************************************************/
+
+sVec<uPtr<amqp::reader::IValue>>
+amqp::internal::reader::
+MapReader::dumpElements (
+    const scan::Cursor & cursor_,
+    size_t elements_,
+    const SchemaType & schema_
+) const {
+    decltype (dumpElements (cursor_, elements_, schema_)) rtn;
+    rtn.reserve (elements_);
+
+    auto keyReader = m_keyReader.lock();
+    auto valueReader = m_valueReader.lock();
+
+    auto element = cursor_;
+
+    for (size_t i { 0 } ; i < elements_ ; ++i) {
+        auto key = keyReader->dump (element, schema_);
+        element.next();
+
+        rtn.emplace_back (
+            std::make_unique<ValuePair> (
+                std::move (key),
+                valueReader->dump (element, schema_)));
+        element.next();
+    }
+
+    return rtn;
+}
+
+/******************************************************************************/
+
+uPtr<amqp::reader::IValue>
+amqp::internal::reader::
+MapReader::wrapElements (
+    amqp::reader::Name name_,
+    sVec<uPtr<amqp::reader::IValue>> elements_
+) const {
+    return std::make_unique<TypedPair<sVec<uPtr<amqp::reader::IValue>>>> (
+        name_,
+        std::move (elements_));
+}
+
+/******************************************************************************/
@@ -18,6 +18,10 @@ namespace amqp::internal::reader {
                     pn_data_t *,
                     const SchemaType &) const;
 
+            sVec<uPtr<amqp::reader::IValue>> dump_(
+                    const scan::Cursor &,
+                    const SchemaType &) const;
+
         public :
             MapReader (
                 const std::string & type_,
@@ -33,13 +37,46 @@ namespace amqp::internal::reader {
             internal::schema::Restricted::RestrictedTypes restrictedType() const;
 
             std::unique_ptr<amqp::reader::IValue> dump(
-                const std::string &,
+                amqp::reader::Name,
+                pn_data_t *,
+                const SchemaType &) const override;
+
+            std::unique_ptr<amqp::reader::IValue> dump(
+                pn_data_t *,
+                const SchemaType &) const override;
+
+            void visit (
                 pn_data_t *,
+                const SchemaType &,
+                amqp::reader::IVisitor &) const override;
+
+            std::unique_ptr<amqp::reader::IValue> dump(
+                amqp::reader::Name,
+                const scan::Cursor &,
                 const SchemaType &) const override;
 
             std::unique_ptr<amqp::reader::IValue> dump(
+                const scan::Cursor &,
+                const SchemaType &) const override;
+
+            void visit (
+                const scan::Cursor &,
+                const SchemaType &,
+                amqp::reader::IVisitor &) const override;
+
+            sVec<uPtr<amqp::reader::IValue>> dumpElements (
                 pn_data_t *,
+                size_t,
+                const SchemaType &) const override;
+
+            sVec<uPtr<amqp::reader::IValue>> dumpElements (
+                const scan::Cursor &,
+                size_t,
                 const SchemaType &) const override;
+
+            uPtr<amqp::reader::IValue> wrapElements (
+                amqp::reader::Name,
+                sVec<uPtr<amqp::reader::IValue>>) const override;
     };
 
 }
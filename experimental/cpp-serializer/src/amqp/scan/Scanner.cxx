@@ -0,0 +1,218 @@
+#include "Scanner.h"
+
+#include <sstream>
+#include <stdexcept>
+
+/******************************************************************************
+ *
+ * amqp::internal::scan::Scanner
+ *
+ ******************************************************************************/
+
+amqp::internal::scan::
+Scanner::Scanner (const char * bytes_, size_t size_)
+    : m_bytes (reinterpret_cast<const uint8_t *> (bytes_))
+    , m_size (size_)
+{ }
+
+/******************************************************************************/
+
+void
+amqp::internal::scan::
+Scanner::error (size_t offset_, const std::string & what_) const {
+    std::stringstream ss;
+    ss << "Bad AMQP encoding at offset " << offset_ << ": " << what_;
+    throw std::runtime_error (ss.str());
+}
+
+/******************************************************************************/
+
+/**
+ * Everything on the wire is big endian
+ */
+uint64_t
+amqp::internal::scan::
+Scanner::read (size_t offset_, size_t bytes_) const {
+    if (offset_ + bytes_ > m_size) {
+        error (offset_, "truncated");
+    }
+
+    uint64_t rtn { 0 };
+    for (size_t i { 0 } ; i < bytes_ ; ++i) {
+        rtn = (rtn << 8) | m_bytes[offset_ + i];
+    }
+
+    return rtn;
+}
+
+/******************************************************************************/
+
+/**
+ * Both halves of a described type can themselves be described so rather
+ * than recurse, which a long enough run of 0x00s would overflow the stack
+ * doing, count how many values are still to be stepped over. Each 0x00
+ * replaces the one value it begins with the two it's made of.
+ */
+amqp::internal::scan::Node
+amqp::internal::scan::
+Scanner::at (size_t offset_) const {
+    auto code = static_cast<uint8_t> (read (offset_, 1));
+
+    if (code != 0x00) {
+        return primitive (offset_, code);
+    }
+
+    size_t offset { offset_ };
+    size_t pending { 1 };
+
+    while (pending) {
+        auto next = static_cast<uint8_t> (read (offset, 1));
+
+        if (next == 0x00) {
+            ++offset;
+            ++pending;
+        } else {
+            offset = primitive (offset, next).end();
+            --pending;
+        }
+    }
+
+    return Node { offset_, offset - offset_, code, offset_ + 1, 2 };
+}
+
+/******************************************************************************/
+
+amqp::internal::scan::Node
+amqp::internal::scan::
+Scanner::primitive (size_t offset_, uint8_t code_) const {
+    Node rtn { offset_, 1, code_, offset_ + 1, 0 };
+
+    // The high nibble of the format code tells us how the size of the
+    // value is encoded
+    switch (code_ >> 4) {
+        case 0x4 : break;
+        case 0x5 : rtn.size = 2; break;
+        case 0x6 : rtn.size = 3; break;
+        case 0x7 : rtn.size = 5; break;
+        case 0x8 : rtn.size = 9; break;
+        case 0x9 : rtn.size = 17; break;
+        case 0xA : {
+            rtn.size = 2 + read (offset_ + 1, 1);
+            rtn.body = offset_ + 2;
+            break;
+        }
+        case 0xB : {
+            rtn.size = 5 + read (offset_ + 1, 4);
+            rtn.body = offset_ + 5;
+            break;
+        }
+        case 0xC :
+        case 0xE : {
+            rtn.size = 2 + read (offset_ + 1, 1);
+            rtn.count = static_cast<uint32_t> (read (offset_ + 2, 1));
+            rtn.body = offset_ + 3;
+            break;
+        }
+        case 0xD :
+        case 0xF : {
+            rtn.size = 5 + read (offset_ + 1, 4);
+            rtn.count = static_cast<uint32_t> (read (offset_ + 5, 4));
+            rtn.body = offset_ + 9;
+            break;
+        }
+        default : {
+            std::stringstream ss;
+            ss << "unknown format code 0x" << std::hex << int { code_ };
+            error (offset_, ss.str());
+        }
+    }
+
+    if (rtn.end() > m_size) {
+        error (offset_, "truncated");
+    }
+
+    return rtn;
+}
+
+/******************************************************************************/
+
+sVec<amqp::internal::scan::Node>
+amqp::internal::scan::
+Scanner::children (const Node & node_) const {
+    sVec<Node> rtn;
+
+    if (node_.code == 0x00) {
+        rtn.push_back (at (node_.offset + 1));
+        rtn.push_back (at (rtn.back().end()));
+
+        return rtn;
+    }
+
+    if (!isList (node_.code) && !isMap (node_.code)) {
+        error (node_.offset, "only described types, lists and maps have children");
+    }
+
+    rtn.reserve (node_.count);
+
+    auto offset = node_.body;
+    for (uint32_t i { 0 } ; i < node_.count ; ++i) {
+        rtn.push_back (at (offset));
+        offset = rtn.back().end();
+    }
+
+    if (offset > node_.end()) {
+        error (node_.offset, "elements overrun their container");
+    }
+
+    return rtn;
+}
+
+/******************************************************************************/
+
+std::string_view
+amqp::internal::scan::
+Scanner::bytes (const Node & node_) const {
+    if ((node_.code >> 4) != 0xA && (node_.code >> 4) != 0xB) {
+        error (node_.offset, "not a variable width value");
+    }
+
+    return std::string_view (
+        reinterpret_cast<const char *> (m_bytes + node_.body),
+        node_.end() - node_.body);
+}
+
+/******************************************************************************/
+
+std::string_view
+amqp::internal::scan::
+Scanner::raw (const Node & node_) const {
+    return std::string_view (
+        reinterpret_cast<const char *> (m_bytes + node_.offset),
+        node_.size);
+}
+
+/******************************************************************************/
+
+bool
+amqp::internal::scan::
+Scanner::isList (uint8_t code_) {
+    return code_ == 0x45 || code_ == 0xC0 || code_ == 0xD0;
+}
+
+/******************************************************************************/
+
+bool
+amqp::internal::scan::
+Scanner::isMap (uint8_t code_) {
+    return code_ == 0xC1 || code_ == 0xD1;
+}
+
+/******************************************************************************/
+
+bool
+amqp::internal::scan::
+Scanner::isArray (uint8_t code_) {
+    return code_ == 0xE0 || code_ == 0xF0;
+}
+
+/******************************************************************************/
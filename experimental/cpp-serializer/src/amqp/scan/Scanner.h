@@ -0,0 +1,101 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <string_view>
+
+#include "types.h"
+
+/******************************************************************************/
+
+namespace amqp::internal::scan {
+
+    /**
+     * Where a single AMQP encoded value lives within a buffer, worked out
+     * from its constructor and size prefix alone without decoding it
+     */
+    struct Node {
+        /**
+         * The offset of the format code, for described types that's
+         * the 0x00 that precedes the descriptor
+         */
+        size_t   offset;
+
+        /**
+         * Total number of bytes the value occupies including its
+         * constructor
+         */
+        size_t   size;
+
+        uint8_t  code;
+
+        /**
+         * For lists, maps and arrays the offset of the first element,
+         * for strings, symbols and binary the offset of the first
+         * byte of data, for anything else the byte after the code
+         */
+        size_t   body;
+
+        /**
+         * Number of elements in a list, map or array. A map counts
+         * both its keys and values, as on the wire.
+         */
+        uint32_t count;
+
+        size_t end() const { return offset + size; }
+    };
+
+    /**
+     * Walks the raw AMQP encoding of a blob, as described in section 1.6
+     * of the AMQP 1.0 spec, reading just enough of each constructor to
+     * know how big the value is. No values are decoded and nothing is
+     * allocated beyond the vectors of children asked for.
+     */
+    class Scanner {
+        private :
+            const uint8_t * m_bytes;
+            size_t          m_size;
+
+            uint64_t read (size_t, size_t) const;
+
+            /**
+             * A value that isn't described, [code_] being its format code
+             */
+            Node primitive (size_t, uint8_t code_) const;
+
+            [[noreturn]] void error (size_t, const std::string &) const;
+
+        public :
+            Scanner (const char *, size_t);
+
+            /**
+             * The value whose constructor begins at the given offset
+             */
+            Node at (size_t) const;
+
+            /**
+             * For a described type its descriptor and its value, for a
+             * list or map its elements in order. Arrays share a single
+             * constructor between their elements so they can't be
+             * split up in this way.
+             */
+            sVec<Node> children (const Node &) const;
+
+            /**
+             * The data of a string, symbol or binary
+             */
+            std::string_view bytes (const Node &) const;
+
+            std::string_view raw (const Node &) const;
+
+            static bool isList (uint8_t);
+            static bool isMap (uint8_t);
+            static bool isArray (uint8_t);
+    };
+
+}
+
+/******************************************************************************/
@@ -0,0 +1,350 @@
+#include "Tape.h"
+#include "Scanner.h"
+
+#include <limits>
+#include <cstring>
+#include <sstream>
+#include <ostream>
+#include <iomanip>
+#include <stdexcept>
+
+/******************************************************************************/
+
+namespace {
+
+    /**
+     * Everything on the wire is big endian
+     */
+    uint64_t
+    readBE (const char * bytes_, size_t n_) {
+        uint64_t rtn { 0 };
+        for (size_t i { 0 } ; i < n_ ; ++i) {
+            rtn = (rtn << 8) | static_cast<uint8_t> (bytes_[i]);
+        }
+
+        return rtn;
+    }
+
+    /**
+     * A container we've written the entry for but not yet seen the end of
+     */
+    struct Open {
+        size_t   index;
+        uint32_t remaining;
+    };
+
+}
+
+/******************************************************************************
+ *
+ * amqp::internal::scan::Tape
+ *
+ ******************************************************************************/
+
+/**
+ * Rather than recurse we keep a stack of the containers we're within and
+ * how many children each has left. When a node is complete so is every
+ * container that it was the last child of, and those entries can then
+ * be told where their next sibling starts.
+ */
+amqp::internal::scan::
+Tape::Tape (const char * bytes_, size_t size_)
+    : m_bytes (bytes_)
+{
+    if (size_ > std::numeric_limits<uint32_t>::max()) {
+        throw std::runtime_error ("Blobs over 4GiB can't be indexed");
+    }
+
+    Scanner scanner (bytes_, size_);
+
+    sVec<Open> open;
+    size_t offset { 0 };
+
+    do {
+        auto index = m_entries.size();
+
+        if (offset >= size_) {
+            std::stringstream ss;
+            ss << "Bad AMQP encoding at offset " << offset << ": truncated";
+            throw std::runtime_error (ss.str());
+        }
+
+        // The size of a described type isn't known until we've seen its
+        // value so treat it as a container of two
+        if (bytes_[offset] == 0x00) {
+            m_entries.push_back ({
+                static_cast<uint32_t> (offset), 0, 2, 0, 0x00 });
+
+            open.push_back ({ index, 2 });
+            ++offset;
+            continue;
+        }
+
+        auto node = scanner.at (offset);
+
+        m_entries.push_back ({
+            static_cast<uint32_t> (node.offset),
+            static_cast<uint32_t> (node.size),
+            Scanner::isArray (node.code) ? 0 : node.count,
+            static_cast<uint32_t> (index + 1),
+            node.code });
+
+        if ((Scanner::isList (node.code) || Scanner::isMap (node.code))
+            && node.count > 0)
+        {
+            open.push_back ({ index, node.count });
+            offset = node.body;
+            continue;
+        }
+
+        offset = node.end();
+
+        while (!open.empty() && --open.back().remaining == 0) {
+            auto & entry = m_entries[open.back().index];
+
+            if (entry.code == 0x00) {
+                entry.size = static_cast<uint32_t> (offset - entry.offset);
+            } else if (offset != entry.offset + entry.size) {
+                std::stringstream ss;
+                ss << "Bad AMQP encoding at offset " << entry.offset
+                   << ": elements don't fill their container";
+                throw std::runtime_error (ss.str());
+            }
+
+            entry.next = static_cast<uint32_t> (m_entries.size());
+            open.pop_back();
+        }
+    } while (!open.empty());
+}
+
+/******************************************************************************/
+
+amqp::internal::scan::Cursor
+amqp::internal::scan::
+Tape::root() const {
+    return Cursor (*this, 0);
+}
+
+/******************************************************************************
+ *
+ * amqp::internal::scan::Cursor
+ *
+ ******************************************************************************/
+
+amqp::internal::scan::
+Cursor::Cursor (const Tape & tape_, size_t index_)
+    : m_tape (&tape_)
+    , m_index (index_)
+{ }
+
+/******************************************************************************/
+
+void
+amqp::internal::scan::
+Cursor::error (const std::string & expected_) const {
+    std::stringstream ss;
+    ss << "Expected " << expected_ << " but found [" << *this << "]";
+    throw std::runtime_error (ss.str());
+}
+
+/******************************************************************************/
+
+/**
+ * Where the data of the value starts, skipping its format code and
+ * for the variable width values the size prefix
+ */
+size_t
+amqp::internal::scan::
+Cursor::body() const {
+    switch (code() >> 4) {
+        case 0xA : return entry().offset + 2;
+        case 0xB : return entry().offset + 5;
+        default  : return entry().offset + 1;
+    }
+}
+
+/******************************************************************************/
+
+std::string_view
+amqp::internal::scan::
+Cursor::raw() const {
+    return std::string_view (m_tape->bytes() + entry().offset, entry().size);
+}
+
+/******************************************************************************/
+
+bool
+amqp::internal::scan::
+Cursor::isList() const {
+    return Scanner::isList (code());
+}
+
+/******************************************************************************/
+
+bool
+amqp::internal::scan::
+Cursor::isMap() const {
+    return Scanner::isMap (code());
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::scan::
+Cursor::described() const {
+    if (!isDescribed()) error ("a described type");
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::scan::
+Cursor::list() const {
+    if (!isList()) error ("a list");
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::scan::
+Cursor::map() const {
+    if (!isMap()) error ("a map");
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::scan::
+Cursor::next() {
+    m_index = entry().next;
+}
+
+/******************************************************************************/
+
+amqp::internal::scan::Cursor
+amqp::internal::scan::
+Cursor::first() const {
+    return Cursor (*m_tape, m_index + 1);
+}
+
+/******************************************************************************/
+
+amqp::internal::scan::Cursor
+amqp::internal::scan::
+Cursor::descriptor() const {
+    described();
+    return first();
+}
+
+/******************************************************************************/
+
+amqp::internal::scan::Cursor
+amqp::internal::scan::
+Cursor::value() const {
+    auto rtn = descriptor();
+    rtn.next();
+    return rtn;
+}
+
+/******************************************************************************/
+
+namespace amqp::internal::scan {
+
+    template<>
+    bool
+    Cursor::get<bool>() const {
+        switch (code()) {
+            case 0x41 : return true;
+            case 0x42 : return false;
+            case 0x56 : return m_tape->bytes()[body()] != 0;
+            default   : error ("a Boolean");
+        }
+    }
+
+    template<>
+    int
+    Cursor::get<int>() const {
+        switch (code()) {
+            case 0x54 : return static_cast<int8_t> (m_tape->bytes()[body()]);
+            case 0x71 : return static_cast<int32_t> (
+                            readBE (m_tape->bytes() + body(), 4));
+            default   : error ("an Int");
+        }
+    }
+
+    template<>
+    long
+    Cursor::get<long>() const {
+        switch (code()) {
+            case 0x55 : return static_cast<int8_t> (m_tape->bytes()[body()]);
+            case 0x81 : return static_cast<int64_t> (
+                            readBE (m_tape->bytes() + body(), 8));
+            default   : error ("a Long");
+        }
+    }
+
+    template<>
+    uint64_t
+    Cursor::get<uint64_t>() const {
+        switch (code()) {
+            case 0x44 : return 0;
+            case 0x53 : return static_cast<uint8_t> (m_tape->bytes()[body()]);
+            case 0x80 : return readBE (m_tape->bytes() + body(), 8);
+            default   : error ("a ULong");
+        }
+    }
+
+    template<>
+    double
+    Cursor::get<double>() const {
+        if (code() != 0x82) error ("a Double");
+
+        static_assert (sizeof (double) == sizeof (uint64_t));
+
+        auto bits = readBE (m_tape->bytes() + body(), 8);
+        double rtn;
+        memcpy (&rtn, &bits, sizeof (rtn));
+
+        return rtn;
+    }
+
+    template<>
+    std::string_view
+    Cursor::get<std::string_view>() const {
+        switch (code()) {
+            case 0xA1 :
+            case 0xA3 :
+            case 0xB1 :
+            case 0xB3 :
+                return std::string_view (
+                    m_tape->bytes() + body(),
+                    entry().offset + entry().size - body());
+            default :
+                error ("a String");
+        }
+    }
+
+}
+
+/******************************************************************************/
+
+namespace amqp::internal::scan {
+
+    std::ostream &
+    operator << (std::ostream & stream_, const Cursor & cursor_) {
+        auto flags = stream_.flags();
+        auto fill = stream_.fill();
+
+        stream_ << "code 0x" << std::hex << std::setw (2) << std::setfill ('0')
+                << int { cursor_.code() } << std::dec
+                << " at offset " << cursor_.entry().offset;
+
+        stream_.flags (flags);
+        stream_.fill (fill);
+
+        return stream_;
+    }
+
+}
+
+/******************************************************************************/
@@ -0,0 +1,169 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <iosfwd>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <string_view>
+
+#include "types.h"
+
+/******************************************************************************/
+
+namespace amqp::internal::scan {
+
+    /**
+     * One node of a [Tape]. Offsets are relative to the start of the
+     * buffer the tape was built over.
+     */
+    struct Entry {
+        uint32_t offset;
+
+        /**
+         * Total number of bytes the value occupies including its
+         * constructor
+         */
+        uint32_t size;
+
+        /**
+         * Number of children. Two for a described type, its descriptor
+         * and its value, the number of elements for a list or map.
+         * Arrays are kept whole and so have none on the tape.
+         */
+        uint32_t count;
+
+        /**
+         * The index of the entry that follows this one once all of its
+         * children have been skipped over, i.e. that of its next sibling
+         */
+        uint32_t next;
+
+        uint8_t  code;
+    };
+
+    class Cursor;
+
+    /**
+     * A structural index of an AMQP encoded buffer, built in a single
+     * pass that only looks at constructors and size prefixes. Every node
+     * becomes an [Entry], laid out depth first so the children of an
+     * entry immediately follow it.
+     *
+     * Where proton decodes everything into a tree of heap allocated
+     * nodes before we can look at any of it, the tape costs a few bytes
+     * per node and values are only decoded when a reader asks for
+     * them through a [Cursor]. Nothing refers back to the tape as it's
+     * walked so it can be read as many times, and by as many consumers,
+     * as needed.
+     *
+     * The buffer must outlive the tape.
+     */
+    class Tape {
+        private :
+            const char * m_bytes;
+
+            sVec<Entry>  m_entries;
+
+        public :
+            /**
+             * Index the single value that starts at the beginning
+             * of [bytes_]
+             */
+            Tape (const char *, size_t);
+
+            const char * bytes() const { return m_bytes; }
+
+            size_t size() const { return m_entries.size(); }
+
+            const Entry & operator [] (size_t i_) const {
+                return m_entries[i_];
+            }
+
+            Cursor root() const;
+    };
+
+}
+
+/******************************************************************************/
+
+namespace amqp::internal::scan {
+
+    /**
+     * A position on a [Tape]. Copying one is free so readers hand them
+     * about by value, moving forward through siblings with [next] and
+     * down into a node with [first].
+     */
+    class Cursor {
+        private :
+            const Tape * m_tape;
+            size_t       m_index;
+
+            size_t body() const;
+
+            [[noreturn]] void error (const std::string &) const;
+
+        public :
+            Cursor (const Tape &, size_t);
+
+            const Entry & entry() const { return (*m_tape)[m_index]; }
+
+            uint8_t code() const { return entry().code; }
+            size_t count() const { return entry().count; }
+
+            bool isDescribed() const { return code() == 0x00; }
+            bool isNull() const { return code() == 0x40; }
+            bool isList() const;
+            bool isMap() const;
+
+            /**
+             * Throw unless positioned on a value of the named kind
+             */
+            void described() const;
+            void list() const;
+            void map() const;
+
+            /**
+             * Move on to the next sibling
+             */
+            void next();
+
+            /**
+             * The first child of the node. Only meaningful when [count]
+             * is non zero.
+             */
+            Cursor first() const;
+
+            /**
+             * The two halves of a described type
+             */
+            Cursor descriptor() const;
+            Cursor value() const;
+
+            /**
+             * The encoding of the value at the cursor, constructor and all
+             */
+            std::string_view raw() const;
+
+            /**
+             * Decode the value at the cursor. Specialised in the CXX file
+             * for bool, int, long, uint64_t, double and, for strings and
+             * symbols, std::string_view which points into the buffer
+             */
+            template<typename T>
+            T get() const;
+
+            friend std::ostream & operator << (std::ostream &, const Cursor &);
+    };
+
+    template<> bool Cursor::get<bool>() const;
+    template<> int Cursor::get<int>() const;
+    template<> long Cursor::get<long>() const;
+    template<> uint64_t Cursor::get<uint64_t>() const;
+    template<> double Cursor::get<double>() const;
+    template<> std::string_view Cursor::get<std::string_view>() const;
+
+}
+
+/******************************************************************************/
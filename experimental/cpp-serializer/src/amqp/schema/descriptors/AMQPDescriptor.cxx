@@ -76,7 +76,7 @@ AMQPDescriptor::read (
                             << pn_data_get_list(data_)
                             << std::endl;
 
-                        AMQPDescriptorRegistory[key]->read (data_, ss_, ai);
+                        descriptorFor (key)->read (data_, ss_, ai);
                         break;
                     }
                     case PN_SYMBOL : {
@@ -12,6 +12,8 @@
 #include "corda-descriptors/RestrictedDescriptor.h"
 
 #include <limits>
+#include <sstream>
+#include <stdexcept>
 #include <climits>
 
 /******************************************************************************/
@@ -98,6 +100,21 @@ namespace amqp::internal {
 
 /******************************************************************************/
 
+const std::shared_ptr<amqp::internal::schema::descriptors::AMQPDescriptor> &
+amqp::internal::descriptorFor (uint64_t id_) {
+    auto it = AMQPDescriptorRegistory.find (id_);
+
+    if (it == AMQPDescriptorRegistory.end()) {
+        std::stringstream ss;
+        ss << "Unknown AMQP descriptor 0x" << std::hex << id_;
+        throw std::runtime_error (ss.str());
+    }
+
+    return it->second;
+}
+
+/******************************************************************************/
+
 uint32_t
 amqp::stripCorda (uint64_t id) {
     return static_cast<uint32_t>(id & (uint64_t)UINT_MAX);
@@ -21,6 +21,15 @@ namespace amqp::internal {
 
     extern std::map<uint64_t, std::shared_ptr<internal::schema::descriptors::AMQPDescriptor>> AMQPDescriptorRegistory;
 
+    /**
+     * The descriptor registered for [id_]. Unlike indexing the registry
+     * this never inserts an empty entry for an id we don't know, which
+     * as well as handing back a null would be a write to a map every
+     * thread reads, but throws.
+     */
+    const std::shared_ptr<internal::schema::descriptors::AMQPDescriptor> &
+    descriptorFor (uint64_t id_);
+
 }
 
 /******************************************************************************
@@ -40,7 +40,7 @@ namespace amqp::internal::schema::descriptors {
 
         return uPtr<T>(
             static_cast<T *>(
-                AMQPDescriptorRegistory[id]->build(data_).release()));
+                descriptorFor (id)->build(data_).release()));
     }
 }
 
@@ -190,7 +190,7 @@ RestrictedDescriptor::read (
 
     ss_ << ai << "5] Descriptor:" << std::endl;
 
-    AMQPDescriptorRegistory[pn_data_type(data_)]->read (
+    descriptorFor (pn_data_type(data_))->read (
             (pn_data_t *)proton::auto_next(data_), ss_, AutoIndent { ai });
 }
 
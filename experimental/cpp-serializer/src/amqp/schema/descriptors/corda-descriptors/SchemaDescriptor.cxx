@@ -85,7 +85,7 @@ SchemaDescriptor::read (
                 ss_ << ai2 << i << ":" << j << "/" << ale2.elements()
                         << "] " << std::endl;
 
-                AMQPDescriptorRegistory[pn_data_type(data_)]->read (
+                descriptorFor (pn_data_type(data_))->read (
                         data_, ss_,
                         AutoIndent { ai2 });
             }
@@ -0,0 +1,405 @@
+#include "SizeVisitor.h"
+
+#include <iomanip>
+#include <ostream>
+#include <algorithm>
+
+#include "amqp/AMQPHeader.h"
+
+#include "scan/Tape.h"
+
+/******************************************************************************/
+
+namespace {
+
+    using Bytes = amqp::internal::sizes::SizeVisitor::Bytes;
+    using Totals = std::unordered_map<std::string, Bytes>;
+
+    /**
+     * Largest first, ties broken by name so the output is stable
+     */
+    sVec<const Totals::value_type *>
+    sorted (const Totals & totals_) {
+        sVec<const Totals::value_type *> rtn;
+        rtn.reserve (totals_.size());
+
+        for (const auto & total : totals_) {
+            rtn.push_back (&total);
+        }
+
+        std::sort (rtn.begin(), rtn.end(), [](auto lhs_, auto rhs_) {
+            return lhs_->second.total != rhs_->second.total
+                ? lhs_->second.total > rhs_->second.total
+                : lhs_->first < rhs_->first;
+        });
+
+        return rtn;
+    }
+
+    void
+    table (
+        std::ostream & out_,
+        const char * title_,
+        const Totals & totals_,
+        uint64_t bytes_
+    ) {
+        out_ << std::setw (12) << "bytes"
+             << std::setw (12) << "self"
+             << std::setw (10) << "count"
+             << std::setw (8) << "%"
+             << "  " << title_ << std::endl;
+
+        for (const auto * total : sorted (totals_)) {
+            out_ << std::setw (12) << total->second.total
+                 << std::setw (12) << total->second.self
+                 << std::setw (10) << total->second.count
+                 << std::setw (8) << std::fixed << std::setprecision (2)
+                 << (bytes_ ? 100.0 * total->second.total / bytes_ : 0.0)
+                 << "  " << total->first << std::endl;
+        }
+    }
+
+}
+
+/******************************************************************************
+ *
+ * amqp::internal::sizes::SizeVisitor
+ *
+ ******************************************************************************/
+
+void
+amqp::internal::sizes::
+SizeVisitor::add (
+    std::unordered_map<std::string, Bytes> & totals_,
+    const std::string & key_,
+    uint64_t total_,
+    uint64_t self_
+) {
+    auto & bytes = totals_[key_];
+
+    bytes.total += total_;
+    bytes.self += self_;
+    ++bytes.count;
+}
+
+/******************************************************************************/
+
+std::string
+amqp::internal::sizes::
+SizeVisitor::stack (const std::string & path_) const {
+    if (path_.empty()) {
+        return m_root;
+    }
+
+    std::string rtn { m_root };
+    rtn += ';';
+    rtn += path_;
+
+    std::replace (rtn.begin() + m_root.size() + 1, rtn.end(), '.', ';');
+
+    return rtn;
+}
+
+/******************************************************************************/
+
+uint64_t
+amqp::internal::sizes::
+SizeVisitor::take() {
+    uint64_t rtn = m_sized ? m_pending : 0;
+
+    m_sized = false;
+    m_pending = 0;
+
+    if (!m_frames.empty()) {
+        m_frames.back().children += rtn;
+    }
+
+    return rtn;
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::sizes::
+SizeVisitor::enter (const std::string & path_) {
+    auto total = take();
+
+    m_frames.push_back ({ stack (path_), total, 0, std::move (m_type) });
+    m_type.clear();
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::sizes::
+SizeVisitor::leave() {
+    auto frame = std::move (m_frames.back());
+    m_frames.pop_back();
+
+    // The elements of an array aren't sized so a frame can't have more
+    // beneath it than it holds, but don't trust that blindly
+    auto self = frame.total - std::min (frame.total, frame.children);
+
+    add (m_stacks, frame.stack, frame.total, self);
+
+    if (!frame.type.empty()) {
+        add (m_types, frame.type, frame.total, self);
+    }
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::sizes::
+SizeVisitor::leaf() {
+    const auto & path = leafPath();
+    auto total = take();
+
+    add (m_stacks, stack (path), total, total);
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::sizes::
+SizeVisitor::section (const std::string & stack_, uint64_t bytes_) {
+    add (m_stacks, stack_, bytes_, bytes_);
+}
+
+/******************************************************************************/
+
+/**
+ * A schema is a described list whose only element is the list of type
+ * notations, each of which is a described list starting with the name
+ * of the type
+ */
+void
+amqp::internal::sizes::
+SizeVisitor::schema (const scan::Cursor & schema_) {
+    uint64_t notations { 0 };
+
+    if (schema_.isDescribed()) {
+        auto list = schema_.value();
+
+        if (list.isList() && list.count()) {
+            auto types = list.first();
+
+            if (types.isList() && types.count()) {
+                auto type = types.first();
+
+                for (size_t i { 0 } ; i < types.count() ; ++i, type.next()) {
+                    std::string name { "?" };
+
+                    if (type.isDescribed()) {
+                        auto fields = type.value();
+
+                        if (fields.isList() && fields.count()) {
+                            name = fields.first().get<std::string_view>();
+                        }
+                    }
+
+                    section ("schema;" + name, type.entry().size);
+                    notations += type.entry().size;
+                }
+            }
+        }
+    }
+
+    section ("schema", schema_.entry().size - notations);
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::sizes::
+SizeVisitor::envelope (const char * bytes_, size_t size_) {
+    const uint64_t header = amqp::AMQP_HEADER.size() + 1;
+
+    ++m_blobs;
+    m_bytes += header + size_;
+
+    section ("header", header);
+
+    scan::Tape tape (bytes_, size_);
+    auto root = tape.root();
+
+    root.described();
+
+    auto list = root.value();
+    list.list();
+
+    uint64_t sections { 0 };
+
+    if (list.count()) {
+        auto element = list.first();
+
+        for (size_t i { 0 } ; i < list.count() ; ++i, element.next()) {
+            auto size = element.entry().size;
+            sections += size;
+
+            switch (i) {
+                // The object, attributed as the readers walk it
+                case 0 : break;
+                case 1 : schema (element); break;
+                case 2 : section ("transforms", size); break;
+                default : section ("envelope", size); break;
+            }
+        }
+    }
+
+    // the envelope's descriptor and list header, and anything trailing it
+    section ("envelope", size_ - sections);
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::sizes::
+SizeVisitor::encoded (size_t bytes_) {
+    m_pending = bytes_;
+    m_sized = true;
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::sizes::
+SizeVisitor::beginComposite (const std::string & type_) {
+    if (root()) {
+        m_root = "data;" + type_;
+    }
+
+    m_type = type_;
+
+    PathVisitor::beginComposite (type_);
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::sizes::
+SizeVisitor::enterComposite (const std::string & path_) {
+    enter (path_);
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::sizes::
+SizeVisitor::endComposite() {
+    leave();
+    PathVisitor::endComposite();
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::sizes::
+SizeVisitor::enterList (const std::string & path_, size_t) {
+    enter (path_);
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::sizes::
+SizeVisitor::endList() {
+    leave();
+    PathVisitor::endList();
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::sizes::
+SizeVisitor::enterMap (const std::string & path_, size_t) {
+    enter (path_);
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::sizes::
+SizeVisitor::endMap() {
+    leave();
+    PathVisitor::endMap();
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::sizes::
+SizeVisitor::value (bool) {
+    leaf();
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::sizes::
+SizeVisitor::value (int32_t) {
+    leaf();
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::sizes::
+SizeVisitor::value (int64_t) {
+    leaf();
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::sizes::
+SizeVisitor::value (double) {
+    leaf();
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::sizes::
+SizeVisitor::value (const std::string &) {
+    leaf();
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::sizes::
+SizeVisitor::table (std::ostream & out_) const {
+    out_ << m_blobs << " blobs, " << m_bytes << " bytes" << std::endl
+         << std::endl;
+
+    ::table (out_, "stack", m_stacks, m_bytes);
+
+    out_ << std::endl;
+
+    ::table (out_, "type", m_types, m_bytes);
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::sizes::
+SizeVisitor::folded (std::ostream & out_) const {
+    sVec<const std::pair<const std::string, Bytes> *> stacks;
+
+    for (const auto & stack : m_stacks) {
+        if (stack.second.self) {
+            stacks.push_back (&stack);
+        }
+    }
+
+    std::sort (stacks.begin(), stacks.end(), [](auto lhs_, auto rhs_) {
+        return lhs_->first < rhs_->first;
+    });
+
+    for (const auto * stack : stacks) {
+        out_ << stack->first << " " << stack->second.self << std::endl;
+    }
+}
+
+/******************************************************************************/
@@ -0,0 +1,167 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <iosfwd>
+#include <string>
+#include <cstdint>
+#include <unordered_map>
+
+#include "types.h"
+
+#include "reader/PathVisitor.h"
+
+/******************************************************************************/
+
+namespace amqp::internal::scan {
+    class Cursor;
+}
+
+/******************************************************************************/
+
+namespace amqp::internal::sizes {
+
+    /**
+     * Works out where the bytes of a corpus of blobs go, attributing
+     * each one to the part of the blob that encoded it.
+     *
+     * The object is attributed by following the readers as they walk
+     * it, using the sizes they announce through [encoded], so it must
+     * be read from a tape. Everything is keyed on a stack of frames
+     * separated by ';', the data starting with the type of the blob
+     * and then the path to the value with '.' swapped for ';', e.g.
+     *
+     *      data;net.corda.Foo
+     *      data;net.corda.Foo;listy[]
+     *      data;net.corda.Foo;m{};key
+     *
+     * The rest of the blob is attributed by [envelope], the schema
+     * broken down by the type each notation describes, e.g.
+     *
+     *      header
+     *      envelope
+     *      schema
+     *      schema;net.corda.Foo
+     *      transforms
+     *
+     * The bytes of a stack include those of everything beneath it, its
+     * self bytes are only those not accounted for by anything beneath,
+     * the descriptor and list header of a composite for instance. Self
+     * bytes are what a flame graph wants, see [folded].
+     *
+     * Visit any number of blobs and the totals accumulate.
+     */
+    class SizeVisitor : public reader::PathVisitor {
+        public :
+            struct Bytes {
+                uint64_t total { 0 };
+                uint64_t self { 0 };
+                uint64_t count { 0 };
+            };
+
+        private :
+            struct Frame {
+                std::string stack;
+                uint64_t    total;
+                uint64_t    children;
+
+                // set for composites, empty for lists and maps
+                std::string type;
+            };
+
+            uint64_t m_blobs { 0 };
+            uint64_t m_bytes { 0 };
+
+            // what the readers said the next value will take up
+            size_t m_pending { 0 };
+            bool   m_sized { false };
+
+            // the data frame and type of the blob being visited
+            std::string m_root;
+
+            // the type of the composite about to be entered
+            std::string m_type;
+
+            sVec<Frame> m_frames;
+
+            std::unordered_map<std::string, Bytes> m_stacks;
+            std::unordered_map<std::string, Bytes> m_types;
+
+            static void add (
+                std::unordered_map<std::string, Bytes> &,
+                const std::string &,
+                uint64_t total_,
+                uint64_t self_);
+
+            std::string stack (const std::string &) const;
+
+            /**
+             * The size of the value starting now, charged to whatever
+             * encloses it
+             */
+            uint64_t take();
+
+            void enter (const std::string &);
+            void leave();
+            void leaf();
+
+            void section (const std::string &, uint64_t);
+            void schema (const scan::Cursor &);
+
+        protected :
+            void enterComposite (const std::string &) override;
+            void enterList (const std::string &, size_t) override;
+            void enterMap (const std::string &, size_t) override;
+
+        public :
+            /**
+             * Attribute everything in a blob other than the object
+             * itself, and count the blob. [bytes_] is the envelope as
+             * it follows the Corda header.
+             */
+            void envelope (const char * bytes_, size_t);
+
+            void encoded (size_t) override;
+
+            void beginComposite (const std::string &) override;
+            void endComposite() override;
+
+            void endList() override;
+            void endMap() override;
+
+            void value (bool) override;
+            void value (int32_t) override;
+            void value (int64_t) override;
+            void value (double) override;
+            void value (const std::string &) override;
+
+            uint64_t blobs() const { return m_blobs; }
+            uint64_t bytes() const { return m_bytes; }
+
+            const std::unordered_map<std::string, Bytes> & stacks() const {
+                return m_stacks;
+            }
+
+            /**
+             * The bytes of every instance of each composite type
+             * wherever in a blob it appears
+             */
+            const std::unordered_map<std::string, Bytes> & types() const {
+                return m_types;
+            }
+
+            /**
+             * Tables of the stacks and then the types, largest first
+             */
+            void table (std::ostream &) const;
+
+            /**
+             * The self bytes of each stack in the folded format taken
+             * by flamegraph.pl and most other flame graph tools
+             */
+            void folded (std::ostream &) const;
+    };
+
+}
+
+/******************************************************************************/
@@ -0,0 +1,530 @@
+#include "SqliteVisitor.h"
+
+#include <sstream>
+#include <exception>
+#include <stdexcept>
+
+#include <sqlite3.h>
+
+/******************************************************************************/
+
+namespace {
+
+    std::string
+    quoted (const std::string & name_) {
+        std::string rtn { "\"" };
+
+        for (auto c : name_) {
+            if (c == '"') rtn += '"';
+            rtn += c;
+        }
+
+        return rtn + "\"";
+    }
+
+}
+
+/******************************************************************************
+ *
+ * amqp::internal::sqlite::SqliteVisitor
+ *
+ ******************************************************************************/
+
+amqp::internal::sqlite::
+SqliteVisitor::SqliteVisitor (const std::string & path_, size_t batch_)
+    : m_db (nullptr)
+    , m_batch (batch_)
+    , m_pending (0)
+    , m_uncaught (std::uncaught_exceptions())
+{
+    if (sqlite3_open (path_.c_str(), &m_db) != SQLITE_OK) {
+        std::string msg = m_db ? sqlite3_errmsg (m_db) : "out of memory";
+        sqlite3_close (m_db);
+        throw std::runtime_error ("Can't open " + path_ + ": " + msg);
+    }
+
+    try {
+        // a second load would append to, and duplicate rows in, the
+        // tables of the first
+        sqlite3_stmt * stmt;
+
+        if (sqlite3_prepare_v2 (m_db,
+                "SELECT COUNT (*) FROM sqlite_master", -1, &stmt, nullptr) != SQLITE_OK)
+        {
+            error ("Can't read " + path_);
+        }
+
+        bool empty = sqlite3_step (stmt) == SQLITE_ROW
+            && sqlite3_column_int64 (stmt, 0) == 0;
+
+        sqlite3_finalize (stmt);
+
+        if (!empty) {
+            throw std::runtime_error (
+                path_ + " already holds a database, load into a new one");
+        }
+
+        // the journal's kept so a batch can be rolled back, syncing
+        // isn't as the file's no use after a crash anyway
+        exec ("PRAGMA synchronous = OFF");
+        exec ("BEGIN");
+    } catch (...) {
+        sqlite3_close (m_db);
+        throw;
+    }
+}
+
+/******************************************************************************/
+
+amqp::internal::sqlite::
+SqliteVisitor::~SqliteVisitor() {
+    try {
+        // being unwound past means the load failed part way through the
+        // current batch, which we don't want to keep
+        exec (std::uncaught_exceptions() > m_uncaught ? "ROLLBACK" : "COMMIT");
+    } catch (...) {
+        // nothing to be done about it now
+    }
+
+    for (auto & table : m_tables) {
+        sqlite3_finalize (table.second->insert);
+    }
+
+    sqlite3_close (m_db);
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::sqlite::
+SqliteVisitor::error (const std::string & what_) const {
+    std::stringstream ss;
+    ss << what_ << ": " << sqlite3_errmsg (m_db);
+    throw std::runtime_error (ss.str());
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::sqlite::
+SqliteVisitor::exec (const std::string & sql_) {
+    if (sqlite3_exec (m_db, sql_.c_str(), nullptr, nullptr, nullptr) != SQLITE_OK) {
+        error (sql_);
+    }
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::sqlite::
+SqliteVisitor::commit() {
+    exec ("COMMIT");
+    exec ("BEGIN");
+
+    m_pending = 0;
+}
+
+/******************************************************************************/
+
+/**
+ * Find or create a table
+ */
+amqp::internal::sqlite::SqliteVisitor::Table &
+amqp::internal::sqlite::
+SqliteVisitor::table (const std::string & name_, bool collection_) {
+    auto it = m_tables.find (name_);
+
+    if (it != m_tables.end()) {
+        return *it->second;
+    }
+
+    auto table = std::make_unique<Table>();
+    table->name = name_;
+    table->fixed = collection_ ? 3 : 1;
+
+    std::string sql { "CREATE TABLE " + quoted (name_) + " (_id INTEGER PRIMARY KEY" };
+
+    if (collection_) {
+        sql += ", _parent INTEGER, _index INTEGER";
+    }
+
+    exec (sql + ")");
+
+    return *m_tables.emplace (name_, std::move (table)).first->second;
+}
+
+/******************************************************************************/
+
+/**
+ * The index of the named column, adding it, typed by the first value
+ * we've seen for it, if the table doesn't have it yet
+ */
+size_t
+amqp::internal::sqlite::
+SqliteVisitor::column (Table & table_, const std::string & name_, const Value & value_) {
+    auto it = table_.byName.find (name_);
+
+    if (it != table_.byName.end()) {
+        return it->second;
+    }
+
+    static const char * types[] { "", " INTEGER", " REAL", " TEXT" };
+
+    exec ("ALTER TABLE " + quoted (table_.name) + " ADD COLUMN "
+        + quoted (name_) + types[value_.kind]);
+
+    // the insert no longer covers every column
+    sqlite3_finalize (table_.insert);
+    table_.insert = nullptr;
+
+    table_.byName.emplace (name_, table_.columns.size());
+    table_.columns.push_back (name_);
+
+    return table_.columns.size() - 1;
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::sqlite::
+SqliteVisitor::prepare (Table & table_) {
+    std::string sql { "INSERT INTO " + quoted (table_.name) + " (_id" };
+    std::string params { "?" };
+
+    if (table_.fixed == 3) {
+        sql += ", _parent, _index";
+        params += ", ?, ?";
+    }
+
+    for (const auto & column : table_.columns) {
+        sql += ", " + quoted (column);
+        params += ", ?";
+    }
+
+    sql += ") VALUES (" + params + ")";
+
+    if (sqlite3_prepare_v2 (m_db, sql.c_str(), -1, &table_.insert, nullptr) != SQLITE_OK) {
+        error (sql);
+    }
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::sqlite::
+SqliteVisitor::insert (
+    Table & table_,
+    int64_t id_,
+    int64_t parent_,
+    size_t index_,
+    const sVec<Value> & values_
+) {
+    if (!table_.insert) {
+        prepare (table_);
+    }
+
+    auto * stmt = table_.insert;
+
+    int param { 1 };
+
+    sqlite3_bind_int64 (stmt, param++, id_);
+
+    if (table_.fixed == 3) {
+        if (parent_) {
+            sqlite3_bind_int64 (stmt, param++, parent_);
+        } else {
+            sqlite3_bind_null (stmt, param++);
+        }
+
+        sqlite3_bind_int64 (stmt, param++, static_cast<int64_t> (index_));
+    }
+
+    for (size_t i { 0 } ; i < table_.columns.size() ; ++i, ++param) {
+        if (i >= values_.size()) {
+            sqlite3_bind_null (stmt, param);
+            continue;
+        }
+
+        const auto & value = values_[i];
+
+        switch (value.kind) {
+            case Value::null_k :
+                sqlite3_bind_null (stmt, param);
+                break;
+            case Value::integer_k :
+                sqlite3_bind_int64 (stmt, param, value.integer);
+                break;
+            case Value::real_k :
+                sqlite3_bind_double (stmt, param, value.real);
+                break;
+            case Value::text_k :
+                sqlite3_bind_text (stmt, param, value.text.data(),
+                    static_cast<int> (value.text.size()), SQLITE_STATIC);
+                break;
+        }
+    }
+
+    if (sqlite3_step (stmt) != SQLITE_DONE) {
+        error ("insert into " + table_.name);
+    }
+
+    sqlite3_reset (stmt);
+
+    if (++m_pending >= m_batch) {
+        commit();
+    }
+}
+
+/******************************************************************************/
+
+/**
+ * Where a value ends up depends on what it's within. A composite keeps
+ * it until the composite's row is written, a list writes a row for it
+ * straight away and a map once it has both the key and the value.
+ */
+void
+amqp::internal::sqlite::
+SqliteVisitor::deliver (Value value_) {
+    if (m_frames.empty()) {
+        return;
+    }
+
+    auto & frame = m_frames.back();
+
+    switch (frame.kind) {
+        case Frame::composite_k : {
+            auto i = column (*frame.table, frame.property, value_);
+
+            if (frame.values.size() <= i) {
+                frame.values.resize (i + 1);
+            }
+
+            frame.values[i] = std::move (value_);
+            break;
+        }
+        case Frame::list_k :
+            frame.values[0] = std::move (value_);
+            element();
+            break;
+        case Frame::map_k :
+            frame.values[frame.key ? 0 : 1] = std::move (value_);
+
+            frame.key = !frame.key;
+
+            // back to expecting a key so we have both halves of the entry
+            if (frame.key) {
+                element();
+            }
+            break;
+    }
+}
+
+/******************************************************************************/
+
+/**
+ * Write the row for the current element of the list or map on top of
+ * the stack
+ */
+void
+amqp::internal::sqlite::
+SqliteVisitor::element() {
+    auto & frame = m_frames.back();
+
+    auto id = frame.element ? frame.element : frame.table->next++;
+    frame.element = 0;
+
+    insert (*frame.table, id, frame.id, frame.index++, frame.values);
+}
+
+/******************************************************************************/
+
+std::pair<amqp::internal::sqlite::SqliteVisitor::Table *, int64_t>
+amqp::internal::sqlite::
+SqliteVisitor::owner() {
+    if (m_frames.empty()) {
+        return { &table ("[]", true), 0 };
+    }
+
+    auto & frame = m_frames.back();
+
+    if (frame.kind == Frame::composite_k) {
+        return {
+            &table (frame.table->name + "." + frame.property, true),
+            frame.id
+        };
+    }
+
+    // the list or map is itself an element, so its elements belong to
+    // that element's row, written once the list or map is done
+    if (!frame.element) {
+        frame.element = frame.table->next++;
+    }
+
+    const char * suffix = (frame.kind == Frame::list_k)
+        ? "[]"
+        : (frame.key ? "{}.key" : "{}.value");
+
+    return { &table (frame.table->name + suffix, true), frame.element };
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::sqlite::
+SqliteVisitor::push (Frame::Kind kind_) {
+    auto [table, parent] = owner();
+
+    Frame frame { kind_, table, parent };
+
+    // the fixed value columns of a list or map
+    if (kind_ == Frame::list_k) {
+        column (*table, "value", Value { });
+        frame.values.resize (1);
+    } else {
+        column (*table, "key", Value { });
+        column (*table, "value", Value { });
+        frame.values.resize (2);
+    }
+
+    m_frames.push_back (std::move (frame));
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::sqlite::
+SqliteVisitor::property (const std::string & name_) {
+    m_frames.back().property = name_;
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::sqlite::
+SqliteVisitor::beginComposite (const std::string & type_) {
+    auto & table = this->table (type_, false);
+
+    Frame frame { Frame::composite_k, &table, table.next++ };
+    frame.values.resize (table.columns.size());
+
+    m_frames.push_back (std::move (frame));
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::sqlite::
+SqliteVisitor::endComposite() {
+    auto & frame = m_frames.back();
+    auto id = frame.id;
+
+    insert (*frame.table, id, 0, 0, frame.values);
+
+    m_frames.pop_back();
+
+    // whatever holds us refers to our row
+    Value value;
+    value.kind = Value::integer_k;
+    value.integer = id;
+
+    deliver (std::move (value));
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::sqlite::
+SqliteVisitor::beginList (size_t) {
+    push (Frame::list_k);
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::sqlite::
+SqliteVisitor::endList() {
+    m_frames.pop_back();
+
+    // a composite has no column for a list, its elements refer to it
+    if (!m_frames.empty() && m_frames.back().kind != Frame::composite_k) {
+        deliver (Value { });
+    }
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::sqlite::
+SqliteVisitor::beginMap (size_t) {
+    push (Frame::map_k);
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::sqlite::
+SqliteVisitor::endMap() {
+    endList();
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::sqlite::
+SqliteVisitor::value (bool value_) {
+    value (static_cast<int64_t> (value_));
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::sqlite::
+SqliteVisitor::value (int32_t value_) {
+    value (static_cast<int64_t> (value_));
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::sqlite::
+SqliteVisitor::value (int64_t value_) {
+    Value value;
+    value.kind = Value::integer_k;
+    value.integer = value_;
+
+    deliver (std::move (value));
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::sqlite::
+SqliteVisitor::value (double value_) {
+    Value value;
+    value.kind = Value::real_k;
+    value.real = value_;
+
+    deliver (std::move (value));
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::sqlite::
+SqliteVisitor::value (const std::string & value_) {
+    Value value;
+    value.kind = Value::text_k;
+    value.text = value_;
+
+    deliver (std::move (value));
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::sqlite::
+SqliteVisitor::null() {
+    deliver (Value { });
+}
+
+/******************************************************************************/
@@ -0,0 +1,189 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <string>
+#include <cstdint>
+#include <utility>
+#include <unordered_map>
+
+#include "types.h"
+
+#include "amqp/reader/IVisitor.h"
+
+/******************************************************************************/
+
+struct sqlite3;
+struct sqlite3_stmt;
+
+/******************************************************************************/
+
+namespace amqp::internal::sqlite {
+
+    /**
+     * Load blobs into a SQLite database as they're read, one table per
+     * composite type and one per list or map property.
+     *
+     * A composite's table is named for its type and has an _id column and
+     * a column per property holding a primitive, or for a property holding
+     * another composite the _id of that composite's row in its own table.
+     * A list or map property gets a child table named for the property's
+     * owner and the property, and a list or map nested within that one
+     * named for its parent with [] or {}.key / {}.value appended, e.g.
+     *
+     *      "net.corda.Foo"             _id, a, b, c
+     *      "net.corda.Foo.listy"       _id, _parent, _index, value
+     *      "net.corda.Foo.m"           _id, _parent, _index, key, value
+     *      "net.corda.Foo.listy[]"     _id, _parent, _index, value
+     *
+     * _parent references the _id of the owning row and _index is the
+     * position within the list or map. A value that's a composite holds
+     * that composite's _id, one that's itself a list or map is null, its
+     * elements referencing the element's _id.
+     *
+     * Tables, and their columns, are created as they're first seen, so as
+     * the readers announce every property of a composite its table has a
+     * column for each field in the schema. Rows are inserted through
+     * prepared statements in transactions of [batch] rows.
+     *
+     * A load is always into a new database, one already holding tables
+     * being refused rather than having the same rows added again. A load
+     * that throws part way through rolls back the batch it was in, those
+     * before it having been committed. Syncing is off, so a database left
+     * by a crash, of the process or the machine, should be thrown away and
+     * the load run again.
+     */
+    class SqliteVisitor : public amqp::reader::IVisitor {
+        private :
+            struct Value {
+                enum Kind : uint8_t { null_k, integer_k, real_k, text_k };
+
+                Kind        kind { null_k };
+                int64_t     integer { 0 };
+                double      real { 0 };
+                std::string text;
+            };
+
+            struct Table {
+                std::string name;
+
+                // the columns after the fixed ones, in the order created
+                sVec<std::string> columns;
+                std::unordered_map<std::string, size_t> byName;
+
+                // _id, and for lists and maps _parent and _index
+                size_t fixed;
+
+                sqlite3_stmt * insert { nullptr };
+
+                int64_t next { 1 };
+            };
+
+            struct Frame {
+                enum Kind { composite_k, list_k, map_k };
+
+                Kind    kind;
+                Table * table;
+
+                // the row's _id for a composite, the _parent of every
+                // element for a list or map
+                int64_t id;
+
+                // a composite's values by column, the current element of
+                // a list or key and value of a map
+                sVec<Value> values;
+
+                std::string property;
+
+                size_t  index { 0 };
+                bool    key { true };
+
+                // the _id of the element a nested list or map belongs to
+                int64_t element { 0 };
+            };
+
+            sqlite3 * m_db;
+
+            size_t m_batch;
+            size_t m_pending;
+
+            // those in flight when we were made, so the destructor can
+            // tell it's being unwound past
+            int m_uncaught;
+
+            std::unordered_map<std::string, uPtr<Table>> m_tables;
+
+            sVec<Frame> m_frames;
+
+            void exec (const std::string &);
+            [[noreturn]] void error (const std::string &) const;
+
+            Table & table (const std::string &, bool collection_);
+            size_t column (Table &, const std::string &, const Value &);
+            void prepare (Table &);
+
+            void insert (
+                Table &,
+                int64_t id_,
+                int64_t parent_,
+                size_t index_,
+                const sVec<Value> &);
+
+            /**
+             * Hand a finished value to whatever encloses it
+             */
+            void deliver (Value);
+
+            void element();
+
+            /**
+             * The table and _parent of a list or map about to start
+             */
+            std::pair<Table *, int64_t> owner();
+
+            void push (Frame::Kind);
+
+        public :
+            static constexpr size_t defaultBatch = 100000;
+
+            /**
+             * Load into a new database at [path_], throwing if there's
+             * one there already
+             */
+            explicit SqliteVisitor (const std::string & path_, size_t batch_ = defaultBatch);
+            SqliteVisitor (const SqliteVisitor &) = delete;
+
+            /**
+             * Commits whatever is outstanding, unless an exception is
+             * unwinding past us in which case it's rolled back
+             */
+            ~SqliteVisitor() override;
+
+            /**
+             * Commit what's been loaded so far
+             */
+            void commit();
+
+            void property (const std::string &) override;
+
+            void beginComposite (const std::string &) override;
+            void endComposite() override;
+
+            void beginList (size_t) override;
+            void endList() override;
+
+            void beginMap (size_t) override;
+            void endMap() override;
+
+            void value (bool) override;
+            void value (int32_t) override;
+            void value (int64_t) override;
+            void value (double) override;
+            void value (const std::string &) override;
+
+            void null() override;
+    };
+
+}
+
+/******************************************************************************/
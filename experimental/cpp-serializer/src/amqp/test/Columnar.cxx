@@ -0,0 +1,220 @@
+#include <gtest/gtest.h>
+
+#include <iomanip>
+#include <sstream>
+
+#include "columnar/ColumnarVisitor.h"
+
+/******************************************************************************/
+
+using namespace amqp::internal::columnar;
+
+/******************************************************************************/
+
+namespace {
+
+    /**
+     * Equivalent of visiting a composite { a : int, b : [ { c : string } ] }
+     */
+    void
+    row (ColumnarVisitor & visitor_, int a_, const sVec<std::string> & cs_) {
+        visitor_.beginComposite ("outer");
+        visitor_.property ("a");
+        visitor_.value (a_);
+        visitor_.property ("b");
+        visitor_.beginList (cs_.size());
+        for (const auto & c : cs_) {
+            visitor_.beginComposite ("inner");
+            visitor_.property ("c");
+            visitor_.value (c);
+            visitor_.endComposite();
+        }
+        visitor_.endList();
+        visitor_.endComposite();
+    }
+
+}
+
+/******************************************************************************/
+
+TEST (Columnar, paths) { // NOLINT
+    ColumnarVisitor visitor;
+
+    row (visitor, 1, { "one", "two" });
+    row (visitor, 2, { });
+    row (visitor, 3, { "three" });
+
+    ASSERT_EQ (3, visitor.rows());
+    ASSERT_EQ (3, visitor.columns().size());
+
+    EXPECT_EQ ("a", visitor.columns()[0]->path());
+    EXPECT_EQ (Column::integer_t, visitor.columns()[0]->type());
+    EXPECT_EQ (3, visitor.columns()[0]->size());
+
+    EXPECT_EQ ("b", visitor.columns()[1]->path());
+    EXPECT_EQ (Column::offsets_t, visitor.columns()[1]->type());
+
+    auto & offsets = dynamic_cast<OffsetColumn &> (*visitor.columns()[1]);
+    EXPECT_EQ ((sVec<uint64_t> { 0, 2, 2, 3 }), offsets.offsets());
+
+    EXPECT_EQ ("b[].c", visitor.columns()[2]->path());
+    EXPECT_EQ (Column::string_t, visitor.columns()[2]->type());
+    EXPECT_EQ (3, visitor.columns()[2]->size());
+}
+
+/******************************************************************************/
+
+TEST (Columnar, map) { // NOLINT
+    ColumnarVisitor visitor;
+
+    visitor.beginComposite ("outer");
+    visitor.property ("m");
+    visitor.beginMap (2);
+    visitor.value (1);
+    visitor.value (std::string ("one"));
+    visitor.value (2);
+    visitor.value (std::string ("two"));
+    visitor.endMap();
+    visitor.endComposite();
+
+    ASSERT_EQ (3, visitor.columns().size());
+    EXPECT_EQ ("m{}.key", visitor.columns()[1]->path());
+    EXPECT_EQ (2, visitor.columns()[1]->size());
+    EXPECT_EQ ("m{}.value", visitor.columns()[2]->path());
+    EXPECT_EQ (2, visitor.columns()[2]->size());
+}
+
+/******************************************************************************/
+
+TEST (Columnar, csv) { // NOLINT
+    ColumnarVisitor visitor;
+
+    row (visitor, 1, { "one", "two" });
+    row (visitor, 2, { });
+
+    std::stringstream ss;
+    visitor.csv (ss);
+
+    EXPECT_EQ ("a,b\n1,2\n2,0\n", ss.str());
+}
+
+/******************************************************************************/
+
+TEST (Columnar, csvShort) { // NOLINT
+    ColumnarVisitor visitor;
+
+    row (visitor, 1, { });
+
+    // b not visited at all leaves nothing in its column for this row
+    visitor.beginComposite ("outer");
+    visitor.property ("a");
+    visitor.value (2);
+    visitor.endComposite();
+
+    std::stringstream ss;
+    EXPECT_THROW (visitor.csv (ss), std::runtime_error);
+    EXPECT_THROW (visitor.write (ss), std::runtime_error);
+}
+
+/******************************************************************************/
+
+TEST (Columnar, csvNull) { // NOLINT
+    ColumnarVisitor visitor;
+
+    row (visitor, 1, { "one" });
+
+    visitor.beginComposite ("outer");
+    visitor.property ("a");
+    visitor.value (2);
+    visitor.property ("b");
+    visitor.null();
+    visitor.endComposite();
+
+    std::stringstream ss;
+    visitor.csv (ss);
+
+    EXPECT_EQ ("a,b\n1,1\n2,\n", ss.str());
+}
+
+/******************************************************************************/
+
+/**
+ * A null composite accounts for the columns beneath it, including those
+ * we've not seen a value for yet
+ */
+TEST (Columnar, nullComposite) { // NOLINT
+    ColumnarVisitor visitor;
+
+    auto outer = [&](bool null_, int c_) {
+        visitor.beginComposite ("outer");
+        visitor.property ("b");
+        if (null_) {
+            visitor.null();
+        } else {
+            visitor.beginComposite ("inner");
+            visitor.property ("c");
+            visitor.value (c_);
+            visitor.endComposite();
+        }
+        visitor.endComposite();
+    };
+
+    outer (true, 0);
+    outer (false, 1);
+    outer (true, 0);
+    outer (false, 2);
+
+    ASSERT_EQ (1, visitor.columns().size());
+
+    const auto & c = *visitor.columns()[0];
+    EXPECT_EQ ("b.c", c.path());
+    ASSERT_EQ (4, c.size());
+    EXPECT_EQ (2, c.nulls());
+    EXPECT_FALSE (c.valid (0));
+    EXPECT_TRUE (c.valid (1));
+    EXPECT_FALSE (c.valid (2));
+    EXPECT_TRUE (c.valid (3));
+
+    std::stringstream ss;
+    visitor.write (ss);
+
+    // count, nulls, the validity bitmap and then the payload
+    const auto bytes = ss.str();
+    const auto column = bytes.substr (bytes.size() - (8 + 8 + 1 + 4 * 8));
+    EXPECT_EQ (4, column[0]);
+    EXPECT_EQ (2, column[8]);
+    EXPECT_EQ (0x0A, column[16]);
+}
+
+/******************************************************************************/
+
+TEST (Columnar, csvReal) { // NOLINT
+    ColumnarVisitor visitor;
+
+    visitor.beginComposite ("outer");
+    visitor.property ("a");
+    visitor.value (0.1);
+    visitor.endComposite();
+
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision (2);
+    visitor.csv (ss);
+    ss << 0.5;
+
+    EXPECT_EQ ("a\n0.10000000000000001\n0.50", ss.str());
+}
+
+/******************************************************************************/
+
+TEST (Columnar, mismatch) { // NOLINT
+    ColumnarVisitor visitor;
+
+    row (visitor, 1, { });
+
+    visitor.beginComposite ("outer");
+    visitor.property ("a");
+
+    EXPECT_THROW (visitor.value (std::string ("a")), std::runtime_error);
+}
+
+/******************************************************************************/
@@ -0,0 +1,270 @@
+#include <gtest/gtest.h>
+
+#include "TestUtils.h"
+
+#include "amqp/ReaderCache.h"
+#include "amqp/CompositeFactory.h"
+#include "amqp/reader/PropertyReader.h"
+#include "amqp/schema/described-types/Descriptor.h"
+#include "amqp/schema/described-types/Schema.h"
+#include "restricted-types/Map.h"
+#include "restricted-types/List.h"
+
+/******************************************************************************/
+
+using namespace amqp::internal;
+
+/******************************************************************************/
+
+namespace {
+
+    uPtr<schema::List>
+    list (const std::string & of_, const std::string & descriptor_) {
+        return std::make_unique<schema::List> (
+            std::make_unique<schema::Descriptor> (descriptor_),
+            "java.util.List<" + of_ + ">",
+            "label",
+            sVec<std::string> { },
+            "list");
+    }
+
+    uPtr<schema::Schema>
+    schemaOf (sVec<uPtr<schema::AMQPTypeNotation>> types_) {
+        schema::OrderedTypeNotations<schema::AMQPTypeNotation> types;
+
+        for (auto & type : types_) {
+            types.insert (std::move (type));
+        }
+
+        return std::make_unique<schema::Schema> (std::move (types));
+    }
+
+}
+
+/******************************************************************************/
+
+TEST (CompositeFactory, reachable) { // NOLINT
+    auto list = test::list ("string");
+    auto map = test::map ("int", list->name());
+    auto unused = test::list ("long");
+
+    auto listName = list->name();
+    auto mapName = map->name();
+    auto mapDescriptor = map->descriptor();
+    auto unusedName = unused->name();
+    auto unusedDescriptor = unused->descriptor();
+
+    schema::OrderedTypeNotations<schema::AMQPTypeNotation> types;
+    types.insert (std::move (list));
+    types.insert (std::move (map));
+    types.insert (std::move (unused));
+
+    schema::Schema schema (std::move (types));
+
+    CompositeFactory cf;
+    cf.process (schema, mapDescriptor);
+
+    EXPECT_NE (nullptr, cf.byType (mapName));
+    EXPECT_NE (nullptr, cf.byDescriptor (mapDescriptor));
+    EXPECT_NE (nullptr, cf.byType (listName));
+    EXPECT_EQ (nullptr, cf.byType (unusedName));
+    EXPECT_EQ (nullptr, cf.byDescriptor (unusedDescriptor));
+
+    CompositeFactory all;
+    all.process (schema);
+
+    EXPECT_NE (nullptr, all.byType (unusedName));
+
+    CompositeFactory bad;
+    EXPECT_THROW (bad.process (schema, "net.corda:missing"), std::runtime_error); // NOLINT
+}
+
+/******************************************************************************/
+
+TEST (CompositeFactory, parallel) { // NOLINT
+    const sVec<std::string> primitives {
+        "int", "long", "double", "string" };
+
+    schema::OrderedTypeNotations<schema::AMQPTypeNotation> types;
+    sVec<std::string> names;
+
+    auto add = [&types, &names](auto type_) {
+        names.push_back (type_->name());
+        types.insert (std::move (type_));
+    };
+
+    // Three levels, each with plenty of types that don't depend on
+    // one another and all depending on something in the level before
+    for (const auto & k : primitives) {
+        add (test::list (k));
+
+        for (const auto & v : primitives) {
+            add (test::map (k, v));
+
+            auto map = test::map (k, "java.util.List<" + v + ">");
+            add (test::list (map->name()));
+            add (std::move (map));
+        }
+    }
+
+    schema::Schema schema (std::move (types));
+
+    CompositeFactory cf (8);
+    cf.process (schema);
+
+    for (const auto & name : names) {
+        EXPECT_NE (nullptr, cf.byType (name)) << name;
+    }
+}
+
+/******************************************************************************/
+
+TEST (CompositeFactory, shared) { // NOLINT
+    sVec<uPtr<schema::AMQPTypeNotation>> first;
+    first.emplace_back (list ("string", "net.corda:strings"));
+    first.emplace_back (list ("java.util.List<string>", "net.corda:nested"));
+    first.emplace_back (list ("long", "net.corda:longs"));
+
+    sVec<uPtr<schema::AMQPTypeNotation>> second;
+    second.emplace_back (list ("string", "net.corda:strings"));
+    second.emplace_back (list ("java.util.List<string>", "net.corda:nested"));
+    second.emplace_back (list ("long", "net.corda:otherLongs"));
+
+    // the same nested list over a differently described list of strings
+    sVec<uPtr<schema::AMQPTypeNotation>> third;
+    third.emplace_back (list ("string", "net.corda:otherStrings"));
+    third.emplace_back (list ("java.util.List<string>", "net.corda:nested"));
+
+    auto s1 = schemaOf (std::move (first));
+    auto s2 = schemaOf (std::move (second));
+    auto s3 = schemaOf (std::move (third));
+
+    auto cf1 = std::make_unique<CompositeFactory>();
+    CompositeFactory cf2, cf3;
+    cf1->process (*s1);
+    cf2.process (*s2);
+    cf3.process (*s3);
+
+    const std::string nested { "java.util.List<java.util.List<string>>" };
+
+    EXPECT_EQ (cf1->byType ("java.util.List<string>"), cf2.byType ("java.util.List<string>"));
+    EXPECT_EQ (cf1->byType (nested), cf2.byType (nested));
+    EXPECT_NE (cf1->byType ("java.util.List<long>"), cf2.byType ("java.util.List<long>"));
+
+    EXPECT_NE (cf1->byType ("java.util.List<string>"), cf3.byType ("java.util.List<string>"));
+    EXPECT_NE (cf1->byType (nested), cf3.byType (nested));
+
+    // readers outlive the factory that built them
+    auto reader = cf1->byType (nested);
+    cf1.reset();
+
+    EXPECT_EQ (reader, cf2.byType (nested));
+    EXPECT_NE (0, ReaderCache::instance().size());
+}
+
+/******************************************************************************/
+
+/**
+ * Keys don't depend on where readers happen to live, so clearing the cache
+ * whilst a factory still holds readers built before it can't leave an
+ * entry matching a reader that's since been freed
+ */
+TEST (CompositeFactory, cleared) { // NOLINT
+    auto types = []() {
+        sVec<uPtr<schema::AMQPTypeNotation>> rtn;
+        rtn.emplace_back (list ("string", "net.corda:clearedStrings"));
+        rtn.emplace_back (list ("java.util.List<string>", "net.corda:clearedNested"));
+        return schemaOf (std::move (rtn));
+    };
+
+    const std::string nested { "java.util.List<java.util.List<string>>" };
+
+    auto s1 = types();
+    auto cf1 = std::make_unique<CompositeFactory>();
+    cf1->process (*s1);
+    auto old = cf1->byType (nested).get();
+
+    ReaderCache::instance().clear();
+
+    auto s2 = types();
+    CompositeFactory cf2;
+    cf2.process (*s2);
+
+    EXPECT_NE (old, cf2.byType (nested).get());
+
+    cf1.reset();
+
+    auto s3 = types();
+    CompositeFactory cf3;
+    cf3.process (*s3);
+
+    EXPECT_EQ (cf2.byType (nested), cf3.byType (nested));
+    EXPECT_EQ (cf2.byType ("java.util.List<string>"), cf3.byType ("java.util.List<string>"));
+}
+
+/******************************************************************************/
+
+/**
+ * Definitions whose hashes collide still get readers of their own
+ */
+TEST (CompositeFactory, collision) { // NOLINT
+    auto & cache = ReaderCache::instance();
+
+    ReaderCache::Key one { "collision", "one" };
+    ReaderCache::Key other { "collision", "other" };
+    other.fingerprint = one.fingerprint;
+
+    auto first = reader::PropertyReader::make ("int");
+    auto second = reader::PropertyReader::make ("long");
+
+    EXPECT_EQ (first, cache.insert (one, first));
+
+    EXPECT_EQ (nullptr, cache.find (other));
+    EXPECT_EQ (second, cache.insert (other, second));
+
+    EXPECT_EQ (first, cache.find (one));
+    EXPECT_EQ (second, cache.find (other));
+}
+
+/******************************************************************************/
+
+TEST (CompositeFactory, versions) { // NOLINT
+    // Two versions of the same type, and with it a type depending on it,
+    // seen alternately as blobs written with each would be
+    auto version = [](const std::string & descriptor_) {
+        sVec<uPtr<schema::AMQPTypeNotation>> types;
+        types.emplace_back (list ("int", descriptor_));
+        types.emplace_back (list ("java.util.List<int>", "net.corda:ints"));
+
+        return schemaOf (std::move (types));
+    };
+
+    auto v1 = version ("net.corda:v1");
+    auto v2 = version ("net.corda:v2");
+
+    const std::string name { "java.util.List<int>" };
+    const std::string outer { "java.util.List<java.util.List<int>>" };
+
+    sVec<std::shared_ptr<amqp::internal::CompositeFactory::ReaderType>> readers;
+
+    for (int i { 0 } ; i < 4 ; ++i) {
+        CompositeFactory cf;
+        cf.process (i % 2 ? *v2 : *v1);
+
+        ASSERT_NE (nullptr, cf.byType (name));
+        ASSERT_NE (nullptr, cf.byType (outer));
+
+        readers.push_back (cf.byType (name));
+        readers.push_back (cf.byType (outer));
+    }
+
+    EXPECT_NE (readers[0], readers[2]);
+    EXPECT_NE (readers[1], readers[3]);
+
+    EXPECT_EQ (readers[0], readers[4]);
+    EXPECT_EQ (readers[1], readers[5]);
+    EXPECT_EQ (readers[2], readers[6]);
+    EXPECT_EQ (readers[3], readers[7]);
+}
+
+/******************************************************************************/
@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+
+#include "dom/Document.h"
+#include "dom/DocumentBuilder.h"
+
+/******************************************************************************/
+
+using namespace amqp::internal::dom;
+
+/******************************************************************************/
+
+namespace {
+
+    /**
+     * What the readers would show a visitor for
+     *
+     *      { a : 1, b : [ 2, 3 ], c : { "x" : 1.5 }, d : { e : true } }
+     */
+    Document
+    build() {
+        DocumentBuilder builder;
+
+        builder.beginComposite ("outer");
+        builder.property ("a");
+        builder.value (int32_t { 1 });
+        builder.property ("b");
+        builder.beginList (2);
+        builder.value (int64_t { 2 });
+        builder.value (int64_t { 3 });
+        builder.endList();
+        builder.property ("c");
+        builder.beginMap (1);
+        builder.value (std::string { "x" });
+        builder.value (1.5);
+        builder.endMap();
+        builder.property ("d");
+        builder.beginComposite ("inner");
+        builder.property ("e");
+        builder.value (true);
+        builder.endComposite();
+        builder.endComposite();
+
+        return builder.document();
+    }
+
+}
+
+/******************************************************************************/
+
+TEST (Document, access) { // NOLINT
+    auto document = build();
+    auto root = document.root();
+
+    ASSERT_TRUE (root.isComposite());
+    EXPECT_EQ ("outer", root.type());
+    EXPECT_EQ (4, root.size());
+
+    EXPECT_EQ (1, root["a"].get<int64_t>());
+
+    auto b = root["b"];
+    ASSERT_TRUE (b.isList());
+    EXPECT_EQ (2, b.size());
+    EXPECT_EQ (3, b[1].get<int64_t>());
+
+    auto c = root["c"];
+    ASSERT_TRUE (c.isMap());
+    EXPECT_EQ (1, c.size());
+    EXPECT_EQ ("x", c[0].get<std::string_view>());
+    EXPECT_EQ (1.5, c[1].get<double>());
+
+    EXPECT_EQ ("inner", root["d"].type());
+    EXPECT_TRUE (root["d"]["e"].get<bool>());
+
+    EXPECT_THROW (root["z"], std::runtime_error);
+    EXPECT_THROW (root["a"].get<double>(), std::runtime_error);
+    EXPECT_THROW (b[2], std::out_of_range);
+}
+
+/******************************************************************************/
+
+TEST (Document, iterate) { // NOLINT
+    auto document = build();
+
+    std::string names;
+    for (auto it = document.root().begin() ; it != document.root().end() ; ++it) {
+        names += it.name();
+    }
+
+    EXPECT_EQ ("abcd", names);
+}
+
+/******************************************************************************/
+
+TEST (Document, dump) { // NOLINT
+    EXPECT_EQ (
+        R"({ a : 1, b : [ 2, 3 ], c : { "x" : 1.5 }, d : { e : 1 } })",
+        build().root().dump());
+}
+
+/******************************************************************************/
+
+/**
+ * However many composites of a type a document holds their names are
+ * only written once
+ */
+TEST (Document, names) { // NOLINT
+    DocumentBuilder builder;
+
+    builder.beginList (100);
+    for (int32_t i { 0 } ; i < 100 ; ++i) {
+        builder.beginComposite ("inner");
+        builder.property ("e");
+        builder.value (i);
+        builder.endComposite();
+    }
+    builder.endList();
+
+    auto document = builder.document();
+
+    // a length and the characters of "inner" and of "e"
+    EXPECT_EQ (4 + 5 + 4 + 1, document.bytes() - document.tape().size() * sizeof (uint64_t));
+
+    EXPECT_EQ ("inner", document.root()[99].type());
+    EXPECT_EQ (99, document.root()[99]["e"].get<int64_t>());
+}
+
+/******************************************************************************/
+
+TEST (Document, json) { // NOLINT
+    std::string json;
+    build().root().jsonTo (json);
+
+    EXPECT_EQ (
+        R"({"a":1,"b":[2,3],"c":[["x",1.5]],"d":{"e":true}})",
+        json);
+}
+
+/******************************************************************************/
+
+/**
+ * Replaying a document through a builder should give us the same tape
+ */
+TEST (Document, visit) { // NOLINT
+    auto document = build();
+
+    DocumentBuilder builder;
+    document.root().visit (builder);
+
+    auto copy = builder.document();
+
+    EXPECT_EQ (document.tape(), copy.tape());
+    EXPECT_EQ (document.bytes(), copy.bytes());
+}
+
+/******************************************************************************/
@@ -0,0 +1,287 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <sstream>
+
+#include <proton/codec.h>
+
+#include "CompositeFactory.h"
+#include "evolution/Plan.h"
+#include "reader/EvolvedReader.h"
+#include "scan/Tape.h"
+#include "dom/Document.h"
+#include "dom/DocumentBuilder.h"
+#include "columnar/ColumnarVisitor.h"
+
+#include "amqp/schema/described-types/Schema.h"
+#include "amqp/schema/described-types/Composite.h"
+#include "amqp/schema/described-types/Descriptor.h"
+#include "amqp/schema/field-types/Field.h"
+
+/******************************************************************************/
+
+using namespace amqp::internal;
+
+/******************************************************************************/
+
+namespace {
+
+    uPtr<schema::Composite>
+    composite (
+        const std::string & descriptor_,
+        const sVec<std::pair<std::string, std::string>> & fields_
+    ) {
+        sVec<uPtr<schema::Field>> fields;
+
+        for (const auto & [name, type] : fields_) {
+            fields.emplace_back (schema::Field::make (
+                name, type, { }, "", "", false, false));
+        }
+
+        return std::make_unique<schema::Composite> (
+            "net.corda.Evolved",
+            "label",
+            std::list<std::string> { },
+            std::make_unique<schema::Descriptor> (descriptor_),
+            std::move (fields));
+    }
+
+    uPtr<schema::Schema>
+    schemaOf (uPtr<schema::Composite> composite_) {
+        schema::OrderedTypeNotations<schema::AMQPTypeNotation> types;
+        types.insert (std::move (composite_));
+
+        return std::make_unique<schema::Schema> (std::move (types));
+    }
+
+    /**
+     * The blob's version of the class, a : int, b : string, c : long
+     */
+    auto remote() {
+        return composite ("net.corda:v1", {
+            { "a", "int" }, { "b", "string" }, { "c", "long" } });
+    }
+
+    /**
+     * Our version, where b has gone, c moved to the front and d added
+     */
+    auto local() {
+        return composite ("net.corda:v2", {
+            { "c", "long" }, { "a", "int" }, { "d", "int" } });
+    }
+
+    /**
+     * An instance of the blob's version, { a : 1, b : "x", c : 3 }
+     */
+    const std::string encoded {
+        "\x00"
+        "\xA3\x0C" "net.corda:v1"
+        "\xC0\x08\x03"
+            "\x54\x01"
+            "\xA1\x01" "x"
+            "\x55\x03",
+        25
+    };
+
+}
+
+/******************************************************************************/
+
+TEST (Evolution, plan) { // NOLINT
+    auto r = remote();
+    auto l = local();
+
+    auto plan = evolution::Plan::get (*r, *l);
+
+    ASSERT_EQ (3, plan->slots().size());
+    EXPECT_EQ (3, plan->remoteProperties());
+
+    EXPECT_EQ (2, plan->slots()[0].remote);
+    EXPECT_EQ (0, plan->slots()[1].remote);
+    EXPECT_EQ (-1, plan->slots()[2].remote);
+
+    EXPECT_EQ ("c", plan->names()[0].str());
+    EXPECT_EQ ("d", plan->names()[2].str());
+
+    // compiled once per pair of versions
+    EXPECT_EQ (plan, evolution::Plan::get (*remote(), *local()));
+}
+
+/******************************************************************************/
+
+TEST (Evolution, incompatible) { // NOLINT
+    auto r = remote();
+
+    auto retyped = composite ("net.corda:v3", { { "a", "long" } });
+    EXPECT_THROW (evolution::Plan (*r, *retyped), std::runtime_error); // NOLINT
+
+}
+
+/******************************************************************************/
+
+TEST (Evolution, read) { // NOLINT
+    auto remoteSchema = schemaOf (remote());
+    auto localSchema = schemaOf (local());
+
+    CompositeFactory cf (1, localSchema.get());
+    cf.process (*remoteSchema, "net.corda:v1");
+
+    auto reader = std::dynamic_pointer_cast<reader::EvolvedReader> (
+        cf.byDescriptor ("net.corda:v1"));
+    ASSERT_NE (nullptr, reader);
+
+    scan::Tape tape (encoded.data(), encoded.size());
+
+    EXPECT_EQ ("{ c : 3, a : 1, d : 0 }",
+        reader->dump (tape.root(), *remoteSchema)->dump());
+
+    dom::DocumentBuilder builder;
+    reader->visit (tape.root(), *remoteSchema, builder);
+
+    EXPECT_EQ ("{ c : 3, a : 1, d : 0 }", builder.document().root().dump());
+
+    // without a local schema it's read as written
+    CompositeFactory plain;
+    plain.process (*remoteSchema, "net.corda:v1");
+
+    auto written = std::dynamic_pointer_cast<reader::Reader> (
+        plain.byDescriptor ("net.corda:v1"));
+
+    EXPECT_EQ ("{ a : 1, b : \"x\", c : 3 }",
+        written->dump (tape.root(), *remoteSchema)->dump());
+}
+
+/******************************************************************************/
+
+/**
+ * Properties the blob doesn't have are what Java would default them to,
+ * zero for a primitive, null for anything else
+ */
+TEST (Evolution, defaults) { // NOLINT
+    auto remoteSchema = schemaOf (remote());
+    auto localSchema = schemaOf (composite ("net.corda:v5", {
+        { "a", "int" }, { "f", "float" }, { "s", "string" },
+        { "o", "net.corda.Other" }, { "b", "string" } }));
+
+    CompositeFactory cf (1, localSchema.get());
+    cf.process (*remoteSchema, "net.corda:v1");
+
+    auto reader = std::dynamic_pointer_cast<reader::EvolvedReader> (
+        cf.byDescriptor ("net.corda:v1"));
+    ASSERT_NE (nullptr, reader);
+
+    scan::Tape tape (encoded.data(), encoded.size());
+
+    const std::string expected {
+        R"({ a : 1, f : 0, s : null, o : null, b : "x" })" };
+
+    EXPECT_EQ (expected, reader->dump (tape.root(), *remoteSchema)->dump());
+
+    dom::DocumentBuilder builder;
+    reader->visit (tape.root(), *remoteSchema, builder);
+
+    EXPECT_EQ (expected, builder.document().root().dump());
+}
+
+/******************************************************************************/
+
+/**
+ * Through proton rather than a tape, where the properties that come out
+ * of order have to be read in a single pass
+ */
+TEST (Evolution, proton) { // NOLINT
+    auto remoteSchema = schemaOf (remote());
+    auto localSchema = schemaOf (local());
+
+    CompositeFactory cf (1, localSchema.get());
+    cf.process (*remoteSchema, "net.corda:v1");
+
+    auto reader = std::dynamic_pointer_cast<reader::EvolvedReader> (
+        cf.byDescriptor ("net.corda:v1"));
+    ASSERT_NE (nullptr, reader);
+
+    auto read = [&](auto f_) {
+        pn_data_t * data = pn_data (encoded.size());
+        ASSERT_EQ (encoded.size(), pn_data_decode (data, encoded.data(), encoded.size()));
+
+        f_ (data);
+
+        pn_data_free (data);
+    };
+
+    read ([&](pn_data_t * data_) {
+        EXPECT_EQ ("{ c : 3, a : 1, d : 0 }",
+            reader->dump (data_, *remoteSchema)->dump());
+    });
+
+    read ([&](pn_data_t * data_) {
+        dom::DocumentBuilder builder;
+        reader->visit (data_, *remoteSchema, builder);
+
+        EXPECT_EQ ("{ c : 3, a : 1, d : 0 }", builder.document().root().dump());
+    });
+}
+
+/******************************************************************************/
+
+/**
+ * Evolved blobs split into columns, s being null in those written
+ * without it
+ */
+TEST (Evolution, columnar) { // NOLINT
+    auto localSchema = schemaOf (composite ("net.corda:v7", {
+        { "a", "int" }, { "s", "string" } }));
+
+    auto without = schemaOf (remote());
+    auto with = schemaOf (composite ("net.corda:v6", {
+        { "a", "int" }, { "s", "string" } }));
+
+    // { a : 2, s : "y" }
+    const std::string encodedWith {
+        "\x00"
+        "\xA3\x0C" "net.corda:v6"
+        "\xC0\x06\x02"
+            "\x54\x02"
+            "\xA1\x01" "y",
+        23
+    };
+
+    columnar::ColumnarVisitor visitor;
+
+    auto visit = [&](
+        const std::string & encoded_,
+        const schema::Schema & schema_,
+        const std::string & descriptor_
+    ) {
+        CompositeFactory cf (1, localSchema.get());
+        cf.process (schema_, descriptor_);
+
+        scan::Tape tape (encoded_.data(), encoded_.size());
+        auto reader = std::dynamic_pointer_cast<reader::Reader> (
+            cf.byDescriptor (descriptor_));
+        ASSERT_NE (nullptr, reader);
+
+        reader->visit (tape.root(), schema_, visitor);
+    };
+
+    visit (encoded, *without, "net.corda:v1");
+    visit (encodedWith, *with, "net.corda:v6");
+    visit (encoded, *without, "net.corda:v1");
+
+    ASSERT_EQ (3, visitor.rows());
+    ASSERT_EQ (2, visitor.columns().size());
+
+    const auto & s = *visitor.columns()[1];
+    EXPECT_EQ ("s", s.path());
+    EXPECT_EQ (3, s.size());
+    EXPECT_EQ (2, s.nulls());
+
+    std::stringstream ss;
+    visitor.csv (ss);
+
+    EXPECT_EQ ("a,s\n1,\n2,y\n1,\n", ss.str());
+
+    EXPECT_NO_THROW (visitor.write (ss)); // NOLINT
+}
+
+/******************************************************************************/
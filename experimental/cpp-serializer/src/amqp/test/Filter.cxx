@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+
+#include "filter/Filter.h"
+
+/******************************************************************************/
+
+using namespace amqp::internal::filter;
+
+/******************************************************************************/
+
+TEST (Filter, parse) { // NOLINT
+    Filter filter { R"(a.b >= 10 and c[] != "x y\"z" && d{}.key=true)" };
+
+    const auto & clauses = filter.clauses();
+    ASSERT_EQ (3, clauses.size());
+
+    EXPECT_EQ ("a.b", clauses[0].path);
+    EXPECT_EQ (ge_o, clauses[0].op);
+    EXPECT_EQ ("10", clauses[0].literal);
+
+    EXPECT_EQ ("c[]", clauses[1].path);
+    EXPECT_EQ (ne_o, clauses[1].op);
+    EXPECT_EQ ("x y\"z", clauses[1].literal);
+
+    EXPECT_EQ ("d{}.key", clauses[2].path);
+    EXPECT_EQ (eq_o, clauses[2].op);
+    EXPECT_EQ ("true", clauses[2].literal);
+}
+
+/******************************************************************************/
+
+TEST (Filter, parseErrors) { // NOLINT
+    EXPECT_THROW (Filter (""), std::runtime_error);
+    EXPECT_THROW (Filter ("a"), std::runtime_error);
+    EXPECT_THROW (Filter ("a =~ 1"), std::runtime_error);
+    EXPECT_THROW (Filter ("a = "), std::runtime_error);
+    EXPECT_THROW (Filter ("a = \"open"), std::runtime_error);
+    EXPECT_THROW (Filter ("a = 1 or b = 2"), std::runtime_error);
+    EXPECT_THROW (Filter ("a = 1 android.x = 2"), std::runtime_error);
+}
+
+/******************************************************************************/
+
+TEST (Filter, parseKeywordPrefix) { // NOLINT
+    Filter filter { "android.x = 1 and and.y = 2" };
+
+    const auto & clauses = filter.clauses();
+    ASSERT_EQ (2, clauses.size());
+
+    EXPECT_EQ ("android.x", clauses[0].path);
+    EXPECT_EQ ("and.y", clauses[1].path);
+}
+
+/******************************************************************************/
+
+TEST (Filter, predicate) { // NOLINT
+    Predicate i ({ "a", lt_o, "10" }, "int", false);
+    EXPECT_TRUE (i.test (int64_t { 9 }));
+    EXPECT_FALSE (i.test (int64_t { 10 }));
+
+    Predicate d ({ "a", gt_o, "1.5" }, "double", true);
+    EXPECT_TRUE (d.test (2.0));
+    EXPECT_FALSE (d.test (1.5));
+    EXPECT_TRUE (d.repeated());
+
+    Predicate b ({ "a", ne_o, "false" }, "boolean", false);
+    EXPECT_TRUE (b.test (true));
+    EXPECT_FALSE (b.test (false));
+
+    Predicate s ({ "a", eq_o, "A" }, "string", false);
+    EXPECT_TRUE (s.test (std::string ("A")));
+    EXPECT_FALSE (s.test (std::string ("B")));
+
+    EXPECT_THROW (
+        Predicate ({ "a", lt_o, "true" }, "boolean", false),
+        std::runtime_error);
+    EXPECT_THROW (
+        Predicate ({ "a", eq_o, "ten" }, "int", false),
+        std::runtime_error);
+}
+
+/******************************************************************************/
@@ -14,7 +14,7 @@ using namespace amqp::internal::reader;
 TEST (Pair, string) { // NOLINT
     TypedPair<std::string> str_test ("Left", "Hello");
 
-    EXPECT_EQ("Left : Hello", str_test.dump());
+    EXPECT_EQ(R"(Left : "Hello")", str_test.dump());
 }
 
 /******************************************************************************/
@@ -31,7 +31,7 @@ TEST (Pair, UP1) { // NOLINT
     std::unique_ptr<TypedPair<double>> test =
         std::make_unique<TypedPair<double>> ("property", 10.0);
 
-    EXPECT_EQ("property : 10.000000", test->dump());
+    EXPECT_EQ("property : 10", test->dump());
 }
 
 /******************************************************************************/
@@ -59,3 +59,23 @@ TEST (Pair, UP2) { // NOLINT
 
 /******************************************************************************/
 
+
+TEST (Pair, primitives) { // NOLINT
+    TypedPair<Primitives<long>> longs ("a", Primitives<long> { { 1, 2 } });
+    EXPECT_EQ ("a : [ 1, 2 ]", longs.dump());
+}
+
+/******************************************************************************/
+
+TEST (Pair, interned) { // NOLINT
+    std::string a { "interned" };
+    TypedPair<int> first (a, 1);
+    TypedPair<int> second ("interned", 2);
+
+    EXPECT_EQ (amqp::reader::Name (a), amqp::reader::Name ("interned"));
+    EXPECT_EQ (&amqp::reader::Name (a).str(), &amqp::reader::Name ("interned").str());
+    EXPECT_EQ ("interned : 1", first.dump());
+    EXPECT_EQ ("interned : 2", second.dump());
+}
+
+/******************************************************************************/
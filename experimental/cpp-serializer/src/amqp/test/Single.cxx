@@ -14,7 +14,7 @@ using namespace amqp::internal::reader;
 TEST (Single, string) { // NOLINT
     TypedSingle<std::string> str_test ("Hello");
 
-    EXPECT_EQ("Hello", str_test.dump());
+    EXPECT_EQ(R"("Hello")", str_test.dump());
 }
 
 /******************************************************************************/
@@ -43,3 +43,44 @@ TEST (Single, list) { // NOLINT
     EXPECT_EQ("[ 1, 2, 3, 4, 5 ]", test->dump());
 }
 /******************************************************************************/
+
+TEST (Single, primitives) { // NOLINT
+    TypedSingle<Primitives<int>> ints (Primitives<int> { { 1, 2, 3 } });
+    EXPECT_EQ ("[ 1, 2, 3 ]", ints.dump());
+
+    TypedSingle<Primitives<long>> empty (Primitives<long> { });
+    EXPECT_EQ ("[  ]", empty.dump());
+
+    TypedSingle<Primitives<double>> doubles (Primitives<double> { { 1.5 } });
+    EXPECT_EQ ("[ 1.5 ]", doubles.dump());
+}
+
+/******************************************************************************/
+
+TEST (Single, elements) { // NOLINT
+    Elements elements;
+    elements.values.emplace_back (std::make_unique<TypedSingle<int>> (1));
+    elements.values.emplace_back (std::make_unique<TypedSingle<std::string>> ("a"));
+
+    TypedSingle<Elements> single (std::move (elements));
+    EXPECT_EQ (R"([ 1, "a" ])", single.dump());
+
+    TypedPair<Elements> pair ("list", Elements { });
+    EXPECT_EQ ("list : [  ]", pair.dump());
+}
+
+/******************************************************************************/
+
+TEST (Single, numbers) { // NOLINT
+    EXPECT_EQ ("-2147483648", TypedSingle<int> (-2147483647 - 1).dump());
+    EXPECT_EQ ("9223372036854775807", TypedSingle<long> (9223372036854775807L).dump());
+    EXPECT_EQ ("0.1", TypedSingle<double> (0.1).dump());
+    EXPECT_EQ ("1e+300", TypedSingle<double> (1e300).dump());
+    EXPECT_EQ ("1", TypedSingle<bool> (true).dump());
+
+    std::string out { "x : " };
+    TypedSingle<double> (2.5).dumpTo (out);
+    EXPECT_EQ ("x : 2.5", out);
+}
+
+/******************************************************************************/
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+
+#include "amqp/SnapshotMap.h"
+
+/******************************************************************************/
+
+using namespace amqp::internal;
+
+/******************************************************************************/
+
+TEST (SnapshotMap, insert) { // NOLINT
+    SnapshotMap<std::string, sPtr<int>> map;
+
+    EXPECT_EQ (nullptr, map.find ("a"));
+
+    auto one = std::make_shared<int> (1);
+    EXPECT_EQ (one, map.insert ("a", one));
+
+    // the first value in wins
+    EXPECT_EQ (one, map.insert ("a", std::make_shared<int> (2)));
+    EXPECT_EQ (one, map.find ("a"));
+    EXPECT_EQ (1, map.size());
+
+    map.clear();
+    EXPECT_EQ (nullptr, map.find ("a"));
+    EXPECT_EQ (0, map.size());
+}
+
+/******************************************************************************/
+
+/**
+ * Looking a value up hands back the one in the snapshot rather than a
+ * copy, so doesn't touch its reference count
+ */
+TEST (SnapshotMap, reference) { // NOLINT
+    SnapshotMap<std::string, sPtr<int>> map;
+
+    auto one = std::make_shared<int> (1);
+    map.insert ("a", one);
+
+    auto count = one.use_count();
+
+    const auto & found = map.find ("a");
+    EXPECT_EQ (one, found);
+    EXPECT_EQ (count, one.use_count());
+
+    EXPECT_EQ (&found, &map.find ("a"));
+}
+
+/******************************************************************************/
+
+/**
+ * A thread that has read the map sees what other threads add to it
+ * afterwards, and two maps don't confuse a thread's snapshots
+ */
+TEST (SnapshotMap, threads) { // NOLINT
+    SnapshotMap<int, int> a;
+    SnapshotMap<int, int> b;
+
+    a.insert (0, 10);
+    b.insert (0, 20);
+
+    EXPECT_EQ (10, a.find (0));
+    EXPECT_EQ (20, b.find (0));
+
+    const int threads { 4 };
+    const int each { 250 };
+
+    sVec<std::thread> writers;
+
+    for (int t { 0 } ; t < threads ; ++t) {
+        writers.emplace_back ([&a, t, each]() {
+            for (int i { 1 } ; i <= each ; ++i) {
+                auto key = t * each + i;
+                a.insert (key, key);
+
+                // we always see our own writes
+                EXPECT_EQ (key, a.find (key));
+            }
+        });
+    }
+
+    for (auto & writer : writers) {
+        writer.join();
+    }
+
+    EXPECT_EQ (threads * each + 1, a.size());
+
+    for (int key { 1 } ; key <= threads * each ; ++key) {
+        ASSERT_EQ (key, a.find (key));
+    }
+
+    EXPECT_EQ (20, b.find (0));
+}
+
+/******************************************************************************/
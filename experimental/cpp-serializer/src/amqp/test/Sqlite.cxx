@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <cstdio>
+
+#include <unistd.h>
+
+#include <sqlite3.h>
+
+#include "sqlite/SqliteVisitor.h"
+
+/******************************************************************************/
+
+using namespace amqp::internal::sqlite;
+
+/******************************************************************************/
+
+namespace {
+
+    /**
+     * Equivalent of visiting
+     *
+     *  outer { a : int, b : [ inner { c : string } ], m : { int : [ long ] } }
+     */
+    void
+    row (SqliteVisitor & visitor_, int a_, const sVec<std::string> & cs_) {
+        visitor_.beginComposite ("outer");
+        visitor_.property ("a");
+        visitor_.value (a_);
+        visitor_.property ("b");
+        visitor_.beginList (cs_.size());
+        for (const auto & c : cs_) {
+            visitor_.beginComposite ("inner");
+            visitor_.property ("c");
+            visitor_.value (c);
+            visitor_.endComposite();
+        }
+        visitor_.endList();
+        visitor_.property ("m");
+        visitor_.beginMap (1);
+        visitor_.value (a_);
+        visitor_.beginList (2);
+        visitor_.value (int64_t { 10 } * a_);
+        visitor_.value (int64_t { 20 } * a_);
+        visitor_.endList();
+        visitor_.endMap();
+        visitor_.endComposite();
+    }
+
+    /**
+     * Every row of a query, columns separated by '|', rows by ';'
+     */
+    std::string
+    query (const std::string & path_, const std::string & sql_) {
+        sqlite3 * db;
+        sqlite3_open (path_.c_str(), &db);
+
+        std::string rtn;
+
+        sqlite3_exec (db, sql_.c_str(), [](void * rtn_, int n_, char ** values_, char **) {
+            auto & rtn = *static_cast<std::string *> (rtn_);
+
+            for (int i { 0 } ; i < n_ ; ++i) {
+                rtn += (i ? "|" : "");
+                rtn += values_[i] ? values_[i] : "NULL";
+            }
+            rtn += ";";
+
+            return 0;
+        }, &rtn, nullptr);
+
+        sqlite3_close (db);
+
+        return rtn;
+    }
+
+}
+
+/******************************************************************************/
+
+TEST (Sqlite, tables) { // NOLINT
+    std::string path { "sqlite-test-" + std::to_string (::getpid()) + ".db" };
+    std::remove (path.c_str());
+
+    {
+        // small batches to commit part way through
+        SqliteVisitor visitor (path, 4);
+
+        row (visitor, 1, { "one", "two" });
+        row (visitor, 2, { });
+    }
+
+    EXPECT_EQ ("1|1;2|2;", query (path, R"(SELECT _id, a FROM "outer")"));
+    EXPECT_EQ ("1|one;2|two;", query (path, R"(SELECT _id, c FROM "inner")"));
+
+    // the list's elements are the ids of the inner rows
+    EXPECT_EQ ("1|0|one;1|1|two;", query (path,
+        R"(SELECT b._parent, b._index, i.c FROM "outer.b" b JOIN "inner" i ON b.value = i._id)"));
+
+    EXPECT_EQ ("1|1;2|2;", query (path, R"(SELECT _parent, key FROM "outer.m")"));
+
+    // the map's values are lists, their elements belonging to the entry
+    EXPECT_EQ ("1|0|10;1|1|20;2|0|20;2|1|40;", query (path,
+        R"(SELECT m.key, l._index, l.value FROM "outer.m" m )"
+        R"(JOIN "outer.m{}.value" l ON l._parent = m._id ORDER BY m.key, l._index)"));
+
+    // loading again would duplicate what's there
+    EXPECT_THROW (SqliteVisitor visitor (path), std::runtime_error);
+    EXPECT_EQ ("1|1;2|2;", query (path, R"(SELECT _id, a FROM "outer")"));
+
+    std::remove (path.c_str());
+}
+
+/******************************************************************************/
+
+/**
+ * A load that fails keeps the batches committed before it but not the
+ * one it was part way through
+ */
+TEST (Sqlite, rollback) { // NOLINT
+    std::string path { "sqlite-test-" + std::to_string (::getpid()) + ".db" };
+    std::remove (path.c_str());
+
+    try {
+        SqliteVisitor visitor (path);
+
+        row (visitor, 1, { "one" });
+        visitor.commit();
+
+        row (visitor, 2, { "two" });
+
+        throw std::runtime_error ("part way");
+    } catch (const std::runtime_error &) {
+    }
+
+    EXPECT_EQ ("1|1;", query (path, R"(SELECT _id, a FROM "outer")"));
+    EXPECT_EQ ("1|one;", query (path, R"(SELECT _id, c FROM "inner")"));
+
+    std::remove (path.c_str());
+}
+
+/******************************************************************************/
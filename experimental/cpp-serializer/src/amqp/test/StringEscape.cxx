@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+
+#include "json/StringEscape.h"
+#include "reader/restricted-readers/EnumReader.h"
+#include "scan/Tape.h"
+
+#include "amqp/schema/described-types/Schema.h"
+
+/******************************************************************************/
+
+using namespace amqp::internal::json;
+
+/******************************************************************************/
+
+TEST (StringEscape, plain) { // NOLINT
+    EXPECT_EQ (R"("")", quote (""));
+    EXPECT_EQ (R"("hello")", quote ("hello"));
+    EXPECT_EQ (R"("caf)" "\xC3\xA9" R"(")", quote ("caf\xC3\xA9"));
+    EXPECT_EQ ("\"\xF0\x9F\x98\x80\"", quote ("\xF0\x9F\x98\x80"));
+}
+
+/******************************************************************************/
+
+TEST (StringEscape, escapes) { // NOLINT
+    EXPECT_EQ (R"("a\"b\\c")", quote ("a\"b\\c"));
+    EXPECT_EQ (R"("\n\r\t\b\f")", quote ("\n\r\t\b\f"));
+    EXPECT_EQ (R"("\u0000\u001f")", quote (std::string ("\0\x1F", 2)));
+}
+
+/******************************************************************************/
+
+TEST (StringEscape, invalidUtf8) { // NOLINT
+    // lone continuation, truncated sequence, overlong, surrogate
+    EXPECT_EQ (R"("\ufffd")", quote ("\x80"));
+    EXPECT_EQ (R"("\ufffda")", quote ("\xC3" "a"));
+    EXPECT_EQ (R"("\ufffd\ufffd")", quote ("\xC0\xAF"));
+    EXPECT_EQ (R"("\ufffd\ufffd\ufffd")", quote ("\xED\xA0\x80"));
+}
+
+/******************************************************************************/
+
+/**
+ * Make sure the vectorised scan agrees with the scalar one wherever
+ * the first interesting byte falls relative to the block boundaries
+ */
+TEST (StringEscape, blockBoundaries) { // NOLINT
+    for (size_t len { 0 } ; len < 80 ; ++len) {
+        for (size_t at { 0 } ; at <= len ; ++at) {
+            for (char c : { '"', '\\', '\n', '\x7F', '\x80' }) {
+                std::string s (len, 'x');
+                if (at < len) s[at] = c;
+
+                ASSERT_EQ (
+                    plainPrefixScalar (s.data(), s.size()),
+                    plainPrefix (s.data(), s.size()))
+                        << "len " << len << " at " << at;
+            }
+        }
+    }
+
+    std::string s (100, 'x');
+    s[70] = '"';
+    EXPECT_EQ (std::string ("\"") + std::string (70, 'x') + "\\\""
+               + std::string (29, 'x') + "\"", quote (s));
+}
+
+/******************************************************************************/
+
+/**
+ * An enum's constant is written as a string, so escaped as one
+ */
+TEST (StringEscape, enum) { // NOLINT
+    // an enumerated value with a symbol fingerprint of "f" whose constant
+    // is [A"B\nC] at ordinal 0
+    const std::string encoded {
+        "\x00"
+        "\xA3\x01" "f"
+        "\xC0\x0A\x02"
+            "\xA1\x05" "A\"B\nC"
+            "\x54\x00",
+        16
+    };
+
+    amqp::internal::scan::Tape tape (encoded.data(), encoded.size());
+    amqp::internal::schema::Schema schema (
+        amqp::internal::schema::OrderedTypeNotations<
+            amqp::internal::schema::AMQPTypeNotation> { });
+
+    amqp::internal::reader::EnumReader reader ("e", { "A\"B\nC" });
+
+    EXPECT_EQ (R"("A\"B\nC")", reader.dump (tape.root(), schema)->dump());
+    EXPECT_EQ (R"(e : "A\"B\nC")", reader.dump ("e", tape.root(), schema)->dump());
+}
+
+/******************************************************************************/
@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "scan/Tape.h"
+#include "scan/Scanner.h"
+
+/******************************************************************************/
+
+using namespace amqp::internal::scan;
+
+/******************************************************************************/
+
+namespace {
+
+    /**
+     * A described list of [ smallint 1, int 300, str8 "hi", null ] with a
+     * symbol descriptor "d", followed by a trailing true to show only the
+     * first value is indexed
+     */
+    const std::string encoded {
+        "\x00"
+        "\xA3\x01" "d"
+        "\xC0\x0D\x04"
+            "\x54\x01"
+            "\x71\x00\x00\x01\x2C"
+            "\xA1\x02" "hi"
+            "\x40"
+        "\x41",
+        20
+    };
+
+}
+
+/******************************************************************************/
+
+TEST (Tape, structure) { // NOLINT
+    Tape tape (encoded.data(), encoded.size());
+
+    // described, descriptor, list, and its four elements
+    ASSERT_EQ (7, tape.size());
+
+    EXPECT_EQ (0x00, tape[0].code);
+    EXPECT_EQ (19, tape[0].size);
+    EXPECT_EQ (7, tape[0].next);
+
+    EXPECT_EQ (0xC0, tape[2].code);
+    EXPECT_EQ (4, tape[2].count);
+    EXPECT_EQ (7, tape[2].next);
+
+    for (size_t i { 3 } ; i < 7 ; ++i) {
+        EXPECT_EQ (i + 1, tape[i].next);
+    }
+}
+
+/******************************************************************************/
+
+TEST (Tape, cursor) { // NOLINT
+    Tape tape (encoded.data(), encoded.size());
+
+    auto root = tape.root();
+
+    EXPECT_TRUE (root.isDescribed());
+    EXPECT_EQ ("d", root.descriptor().get<std::string_view>());
+
+    auto list = root.value();
+    EXPECT_TRUE (list.isList());
+    EXPECT_EQ (4, list.count());
+
+    auto element = list.first();
+    EXPECT_EQ (1, element.get<int>());
+
+    element.next();
+    EXPECT_EQ (300, element.get<int>());
+    EXPECT_EQ (std::string ("\x71\x00\x00\x01\x2C", 5), element.raw());
+
+    element.next();
+    EXPECT_EQ ("hi", element.get<std::string_view>());
+
+    element.next();
+    EXPECT_TRUE (element.isNull());
+}
+
+/******************************************************************************/
+
+TEST (Tape, errors) { // NOLINT
+    Tape tape (encoded.data(), encoded.size());
+
+    EXPECT_THROW (tape.root().value().get<int>(), std::runtime_error);
+    EXPECT_THROW (tape.root().value().first().get<long>(), std::runtime_error);
+    EXPECT_THROW (tape.root().value().descriptor(), std::runtime_error);
+
+    // Chop the last element off the list
+    EXPECT_THROW (Tape (encoded.data(), 18), std::runtime_error);
+}
+
+/******************************************************************************/
+
+/**
+ * Descriptors that are themselves described, nested far deeper than the
+ * stack would allow were we to recurse into them
+ */
+TEST (Tape, describedDescriptors) { // NOLINT
+    const size_t depth { 1 << 20 };
+
+    std::string chain (depth, '\x00');
+    chain.append (depth + 1, '\x40');
+
+    Scanner scanner (chain.data(), chain.size());
+
+    auto node = scanner.at (0);
+    EXPECT_EQ (chain.size(), node.size);
+    EXPECT_EQ (2, node.count);
+
+    // all but the leading 0x00 and the outermost value
+    EXPECT_EQ (chain.size() - 2, scanner.children (node)[0].size);
+
+    EXPECT_THROW (
+        Scanner (chain.data(), chain.size() - 1).at (0),
+        std::runtime_error);
+}
+
+/******************************************************************************/
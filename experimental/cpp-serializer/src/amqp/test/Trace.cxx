@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <sstream>
+
+#include "amqp/trace/Trace.h"
+
+/******************************************************************************/
+
+using namespace amqp::internal::trace;
+
+/******************************************************************************/
+
+namespace {
+
+    size_t
+    count (const std::string & haystack_, const std::string & needle_) {
+        size_t rtn { 0 };
+
+        for (auto i = haystack_.find (needle_) ;
+             i != std::string::npos ;
+             i = haystack_.find (needle_, i + needle_.size()))
+        {
+            ++rtn;
+        }
+
+        return rtn;
+    }
+
+    std::string
+    trace() {
+        std::stringstream out;
+        Tracer::write (out);
+        return out.str();
+    }
+
+}
+
+/******************************************************************************/
+
+TEST (Trace, disabled) { // NOLINT
+    Tracer::start();
+    Tracer::stop();
+
+    {
+        Span span ("nothing");
+    }
+
+    auto json = trace();
+
+    EXPECT_EQ (0, count (json, "\"ph\" : \"X\"")) << json;
+    EXPECT_EQ (0, count (json, "nothing")) << json;
+}
+
+/******************************************************************************/
+
+/**
+ * Each thread's spans end up on a thread of their own, nested spans
+ * within the span enclosing them
+ */
+TEST (Trace, threads) { // NOLINT
+    Tracer::start();
+
+    const std::string type { "net.corda.\"quoted\"" };
+
+    {
+        Span outer ("outer");
+        Span inner ("inner", &type);
+    }
+
+    std::thread other ([] {
+        Span span ("other");
+    });
+    other.join();
+
+    Tracer::stop();
+
+    auto json = trace();
+
+    EXPECT_EQ (3, count (json, "\"ph\" : \"X\"")) << json;
+    EXPECT_EQ (2, count (json, "\"thread_name\"")) << json;
+    EXPECT_EQ (1, count (json, "\"args\" : { \"type\" : \"net.corda.\\\"quoted\\\"\" }")) << json;
+
+    // inner ends first so is recorded first
+    EXPECT_LT (json.find ("\"inner\""), json.find ("\"outer\"")) << json;
+
+    auto tid = [&json](const std::string & name_) {
+        auto at = json.find ("\"tid\" : ", json.find ("\"" + name_ + "\""));
+        return json.substr (at, json.find (',', at) - at);
+    };
+
+    EXPECT_EQ (tid ("inner"), tid ("outer"));
+    EXPECT_NE (tid ("inner"), tid ("other"));
+}
+
+/******************************************************************************/
+
+/**
+ * A full ring keeps the latest spans
+ */
+TEST (Trace, wraps) { // NOLINT
+    Tracer::start (4);
+
+    for (const auto * name : { "a", "b", "c", "d", "e", "f" }) {
+        Span span (name);
+    }
+
+    Tracer::stop();
+
+    auto json = trace();
+
+    EXPECT_EQ (4, count (json, "\"ph\" : \"X\"")) << json;
+    EXPECT_EQ (std::string::npos, json.find ("\"b\"")) << json;
+    EXPECT_LT (json.find ("\"c\""), json.find ("\"f\"")) << json;
+}
+
+/******************************************************************************/
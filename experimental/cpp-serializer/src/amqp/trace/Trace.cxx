@@ -0,0 +1,248 @@
+#include "Trace.h"
+
+#include <mutex>
+#include <string>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <ostream>
+#include <unistd.h>
+
+#include "types.h"
+
+#include "json/StringEscape.h"
+
+/******************************************************************************/
+
+namespace {
+
+    using clock = std::chrono::steady_clock;
+
+    struct Event {
+        const char * name;
+        std::string  detail;
+        bool         hasDetail;
+        uint64_t     start;
+        uint64_t     end;
+    };
+
+    /**
+     * One thread's spans. Only that thread writes to it. [events] grows
+     * as spans are recorded, so a thread that records a handful costs a
+     * handful, until it reaches [capacity] after which the oldest are
+     * overwritten and recording no longer allocates beyond the detail
+     * strings, which reuse their capacity.
+     */
+    struct Ring {
+        uint32_t      thread;
+        size_t        capacity;
+        sVec<Event>   events;
+        uint64_t      recorded { 0 };
+
+        Ring (uint32_t thread_, size_t capacity_)
+            : thread (thread_)
+            , capacity (capacity_)
+        { }
+    };
+
+    /**
+     * Every ring made since tracing was last started. Only touched when
+     * a thread records its first span, and by [start] and [write]
+     */
+    struct Registry {
+        std::mutex          lock;
+        sVec<sPtr<Ring>>    rings;
+        size_t              capacity { amqp::internal::trace::Tracer::defaultCapacity };
+        uint64_t            generation { 0 };
+        uint32_t            threads { 0 };
+    };
+
+    Registry &
+    registry() {
+        static Registry registry; // NOLINT
+
+        return registry;
+    }
+
+    // read without the registry's lock by every span so kept apart from it
+    std::atomic<uint64_t> generation { 0 }; // NOLINT
+    std::atomic<int64_t> epoch { 0 }; // NOLINT
+
+    Ring &
+    ring() {
+        struct Local {
+            uint64_t generation { 0 };
+            sPtr<Ring> ring;
+        };
+
+        thread_local Local local; // NOLINT
+
+        auto current = generation.load (std::memory_order_acquire);
+
+        if (local.generation != current) {
+            auto & r = registry();
+            std::lock_guard<std::mutex> lock (r.lock);
+
+            local.ring = std::make_shared<Ring> (++r.threads, r.capacity);
+            local.generation = current;
+
+            r.rings.push_back (local.ring);
+        }
+
+        return *local.ring;
+    }
+
+    /**
+     * Chrome wants microseconds, fractions of them being fine
+     */
+    void
+    micros (std::ostream & out_, uint64_t ns_) {
+        out_ << ns_ / 1000 << '.';
+
+        auto frac = ns_ % 1000;
+        out_ << static_cast<char> ('0' + frac / 100)
+             << static_cast<char> ('0' + frac / 10 % 10)
+             << static_cast<char> ('0' + frac % 10);
+    }
+
+}
+
+/******************************************************************************
+ *
+ * amqp::internal::trace::Tracer
+ *
+ ******************************************************************************/
+
+std::atomic<bool>
+amqp::internal::trace::
+Tracer::m_enabled { false }; // NOLINT
+
+/******************************************************************************/
+
+void
+amqp::internal::trace::
+Tracer::start (size_t capacity_) {
+    auto & r = registry();
+
+    {
+        std::lock_guard<std::mutex> lock (r.lock);
+
+        r.rings.clear();
+        r.capacity = capacity_ ? capacity_ : 1;
+        r.threads = 0;
+
+        epoch.store (
+            clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+
+        // every thread starts a new ring when it next records
+        generation.store (++r.generation, std::memory_order_release);
+    }
+
+    m_enabled.store (true, std::memory_order_release);
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::trace::
+Tracer::stop() {
+    m_enabled.store (false, std::memory_order_release);
+}
+
+/******************************************************************************/
+
+uint64_t
+amqp::internal::trace::
+Tracer::now() {
+    auto ticks = clock::now().time_since_epoch().count()
+        - epoch.load (std::memory_order_relaxed);
+
+    return std::chrono::duration_cast<std::chrono::nanoseconds> (
+        clock::duration (ticks)).count();
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::trace::
+Tracer::record (
+    const char * name_,
+    const std::string * detail_,
+    uint64_t start_,
+    uint64_t end_
+) {
+    auto & r = ring();
+
+    if (r.events.size() < r.capacity) {
+        r.events.emplace_back();
+    }
+
+    auto & event = r.events[r.recorded++ % r.capacity];
+
+    event.name = name_;
+    event.hasDetail = detail_ != nullptr;
+    if (detail_) {
+        event.detail.assign (*detail_);
+    }
+    event.start = start_;
+    event.end = end_;
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::trace::
+Tracer::write (std::ostream & out_) {
+    auto & r = registry();
+    std::lock_guard<std::mutex> lock (r.lock);
+
+    auto pid = ::getpid();
+
+    std::string scratch;
+    bool first { true };
+
+    auto separate = [&] {
+        out_ << (first ? "\n" : ",\n");
+        first = false;
+    };
+
+    out_ << "{ \"displayTimeUnit\" : \"ns\", \"traceEvents\" : [";
+
+    for (const auto & ring : r.rings) {
+        separate();
+        out_ << "{ \"ph\" : \"M\", \"name\" : \"thread_name\", \"pid\" : " << pid
+             << ", \"tid\" : " << ring->thread
+             << ", \"args\" : { \"name\" : \"thread " << ring->thread << "\" } }";
+
+        auto count = std::min<uint64_t> (ring->recorded, ring->capacity);
+
+        // oldest first, which once we've wrapped is the next to be written
+        for (uint64_t i { ring->recorded - count } ; i < ring->recorded ; ++i) {
+            const auto & event = ring->events[i % ring->capacity];
+
+            scratch.clear();
+            json::appendQuoted (scratch, event.name, std::char_traits<char>::length (event.name));
+
+            separate();
+            out_ << "{ \"ph\" : \"X\", \"name\" : " << scratch
+                 << ", \"pid\" : " << pid
+                 << ", \"tid\" : " << ring->thread
+                 << ", \"ts\" : ";
+            micros (out_, event.start);
+            out_ << ", \"dur\" : ";
+            micros (out_, event.end - event.start);
+
+            if (event.hasDetail) {
+                scratch.clear();
+                json::appendQuoted (scratch, event.detail.data(), event.detail.size());
+                out_ << ", \"args\" : { \"type\" : " << scratch << " }";
+            }
+
+            out_ << " }";
+        }
+    }
+
+    out_ << "\n] }" << std::endl;
+}
+
+/******************************************************************************/
@@ -0,0 +1,102 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <iosfwd>
+#include <atomic>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+/******************************************************************************/
+
+namespace amqp::internal::trace {
+
+    /**
+     * Timeline tracing of where a decode spends its time, written out in
+     * Chrome's trace event format for chrome://tracing or Perfetto.
+     *
+     * Code marks the work it wants to see with a [Span] for the life of
+     * the work. Unlike DBG, which is fixed when we're built, tracing is
+     * switched on and off as we run. Whilst it's off a [Span] costs one
+     * relaxed load of a flag, no clock is read and nothing is written.
+     *
+     * Whilst it's on every thread buffers its own spans in a ring that
+     * grows as it's written to, up to a fixed size, so recording never
+     * takes a lock or allocates once the ring has wrapped, and a long run
+     * keeps its most recent spans rather than growing without bound. Rings outlive their threads, so spans from a
+     * pool that's since been torn down are still written.
+     *
+     * Nothing synchronises the rings with [write], so stop tracing, and
+     * let the threads being traced finish what they're doing, first.
+     */
+    class Tracer {
+        private :
+            static std::atomic<bool> m_enabled;
+
+        public :
+            /**
+             * The spans each thread keeps
+             */
+            static constexpr size_t defaultCapacity = 1 << 16;
+
+            static bool enabled() {
+                return m_enabled.load (std::memory_order_relaxed);
+            }
+
+            /**
+             * Start recording, throwing away anything recorded before
+             */
+            static void start (size_t capacity_ = defaultCapacity);
+
+            static void stop();
+
+            /**
+             * What's been recorded as a JSON trace, every span as a
+             * complete event on the thread that recorded it
+             */
+            static void write (std::ostream &);
+
+            /**
+             * Time since tracing started, in nanoseconds
+             */
+            static uint64_t now();
+
+            static void record (
+                const char * name_,
+                const std::string * detail_,
+                uint64_t start_,
+                uint64_t end_);
+    };
+
+    /**
+     * Records the time from its construction to its destruction as a
+     * span called [name_], which must be a literal, or at least outlive
+     * the trace being written. An optional [detail_], a type name say, is
+     * copied and shown as the span's argument.
+     */
+    class Span {
+        private :
+            const char * m_name;
+            const std::string * m_detail;
+            uint64_t m_start;
+
+        public :
+            explicit Span (const char * name_, const std::string * detail_ = nullptr)
+                : m_name (Tracer::enabled() ? name_ : nullptr)
+                , m_detail (detail_)
+                , m_start (m_name ? Tracer::now() : 0)
+            { }
+
+            Span (const Span &) = delete;
+
+            ~Span() {
+                if (m_name) {
+                    Tracer::record (m_name, m_detail, m_start, Tracer::now());
+                }
+            }
+    };
+
+}
+
+/******************************************************************************/